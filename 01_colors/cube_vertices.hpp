@@ -1,4 +1,6 @@
-static float fullCubeVertices[] = {
+#pragma once
+
+static const float fullCubeVertices[] = {
         // coordinates      
         -0.5f, -0.5f, -0.5f, 
          0.5f, -0.5f, -0.5f, 
@@ -0,0 +1,117 @@
+#include "scene.hpp"
+
+#include "utils/shader_library.hpp"
+
+#include "glad/glad.h"
+
+#include <glm/glm.hpp>
+#include <glm/gtc/matrix_transform.hpp>
+
+#include "cube_vertices.hpp"
+
+bool ColorsScene::init()
+{
+    // configure global opengl state
+    glEnable(GL_DEPTH_TEST);
+    // ==================================
+    // 1. Prepare data: Create objects 
+    std::string shaderPath = "shaders/" + name() + "-object";
+    ShaderLibrary shaders;
+    shaders.add(objectShader, shaderPath + ".vs", shaderPath + ".fs");
+
+    shaderPath = "shaders/" + name() + "-lighting";
+    shaders.add(lightingShader, shaderPath + ".vs", shaderPath + ".fs");
+    // both programs compile and link together
+    if (!shaders.build())
+        return false;
+
+    // ==================================
+    // 2. Set up objects
+    // prepare data and buffers
+
+    // *** MAIN CUBE DATA ***
+    glGenBuffers(1, &VBO); // vertex buffer object
+
+    glGenVertexArrays(1, &VAO); // vertex array object
+    glBindVertexArray(VAO);
+
+    glBindBuffer(GL_ARRAY_BUFFER, VBO);
+    glBufferData(GL_ARRAY_BUFFER, sizeof(fullCubeVertices), fullCubeVertices, GL_STATIC_DRAW);
+    
+    unsigned int byte_stride = 3 * sizeof(float);
+    // position attribute
+    glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, byte_stride, (void*)0);
+    glEnableVertexAttribArray(0);
+
+    // *** separate VAO for light cube ***
+    glGenVertexArrays(1, &lightVAO);
+    glBindVertexArray(lightVAO);
+    // we only need to bind to the VBO, the container's VBO's data already contains the data.
+    glBindBuffer(GL_ARRAY_BUFFER, VBO);
+    // set the vertex attribute
+    glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, byte_stride, (void*)0);
+    glEnableVertexAttribArray(0);
+
+    // profiling zones (--profile)
+    lightPassZone = profiler->zone("light pass", true);
+    objectPassZone = profiler->zone("object pass", true);
+    return true;
+}
+
+void ColorsScene::render()
+{
+    // clear the color buffer
+    glClearColor(0.1f, 0.1f, 0.1f, 1.0f);
+    glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+
+    // set up camera related props
+    glm::mat4 projection = glm::mat4(1.0f);
+    projection = glm::perspective(glm::radians(camera.Zoom), aspectRatio(), 0.1f, 100.0f);
+    glm::mat4 view = camera.GetViewMatrix();
+    glm::mat4 model;
+
+    // lighting object
+    model = glm::mat4(1.0f);
+    model = glm::translate(model, lightPos);
+    model = glm::scale(model, glm::vec3(0.2f));
+
+    {
+        ProfileZone zone(*profiler, lightPassZone);
+        lightingShader.use();
+        lightingShader.setMat4("projection", projection);
+        lightingShader.setMat4("view", view);
+        lightingShader.setMat4("model", model);
+        glBindVertexArray(lightVAO);
+        glDrawArrays(GL_TRIANGLES, 0, 36);
+    }
+
+    // real object
+    model = glm::mat4(1.0f);
+
+    {
+        ProfileZone zone(*profiler, objectPassZone);
+        objectShader.use();
+        objectShader.setMat4("projection", projection);
+        objectShader.setMat4("view", view);
+        objectShader.setMat4("model", model);
+
+        objectShader.setVec3("objectColor", 1.0f, 0.5f, 0.31f);
+        objectShader.setVec3("lightColor", lightColor);
+
+        glBindVertexArray(VAO);
+        glDrawArrays(GL_TRIANGLES, 0, 36);
+    }
+
+    // finish
+    glBindVertexArray(0);
+}
+
+void ColorsScene::destroy()
+{
+    glDeleteVertexArrays(1, &VAO);
+    glDeleteVertexArrays(1, &lightVAO);
+    glDeleteBuffers(1, &VBO);
+    VAO = lightVAO = VBO = 0;
+    objectShader.destroy();
+    lightingShader.destroy();
+}
@@ -0,0 +1,33 @@
+#pragma once
+
+#include "utils/scene.hpp"
+#include "utils/shader.hpp"
+
+//! @brief Lesson 1: lit cube and light source cube, flat colors
+class ColorsScene : public Scene
+{
+public:
+    std::string name() const override { return "01_colors"; }
+
+    void render() override;
+    void destroy() override;
+
+protected:
+    bool init() override;
+
+private:
+    Shader objectShader;
+    Shader lightingShader;
+
+    unsigned int VBO{0};
+    unsigned int VAO{0};
+    unsigned int lightVAO{0};
+
+    // lighting
+    glm::vec3 lightColor{1.0f, 1.0f, 1.0f};
+    glm::vec3 lightPos{1.2f, 1.0f, 2.0f};
+
+    // profiling zones
+    int lightPassZone{0};
+    int objectPassZone{0};
+};
@@ -0,0 +1,180 @@
+#include "scene.hpp"
+
+#include "utils/shader_library.hpp"
+
+#include "glad/glad.h"
+#include "GLFW/glfw3.h"
+
+#include <glm/glm.hpp>
+#include <glm/gtc/matrix_transform.hpp>
+
+#include "cube_vertices.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <iostream>
+
+bool BasicsScene::init()
+{
+    // configure global opengl state
+    glEnable(GL_DEPTH_TEST);
+    // ==================================
+    // 1. Prepare data: Create objects 
+    std::string shaderPath = "shaders/" + name() + "-object";
+    ShaderLibrary shaders;
+    shaders.add(objectShader, shaderPath + ".vs", shaderPath + ".fs");
+
+    shaderPath = "shaders/" + name() + "-lighting";
+    shaders.add(lightingShader, shaderPath + ".vs", shaderPath + ".fs");
+    // both programs compile and link together
+    if (!shaders.build())
+        return false;
+
+    // ==================================
+    // 2. Set up objects
+    // prepare data and buffers
+
+    // *** MAIN CUBE DATA ***
+    glGenBuffers(1, &VBO); // vertex buffer object
+
+    glGenVertexArrays(1, &VAO); // vertex array object
+    glBindVertexArray(VAO);
+
+    glBindBuffer(GL_ARRAY_BUFFER, VBO);
+    glBufferData(GL_ARRAY_BUFFER, sizeof(fullCubeVertices), fullCubeVertices, GL_STATIC_DRAW);
+    
+    unsigned int byte_stride = 6 * sizeof(float);
+    // position attribute
+    glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, byte_stride, (void*) (0 * sizeof(float)));
+    glEnableVertexAttribArray(0);
+    // normal attribute
+    glVertexAttribPointer(1, 3, GL_FLOAT, GL_FALSE, byte_stride, (void*)(3 * sizeof(float)));
+    glEnableVertexAttribArray(1);
+
+    // *** separate VAO for light cube ***
+    glGenVertexArrays(1, &lightVAO);
+    glBindVertexArray(lightVAO);
+    // we only need to bind to the VBO, the container's VBO's data already contains the data.
+    glBindBuffer(GL_ARRAY_BUFFER, VBO);
+    // set the vertex attribute
+    glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, byte_stride, (void*)(0 * sizeof(float)));
+    glEnableVertexAttribArray(0);
+
+    // profiling zones (--profile)
+    lightPassZone = profiler->zone("light pass", true);
+    objectPassZone = profiler->zone("object pass", true);
+    return true;
+}
+
+void BasicsScene::render()
+{
+    // clear the color buffer
+    glClearColor(0.1f, 0.1f, 0.1f, 1.0f);
+    glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+
+    // set up camera related props
+    glm::mat4 projection = glm::mat4(1.0f);
+    projection = glm::perspective(glm::radians(camera.Zoom), aspectRatio(), 0.1f, 100.0f);
+    glm::mat4 view = camera.GetViewMatrix();
+    glm::mat4 model;
+
+    // lighting object
+    // recalculate light object pos
+    currentAngle += degreesPerSecond * glm::radians(deltaTime);
+    lightPos.x = lighterRadius * sin(currentAngle);
+    lightPos.z = lighterRadius * cos(currentAngle);
+
+    model = glm::mat4(1.0f);
+    model = glm::translate(model, lightPos);
+    model = glm::scale(model, glm::vec3(0.2f));
+
+    {
+        ProfileZone zone(*profiler, lightPassZone);
+        lightingShader.use();
+        lightingShader.setMat4("projection", projection);
+        lightingShader.setMat4("view", view);
+        lightingShader.setMat4("model", model);
+        glBindVertexArray(lightVAO);
+        glDrawArrays(GL_TRIANGLES, 0, 36);
+    }
+    // ==================================
+    // real object
+
+    std::array cubePos = {
+        glm::vec3(1.0f, 0.0f, 1.0f),
+        glm::vec3(-1.0f, 0.0f, 1.0f),
+        glm::vec3(-1.0f, 0.0f, -1.0f),
+        glm::vec3(1.0f, 0.0f, -1.0f),
+    };
+
+    {
+        ProfileZone zone(*profiler, objectPassZone);
+        objectShader.use();
+        objectShader.setMat4("projection", projection);
+        objectShader.setMat4("view", view);
+
+        objectShader.setVec3("objectColor", 1.0f, 0.5f, 0.31f);
+        objectShader.setVec3("lightColor", lightColor);
+
+        objectShader.setVec3("lightPos", lightPos);
+
+        objectShader.setVec3("viewPos", camera.Position);
+
+        model = glm::mat4(1.0f);
+        for (auto const & pos : cubePos)
+        {
+            objectShader.setMat4("model", glm::translate(model, pos));
+
+            glBindVertexArray(VAO);
+            glDrawArrays(GL_TRIANGLES, 0, 36);
+        }
+    }
+
+    // finish
+    glBindVertexArray(0);
+}
+
+void BasicsScene::destroy()
+{
+    glDeleteVertexArrays(1, &VAO);
+    glDeleteVertexArrays(1, &lightVAO);
+    glDeleteBuffers(1, &VBO);
+    VAO = lightVAO = VBO = 0;
+    objectShader.destroy();
+    lightingShader.destroy();
+}
+
+std::vector<int> BasicsScene::heldKeys() const
+{
+    return {GLFW_KEY_COMMA, GLFW_KEY_PERIOD, GLFW_KEY_UP, GLFW_KEY_DOWN, GLFW_KEY_LEFT, GLFW_KEY_RIGHT};
+}
+
+void BasicsScene::onKeyHeld(int key, float dt)
+{
+    switch (key)
+    {
+        case GLFW_KEY_COMMA:
+            lightPos.y -= lighterSpeed * dt;
+            break;
+        case GLFW_KEY_PERIOD:
+            lightPos.y += lighterSpeed * dt;
+            break;
+        case GLFW_KEY_UP:
+            lighterRadius = std::min(lighterRadius + lighterSpeed * dt, 10.0f);
+            std::cout << "lighterRadius: " << lighterRadius << std::endl;
+            break;
+        case GLFW_KEY_DOWN:
+            lighterRadius = std::max(lighterRadius - lighterSpeed * dt, 0.5f);
+            std::cout << "lighterRadius: " << lighterRadius << std::endl;
+            break;
+        case GLFW_KEY_LEFT:
+            degreesPerSecond = std::max(degreesPerSecond - 36.0f * dt, 1.0f);
+            std::cout << "degreesPerSecond: " << degreesPerSecond << std::endl;
+            break;
+        case GLFW_KEY_RIGHT:
+            degreesPerSecond = std::min(degreesPerSecond + 36.0f * dt, 360.0f);
+            std::cout << "degreesPerSecond: " << degreesPerSecond << std::endl;
+            break;
+    }
+}
@@ -0,0 +1,42 @@
+#pragma once
+
+#include "utils/scene.hpp"
+#include "utils/shader.hpp"
+
+//! @brief Lesson 2: basic Phong lighting of four cubes, light source orbits around them
+class BasicsScene : public Scene
+{
+public:
+    std::string name() const override { return "02_basics"; }
+
+    void render() override;
+    void destroy() override;
+
+    // , . - light height, up/down - orbit radius, left/right - orbit speed
+    std::vector<int> heldKeys() const override;
+    void onKeyHeld(int key, float dt) override;
+
+protected:
+    bool init() override;
+
+private:
+    Shader objectShader;
+    Shader lightingShader;
+
+    unsigned int VBO{0};
+    unsigned int VAO{0};
+    unsigned int lightVAO{0};
+
+    // lighting
+    glm::vec3 lightColor{1.0f, 1.0f, 1.0f};
+    glm::vec3 lightPos{1.2f, 1.0f, 2.0f};
+
+    static constexpr auto lighterSpeed = 0.5f;
+    float lighterRadius{5.0f};
+    float degreesPerSecond{36.0f};
+    float currentAngle{0.0f};
+
+    // profiling zones
+    int lightPassZone{0};
+    int objectPassZone{0};
+};
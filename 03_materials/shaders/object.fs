@@ -17,15 +17,46 @@ struct Light {
 in vec3 Normal;
 in vec3 FragPos;
 
+// uniform blocks (are shared between programs and uploaded once per frame)
+layout (std140) uniform PerFrame
+{
+   mat4 projection;
+   mat4 view;
+   vec3 viewPos;
+};
+
 // uniform parameters (is set in main)
 uniform Material material;
 uniform Light light;
 
-uniform vec3 viewPos;
-
 // out parameter
 out vec4 FragColor;
 
+// specular model of the program (SPECULAR_MODEL define of the scene, Phong without it), utils/specular_model.hpp:
+// 0 - Phong, 1 - Blinn-Phong, 2 - Blinn-Phong with approximated pow
+#ifndef SPECULAR_MODEL
+#define SPECULAR_MODEL 0
+#endif
+
+float specularFactor(vec3 normal, vec3 lightDir, vec3 viewDir, float shininess)
+{
+#if SPECULAR_MODEL == 0
+   vec3 reflectDir = reflect(-lightDir, normal);
+   return pow(max(dot(viewDir, reflectDir), 0.0), shininess);
+#else
+   // angle to the half vector is about half of the reflection angle: 4x exponent keeps the highlight size
+   vec3 halfwayDir = normalize(lightDir + viewDir);
+   float x = max(dot(normal, halfwayDir), 0.0);
+   float n = 4.0 * shininess;
+#if SPECULAR_MODEL == 1
+   return pow(x, n);
+#else
+   // Schlick: pow(x, n) ~ x / (n - n * x + x), a division instead of exp2(n * log2(x))
+   return x / (n - n * x + x);
+#endif
+#endif
+}
+
 void main()
 {
    // ambient light part
@@ -39,8 +70,7 @@ void main()
 
    // specular light part
    vec3 viewDir = normalize(viewPos - FragPos);
-   vec3 reflectDir = reflect(-lightDir, norm);
-   float spec = pow(max(dot(viewDir, reflectDir), 0.0), material.shininess);
+   float spec = specularFactor(norm, lightDir, viewDir, material.shininess);
    vec3 specular = light.specular * (spec * material.specular);
 
    vec3 result = ambient + diffuse + specular;
@@ -1,4 +1,6 @@
-float fullCubeVertices[] = {
+#pragma once
+
+static const float fullCubeVertices[] = {
     // coordinates          // normal vectors       // texture coords
     // front
     -0.5f, -0.5f, -0.5f,    0.0f,  0.0f, -1.0f,     0.0f,  0.0f,
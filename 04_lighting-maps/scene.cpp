@@ -0,0 +1,272 @@
+#include "scene.hpp"
+
+#include "utils/shader_library.hpp"
+
+#include "glad/glad.h"
+#include "GLFW/glfw3.h"
+
+#include <glm/glm.hpp>
+#include <glm/gtc/matrix_transform.hpp>
+
+
+#include "cube_vertices.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <iostream>
+
+bool LightingMapsScene::parseArgument(int argc, char ** argv, int & i)
+{
+    return SpecularModel::parseArgument(argc, argv, i, specularModel);
+}
+
+bool LightingMapsScene::init()
+{
+    // configure global opengl state
+    glEnable(GL_DEPTH_TEST);
+    // ==================================
+    // 1. Prepare data: Create objects 
+    std::string shaderPath = "shaders/" + name() + "/object";
+    ShaderLibrary shaders;
+    // variant key is the specular model
+    objectShaders.create(shaderPath + ".vs", shaderPath + ".fs",
+                         [](ShaderVariants::Key key) { return SpecularModel::define(SpecularModel::Tier(key)); });
+    startSpecularModel = specularModel;
+    objectShaders.add(shaders, startSpecularModel);
+
+    shaderPath = "shaders/" + name() + "/lighting";
+    shaders.add(lightingShader, shaderPath + ".vs", shaderPath + ".fs");
+    // both programs compile and link together
+    if (!shaders.build())
+        return false;
+
+    // shared uniform blocks
+    perFrameBuffer = UniformBuffer<PerFrameBlock>(UniformBlockBinding::PER_FRAME);
+    objectShaders.bindUniformBlock("PerFrame", perFrameBuffer.getBindingPoint());
+    lightingShader.bindUniformBlock("PerFrame", perFrameBuffer.getBindingPoint());
+
+    // ==================================
+    // 2. Set up objects
+    // prepare data and buffers
+
+    // *** MAIN CUBE DATA ***
+    glGenBuffers(1, &VBO); // vertex buffer object
+
+    glGenVertexArrays(1, &VAO); // vertex array object
+    glBindVertexArray(VAO);
+
+    // load textures in background: first frames use placeholders (no specular, no emission)
+    std::string texturePath = "textures/"+ name() + "/container2.png";
+    diffuseMap = textures->load(texturePath);
+
+    texturePath = "textures/"+ name() + "/container2_specular.png";
+    specularMap = textures->load(texturePath, true, glm::vec4(0.0f, 0.0f, 0.0f, 1.0f));
+
+    texturePath = "textures/"+ name() + "/matrix.jpg";
+    emissionMap = textures->load(texturePath, true, glm::vec4(0.0f, 0.0f, 0.0f, 1.0f));
+
+    glBindBuffer(GL_ARRAY_BUFFER, VBO);
+    glBufferData(GL_ARRAY_BUFFER, sizeof(fullCubeVertices), fullCubeVertices, GL_STATIC_DRAW);
+    
+    unsigned int byte_stride = 8 * sizeof(float);
+    // position attribute
+    glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, byte_stride, (void*) (0 * sizeof(float)));
+    glEnableVertexAttribArray(0);
+    // normal attribute
+    glVertexAttribPointer(1, 3, GL_FLOAT, GL_FALSE, byte_stride, (void*)(3 * sizeof(float)));
+    glEnableVertexAttribArray(1);
+    // texture attribute
+    glVertexAttribPointer(2, 2, GL_FLOAT, GL_FALSE, byte_stride, (void*)(6 * sizeof(float)));
+    glEnableVertexAttribArray(2);
+
+    // *** separate VAO for light cube ***
+    glGenVertexArrays(1, &lightVAO);
+    glBindVertexArray(lightVAO);
+    // we only need to bind to the VBO, the container's VBO's data already contains the data.
+    glBindBuffer(GL_ARRAY_BUFFER, VBO);
+    // set the vertex attribute
+    glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, byte_stride, (void*)(0 * sizeof(float)));
+    glEnableVertexAttribArray(0);
+
+    // profiling zones (--profile)
+    uniformsZone = profiler->zone("uniforms");
+    lightPassZone = profiler->zone("light pass", true);
+    objectPassZone = profiler->zone("object pass", true);
+    return true;
+}
+
+void LightingMapsScene::render()
+{
+    // clear the color buffer
+    glClearColor(0.1f, 0.1f, 0.1f, 1.0f);
+    glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+
+    // set up camera related props
+    glm::mat4 projection = glm::mat4(1.0f);
+    projection = glm::perspective(glm::radians(camera.Zoom), aspectRatio(), 0.1f, 100.0f);
+    glm::mat4 view = camera.GetViewMatrix();
+    glm::mat4 model;
+
+    {
+        ProfileZone zone(*profiler, uniformsZone);
+        PerFrameBlock perFrame;
+        perFrame.projection = projection;
+        perFrame.view = view;
+        perFrame.viewPos = camera.Position;
+        perFrameBuffer.upload(perFrame);
+    }
+
+    // lighting object
+    // recalculate light object pos
+    currentAngle += degreesPerSecond * glm::radians(deltaTime);
+    lightPos.x = lighterRadius * sin(currentAngle);
+    lightPos.z = lighterRadius * cos(currentAngle);
+
+    model = glm::mat4(1.0f);
+    model = glm::translate(model, lightPos);
+    model = glm::scale(model, glm::vec3(0.2f));
+
+    {
+        ProfileZone zone(*profiler, lightPassZone);
+        lightingShader.use();
+        lightingShader.setMat4("model", model);
+
+        lightingShader.setVec3("color", lightColor);
+        glBindVertexArray(lightVAO);
+        glDrawArrays(GL_TRIANGLES, 0, 36);
+    }
+    // ==================================
+    // real object
+
+    std::array cubePos = {
+        glm::vec3(1.0f, 0.0f, 1.0f),
+        glm::vec3(-1.0f, 0.0f, 1.0f),
+        glm::vec3(-1.0f, 0.0f, -1.0f),
+        glm::vec3(1.0f, 0.0f, -1.0f),
+    };
+
+    {
+        ProfileZone zone(*profiler, objectPassZone);
+        Shader const & objectShader = objectShaders.select(specularModel, startSpecularModel);
+        objectShader.use();
+
+        objectShader.setInt("material.diffuse", 0);
+        objectShader.setInt("material.specular", 1);
+        objectShader.setInt("material.emission", 2);
+        objectShader.setFloat("material.shininess", 64.0f);
+
+        float shift = time / 2.0;
+        objectShader.setFloat("textShift", shift);
+
+        float glow = std::max(std::sin(time), 0.0f);
+        objectShader.setFloat("textGlow", glow);
+
+        glActiveTexture(GL_TEXTURE0);
+        glBindTexture(GL_TEXTURE_2D, diffuseMap.id());
+        glActiveTexture(GL_TEXTURE1);
+        glBindTexture(GL_TEXTURE_2D, specularMap.id());
+        glActiveTexture(GL_TEXTURE2);
+        glBindTexture(GL_TEXTURE_2D, emissionMap.id());
+
+        glm::vec3 ambientColor = lightColor * glm::vec3(0.2f);
+        glm::vec3 diffuseColor = lightColor * glm::vec3(0.5f);
+
+        objectShader.setVec3("light.position", lightPos);
+        objectShader.setVec3("light.ambient", ambientColor);
+        objectShader.setVec3("light.diffuse", diffuseColor);
+        objectShader.setVec3("light.specular", 1.0f, 1.0f, 1.0f);
+
+        model = glm::mat4(1.0f);
+
+        // logic for nice animation!
+        double startTime = 3.0;
+        double relativeTime = std::max(time - startTime, 0.0);
+        double turnsFor = 3.0;
+        int numOfRotation = int(floor(relativeTime / turnsFor));
+        int direction = (numOfRotation) % 3;
+        // end of logic for nice animation
+
+        for (size_t i = 0; i < cubePos.size(); i++)
+        {
+            auto pos = cubePos.at(i);
+            glm::mat4 curModel = glm::translate(model, pos);
+
+            glm::vec3 dir(0.0);
+            if (direction == 0) 
+            {
+                dir[direction] = - pos[2];
+            }
+            else if (direction == 2)
+            {
+                dir[direction] = pos[0];
+            }
+            else 
+            {
+                dir[direction] = - pos[0] * pos[2];
+            }
+
+            curModel = glm::rotate(curModel, glm::radians(float(relativeTime * 360.0 / turnsFor)), dir);
+            objectShader.setMat4("model", curModel);
+
+            glBindVertexArray(VAO);
+            glDrawArrays(GL_TRIANGLES, 0, 36);
+        }
+    }
+
+    // finish
+    glBindVertexArray(0);
+}
+
+void LightingMapsScene::destroy()
+{
+    glDeleteVertexArrays(1, &VAO);
+    glDeleteVertexArrays(1, &lightVAO);
+    glDeleteBuffers(1, &VBO);
+    diffuseMap.destroy();
+    specularMap.destroy();
+    emissionMap.destroy();
+    VAO = lightVAO = VBO = 0;
+    objectShaders.destroy();
+    lightingShader.destroy();
+    perFrameBuffer.destroy();
+}
+
+std::vector<int> LightingMapsScene::heldKeys() const
+{
+    return {GLFW_KEY_COMMA, GLFW_KEY_PERIOD, GLFW_KEY_UP, GLFW_KEY_DOWN, GLFW_KEY_LEFT, GLFW_KEY_RIGHT};
+}
+
+void LightingMapsScene::onKeyHeld(int key, float dt)
+{
+    switch (key)
+    {
+        case GLFW_KEY_COMMA:
+            lightPos.y -= lighterSpeed * dt;
+            break;
+        case GLFW_KEY_PERIOD:
+            lightPos.y += lighterSpeed * dt;
+            break;
+        case GLFW_KEY_UP:
+            lighterRadius = std::min(lighterRadius + lighterSpeed * dt, 10.0f);
+            break;
+        case GLFW_KEY_DOWN:
+            lighterRadius = std::max(lighterRadius - lighterSpeed * dt, 0.5f);
+            break;
+        case GLFW_KEY_LEFT:
+            degreesPerSecond = std::max(degreesPerSecond - 36.0f * dt, 1.0f);
+            break;
+        case GLFW_KEY_RIGHT:
+            degreesPerSecond = std::min(degreesPerSecond + 36.0f * dt, 360.0f);
+            break;
+    }
+}
+
+bool LightingMapsScene::onKeyPress(int key)
+{
+    if (key != GLFW_KEY_B)
+        return false;
+    specularModel = SpecularModel::next(specularModel);
+    std::cout << "Specular model: " << SpecularModel::name(specularModel) << std::endl;
+    return true;
+}
@@ -0,0 +1,62 @@
+#pragma once
+
+#include "utils/scene.hpp"
+#include "utils/shader.hpp"
+#include "utils/shader_variants.hpp"
+#include "utils/specular_model.hpp"
+#include "utils/uniform_blocks.hpp"
+#include "utils/uniform_buffer.hpp"
+
+//! @brief Lesson 4: diffuse, specular and emission maps on rotating cubes
+//! Object program is a variant (ShaderVariants) of the specular model: "--specular phong|blinn|fast", B cycles it.
+class LightingMapsScene : public Scene
+{
+public:
+    std::string name() const override { return "04_lighting-maps"; }
+    bool parseArgument(int argc, char ** argv, int & i) override;
+
+    void render() override;
+    void destroy() override;
+
+    // , . - light height, up/down - orbit radius, left/right - orbit speed
+    std::vector<int> heldKeys() const override;
+    void onKeyHeld(int key, float dt) override;
+    // B - specular model
+    bool onKeyPress(int key) override;
+
+protected:
+    bool init() override;
+
+private:
+    ShaderVariants objectShaders;
+    Shader lightingShader;
+    // shared uniform blocks
+    UniformBuffer<PerFrameBlock> perFrameBuffer;
+
+    unsigned int VBO{0};
+    unsigned int VAO{0};
+    unsigned int lightVAO{0};
+
+    // textures (placeholders until loaded)
+    TextureHandle diffuseMap;
+    TextureHandle specularMap;
+    TextureHandle emissionMap;
+
+    // lighting
+    glm::vec3 lightColor{1.0f, 1.0f, 1.0f};
+    glm::vec3 lightPos{1.2f, 1.0f, 2.0f};
+
+    static constexpr auto lighterSpeed = 0.5f;
+    float lighterRadius{5.0f};
+    float degreesPerSecond{36.0f};
+    float currentAngle{0.0f};
+
+    // specular model of object program (variant key); the one of start is drawn while another one is built
+    SpecularModel::Tier specularModel{SpecularModel::PHONG};
+    SpecularModel::Tier startSpecularModel{SpecularModel::PHONG};
+
+    // profiling zones
+    int uniformsZone{0};
+    int lightPassZone{0};
+    int objectPassZone{0};
+};
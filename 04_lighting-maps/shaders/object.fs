@@ -1,7 +1,7 @@
 #version 330 core
 struct Material {
    sampler2D diffuse;
-   sampler2D specular;
+   sampler2D specular;  // gray mask, red channel only (single channel texture)
    sampler2D emission;
    float shininess;
 };
@@ -18,10 +18,17 @@ in vec3 Normal;
 in vec3 FragPos;
 in vec2 TexCoords;
 
+// uniform blocks (are shared between programs and uploaded once per frame)
+layout (std140) uniform PerFrame
+{
+   mat4 projection;
+   mat4 view;
+   vec3 viewPos;
+};
+
 // uniform parameters (is set in main)
 uniform Material material;
 uniform Light light;
-uniform vec3 viewPos;
 
 uniform float textShift;
 uniform float textGlow;
@@ -29,27 +36,55 @@ uniform float textGlow;
 // out parameter
 out vec4 FragColor;
 
+// specular model of the program (SPECULAR_MODEL define of the scene, Phong without it), utils/specular_model.hpp:
+// 0 - Phong, 1 - Blinn-Phong, 2 - Blinn-Phong with approximated pow
+#ifndef SPECULAR_MODEL
+#define SPECULAR_MODEL 0
+#endif
+
+float specularFactor(vec3 normal, vec3 lightDir, vec3 viewDir, float shininess)
+{
+#if SPECULAR_MODEL == 0
+   vec3 reflectDir = reflect(-lightDir, normal);
+   return pow(max(dot(viewDir, reflectDir), 0.0), shininess);
+#else
+   // angle to the half vector is about half of the reflection angle: 4x exponent keeps the highlight size
+   vec3 halfwayDir = normalize(lightDir + viewDir);
+   float x = max(dot(normal, halfwayDir), 0.0);
+   float n = 4.0 * shininess;
+#if SPECULAR_MODEL == 1
+   return pow(x, n);
+#else
+   // Schlick: pow(x, n) ~ x / (n - n * x + x), a division instead of exp2(n * log2(x))
+   return x / (n - n * x + x);
+#endif
+#endif
+}
+
 void main()
 {
+   // material maps: one fetch per map, shared by all light parts
+   vec3 diffuseTexel = texture(material.diffuse, TexCoords).rgb;
+   float specularTexel = texture(material.specular, TexCoords).r;
+
    // ambient light part
-   vec3 ambient = light.ambient * vec3(texture(material.diffuse, TexCoords));
+   vec3 ambient = light.ambient * diffuseTexel;
    
    // diffuse light part
    vec3 norm = normalize(Normal);
    vec3 lightDir = normalize(light.position - FragPos);
    float diff = max(dot(norm, lightDir), 0.0);
 
-   vec3 diffuse = light.diffuse * diff * vec3(texture(material.diffuse, TexCoords));
+   vec3 diffuse = light.diffuse * diff * diffuseTexel;
 
    // specular light part
    vec3 viewDir = normalize(viewPos - FragPos);
-   vec3 reflectDir = reflect(-lightDir, norm);
-   float spec = pow(max(dot(viewDir, reflectDir), 0.0), material.shininess);
+   float spec = specularFactor(norm, lightDir, viewDir, material.shininess);
 
-   vec3 specular = light.specular * spec * vec3(texture(material.specular, TexCoords));
+   vec3 specular = light.specular * spec * vec3(specularTexel);
 
    vec3 emission = vec3(0.0);
-   if (texture(material.specular, TexCoords).r == 0.0)
+   if (specularTexel == 0.0)
    {
       emission = texture(material.emission, TexCoords + vec2(0.0, textShift)).rgb;
       emission = emission * textGlow;
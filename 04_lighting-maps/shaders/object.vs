@@ -4,9 +4,14 @@ layout (location = 0) in vec3 aPos;
 layout (location = 1) in vec3 aNormal;
 layout (location = 2) in vec2 aTexCoords;
 
+layout (std140) uniform PerFrame
+{
+   mat4 projection;
+   mat4 view;
+   vec3 viewPos;
+};
+
 uniform mat4 model;
-uniform mat4 view;
-uniform mat4 projection;
 
 out vec3 Normal;
 out vec3 FragPos;
@@ -0,0 +1,808 @@
+#include "scene.hpp"
+
+#include "utils/shader_library.hpp"
+
+#include "glad/glad.h"
+#include "GLFW/glfw3.h"
+
+#include <glm/glm.hpp>
+#include <glm/gtc/constants.hpp>
+#include <glm/gtc/matrix_transform.hpp>
+
+#include "cube_vertices.hpp"
+
+#include <algorithm>
+#include <cctype>
+#include <cmath>
+#include <cstdlib>
+#include <iostream>
+#include <random>
+
+namespace
+{
+    const std::array<glm::vec3, MultipleLightsScene::NR_POINT_LIGHTS> pointLightsPos = {
+        glm::vec3( 0.7f,  0.2f,  2.0f),
+        glm::vec3( 2.3f, -3.3f, -4.0f),
+        glm::vec3(-4.0f,  2.0f, -12.0f),
+        glm::vec3( 0.0f,  0.0f,  -3.0f),
+    };
+
+    // Model matrix of cube field entry: rotates around fixed axis, speed depends on index
+    glm::mat4 cubeModel(glm::vec3 const & pos, size_t index, float time)
+    {
+        glm::mat4 model = glm::mat4(1.0f); // !!! make sure to initialize matrix to identity matrix first
+        model = glm::translate(model, pos);
+        float angle = time * 20.0f * (index % 3 + 1);
+        return glm::rotate(model, glm::radians(angle), glm::vec3(1.0f, 0.3f, 0.5f));
+    }
+
+    // Stress mode: cubes randomly placed in front of the camera, same seed on every run
+    std::vector<glm::vec3> generateCubeField(size_t count)
+    {
+        // keep roughly 2 units between cube centers
+        float extent = 2.0f * std::cbrt(float(count));
+        std::mt19937 rng(42);
+        auto random = [&rng](float from, float to) {
+            return from + (to - from) * float(rng() - rng.min()) / float(rng.max() - rng.min());
+        };
+
+        std::vector<glm::vec3> field(count);
+        for (auto & pos : field)
+            pos = glm::vec3(random(-0.5f * extent, 0.5f * extent), random(-0.5f * extent, 0.5f * extent), random(-extent, -1.0f));
+        return field;
+    }
+
+    // layers of diffuseMaps: container2 (with specular map), container, wall
+    const std::array<MaterialData, MultipleLightsScene::NR_MATERIALS> materials = {
+        MaterialData{0, 0, 0.0f, 64.0f},
+        MaterialData{1, -1, 0.1f, 32.0f},
+        MaterialData{2, -1, 0.05f, 8.0f},
+    };
+
+    // bits of object variant key: point light count, spot light, emission, specular model, clustered, deferred, culled
+    const ShaderVariants::Key POINT_LIGHTS_MASK = 0x7;
+    const ShaderVariants::Key SPOT_LIGHT_BIT = 0x8;
+    const ShaderVariants::Key EMISSION_BIT = 0x10;
+    const ShaderVariants::Key SPECULAR_SHIFT = 5;
+    const ShaderVariants::Key SPECULAR_MASK = 0x3;
+    const ShaderVariants::Key CLUSTERED_BIT = 0x80;
+    const ShaderVariants::Key DEFERRED_BIT = 0x100;
+    const ShaderVariants::Key CULLED_BIT = 0x200;
+
+    // deferred mode: texture units of the G-buffer (material maps take 0-2, froxel or object light lists 3-5)
+    const GLuint GBUFFER_UNIT = 6;
+
+    // clustered mode: orbit size of the lights and size of their cubes
+    const float CLUSTER_ORBIT = 0.5f;
+    const float CLUSTER_CUBE_SCALE = 0.03f;
+
+    // attenuation of the lesson lights: 1 / (constant + linear * d + quadratic * d^2)
+    const float ATTENUATION_CONSTANT = 1.0f;
+    const float ATTENUATION_LINEAR = 0.09f;
+    const float ATTENUATION_QUADRATIC = 0.032f;
+
+    // projection planes (froxel depth slices span them)
+    const float NEAR_PLANE = 0.1f;
+    const float FAR_PLANE = 100.0f;
+}
+
+ShaderVariants::Key MultipleLightsScene::objectVariant(size_t pointLights, bool spotLight, bool emission,
+                                                      SpecularModel::Tier specular, bool clustered, bool culled,
+                                                      bool deferred)
+{
+    return ShaderVariants::Key(pointLights) | (spotLight ? SPOT_LIGHT_BIT : 0) | (emission ? EMISSION_BIT : 0)
+         | (ShaderVariants::Key(specular) << SPECULAR_SHIFT) | (clustered ? CLUSTERED_BIT : 0)
+         | (culled ? CULLED_BIT : 0) | (deferred ? DEFERRED_BIT : 0);
+}
+
+ShaderVariants::Key MultipleLightsScene::lightsVariant(bool all, bool emission, SpecularModel::Tier specular,
+                                                       bool deferred) const
+{
+    // clustered or culled lights replace the point lights of Lights block
+    bool clustered = clusteredLights > 0;
+    bool culled = culledLights > 0;
+    size_t pointLights = all ? NR_POINT_LIGHTS : size_t(std::count(lightState.begin(), lightState.end(), true));
+    return objectVariant(clustered || culled ? 0 : pointLights, all || flashlightOn, all || emission, specular,
+                         clustered, culled, deferred);
+}
+
+std::string MultipleLightsScene::objectDefines(ShaderVariants::Key key)
+{
+    return "#define POINT_LIGHT_COUNT " + std::to_string(key & POINT_LIGHTS_MASK)
+         + "\n#define SPOT_LIGHT " + ((key & SPOT_LIGHT_BIT) ? "1" : "0")
+         + "\n#define EMISSION " + ((key & EMISSION_BIT) ? "1" : "0") + "\n"
+         + SpecularModel::define(SpecularModel::Tier((key >> SPECULAR_SHIFT) & SPECULAR_MASK))
+         + "#define CLUSTERED " + ((key & CLUSTERED_BIT) ? "1" : "0")
+         + "\n#define CULLED " + ((key & CULLED_BIT) ? "1" : "0")
+         + "\n#define DEFERRED " + ((key & DEFERRED_BIT) ? "1" : "0") + "\n";
+}
+
+bool MultipleLightsScene::parseArgument(int argc, char ** argv, int & i)
+{
+    std::string arg = argv[i];
+    if (arg == "--stress")
+    {
+        stressCubes = STRESS_CUBES_DEFAULT;
+        if (i + 1 < argc && std::isdigit(static_cast<unsigned char>(argv[i + 1][0])))
+            stressCubes = std::strtoul(argv[++i], nullptr, 10);
+        return true;
+    }
+    if (arg == "--no-instancing")
+    {
+        instancingOn = false;
+        return true;
+    }
+    if (arg == "--no-variants")
+    {
+        variantsOn = false;
+        return true;
+    }
+    if (arg == "--deferred")
+    {
+        deferredOn = true;
+        return true;
+    }
+    if (arg == "--clustered")
+    {
+        clusteredLights = CLUSTERED_LIGHTS_DEFAULT;
+        if (i + 1 < argc && std::isdigit(static_cast<unsigned char>(argv[i + 1][0])))
+            clusteredLights = std::strtoul(argv[++i], nullptr, 10);
+        culledLights = 0;
+        return true;
+    }
+    if (arg == "--culled")
+    {
+        culledLights = CULLED_LIGHTS_DEFAULT;
+        if (i + 1 < argc && std::isdigit(static_cast<unsigned char>(argv[i + 1][0])))
+            culledLights = std::strtoul(argv[++i], nullptr, 10);
+        clusteredLights = 0;
+        return true;
+    }
+    return SpecularModel::parseArgument(argc, argv, i, specularModel);
+}
+
+bool MultipleLightsScene::init()
+{
+    // configure global opengl state
+    glEnable(GL_DEPTH_TEST);
+    // ==================================
+    // 1. Prepare data: Create objects 
+    // per-object light lists belong to the cubes, the lighting pass of deferred shading has no cubes
+    if (culledLights > 0 && deferredOn)
+    {
+        std::cout << "Deferred shading is off: culled lights are listed per cube" << std::endl;
+        deferredOn = false;
+    }
+    std::string shaderPath = "shaders/" + name() + "/object";
+    ShaderLibrary shaders;
+    // variant with all lights is drawn while the variant of new light set is built; the one of start state is built now
+    objectShaders.create(shaderPath + ".vs", shaderPath + ".fs", objectDefines);
+    startSpecularModel = specularModel;
+    objectShaders.add(shaders, lightsVariant(true, true, startSpecularModel, false));
+    if (variantsOn && !deferredOn)
+        objectShaders.add(shaders, lightsVariant(false, false, startSpecularModel, false));
+    // deferred shading: lighting pass is the object program on a full-screen triangle, M switches modes at runtime
+    deferredShaders.create("shaders/" + name() + "/deferred.vs", shaderPath + ".fs", objectDefines);
+    if (culledLights == 0)
+        deferredShaders.add(shaders, lightsVariant(true, true, startSpecularModel, true));
+    if (variantsOn && deferredOn)
+        deferredShaders.add(shaders, lightsVariant(false, false, startSpecularModel, true));
+    shaders.add(gbufferShader, shaderPath + ".vs", "shaders/" + name() + "/gbuffer.fs");
+
+    shaderPath = "shaders/" + name() + "/lighting";
+    shaders.add(lightingShader, shaderPath + ".vs", shaderPath + ".fs");
+    // all programs compile and link together
+    if (!shaders.build())
+        return false;
+
+    // shared uniform blocks
+    perFrameBuffer = UniformBuffer<PerFrameBlock>(UniformBlockBinding::PER_FRAME);
+    objectShaders.bindUniformBlock("PerFrame", perFrameBuffer.getBindingPoint());
+    deferredShaders.bindUniformBlock("PerFrame", perFrameBuffer.getBindingPoint());
+    gbufferShader.bindUniformBlock("PerFrame", perFrameBuffer.getBindingPoint());
+    lightingShader.bindUniformBlock("PerFrame", perFrameBuffer.getBindingPoint());
+    lightsBuffer = UniformBuffer<LightsBlock<NR_POINT_LIGHTS>>(UniformBlockBinding::LIGHTS);
+    objectShaders.bindUniformBlock("Lights", lightsBuffer.getBindingPoint());
+    deferredShaders.bindUniformBlock("Lights", lightsBuffer.getBindingPoint());
+    // materials do not change: uploaded once
+    materialsBuffer = UniformBuffer<MaterialsBlock<NR_MATERIALS>>(UniformBlockBinding::MATERIALS);
+    objectShaders.bindUniformBlock("Materials", materialsBuffer.getBindingPoint());
+    deferredShaders.bindUniformBlock("Materials", materialsBuffer.getBindingPoint());
+    gbufferShader.bindUniformBlock("Materials", materialsBuffer.getBindingPoint());
+    MaterialsBlock<NR_MATERIALS> materialsBlock;
+    std::copy(materials.begin(), materials.end(), materialsBlock.materials);
+    materialsBuffer.upload(materialsBlock);
+
+    // ==================================
+    // 2. Set up objects
+    // prepare data and buffers
+
+    // *** MAIN CUBE DATA ***
+    glGenBuffers(1, &VBO); // vertex buffer object
+
+    glGenVertexArrays(1, &VAO); // vertex array object
+    glBindVertexArray(VAO);
+
+    // load textures in background: first frames use placeholders (no specular, no emission)
+    std::string texturePath = "textures/"+ name() + "/";
+    diffuseMaps = textures->loadArray({texturePath + "container2.png", texturePath + "container.jpg",
+                                       texturePath + "wall.jpg"});
+    specularMaps = textures->loadArray({texturePath + "container2_specular.png"}, true,
+                                       glm::vec4(0.0f, 0.0f, 0.0f, 1.0f));
+
+    texturePath = "textures/"+ name() + "/matrix.jpg";
+    emissionMap = textures->load(texturePath, true, glm::vec4(0.0f, 0.0f, 0.0f, 1.0f));
+
+    glBindBuffer(GL_ARRAY_BUFFER, VBO);
+    glBufferData(GL_ARRAY_BUFFER, sizeof(fullCubeVertices), fullCubeVertices, GL_STATIC_DRAW);
+    
+    unsigned int byte_stride = 8 * sizeof(float);
+    // position attribute
+    glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, byte_stride, (void*) (0 * sizeof(float)));
+    glEnableVertexAttribArray(0);
+    // normal attribute
+    glVertexAttribPointer(1, 3, GL_FLOAT, GL_FALSE, byte_stride, (void*)(3 * sizeof(float)));
+    glEnableVertexAttribArray(1);
+    // texture attribute
+    glVertexAttribPointer(2, 2, GL_FLOAT, GL_FALSE, byte_stride, (void*)(6 * sizeof(float)));
+    glEnableVertexAttribArray(2);
+    // per-instance model matrices
+    cubeInstanceBuffer.attach();
+    // per-instance material ID (integer attribute)
+    glGenBuffers(1, &materialVBO);
+    glBindBuffer(GL_ARRAY_BUFFER, materialVBO);
+    glVertexAttribIPointer(InstanceAttrib::MATERIAL, 1, GL_UNSIGNED_INT, sizeof(unsigned int), (void*)0);
+    glEnableVertexAttribArray(InstanceAttrib::MATERIAL);
+    glVertexAttribDivisor(InstanceAttrib::MATERIAL, 1);
+    // per-instance light list (culled mode)
+    if (culledLights > 0)
+    {
+        lightCulling.create();
+        lightCulling.attach();
+    }
+
+    // *** VAO for single draws: same vertices, model matrix is set per draw ***
+    glGenVertexArrays(1, &singleVAO);
+    glBindVertexArray(singleVAO);
+    glBindBuffer(GL_ARRAY_BUFFER, VBO);
+    glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, byte_stride, (void*)(0 * sizeof(float)));
+    glEnableVertexAttribArray(0);
+    glVertexAttribPointer(1, 3, GL_FLOAT, GL_FALSE, byte_stride, (void*)(3 * sizeof(float)));
+    glEnableVertexAttribArray(1);
+    glVertexAttribPointer(2, 2, GL_FLOAT, GL_FALSE, byte_stride, (void*)(6 * sizeof(float)));
+    glEnableVertexAttribArray(2);
+
+    // *** separate VAO for light cube ***
+    glGenVertexArrays(1, &lightVAO);
+    glBindVertexArray(lightVAO);
+    // we only need to bind to the VBO, the container's VBO's data already contains the data.
+    glBindBuffer(GL_ARRAY_BUFFER, VBO);
+    // set the vertex attribute
+    glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, byte_stride, (void*)(0 * sizeof(float)));
+    glEnableVertexAttribArray(0);
+    lightInstanceBuffer.attach();
+
+    glGenVertexArrays(1, &singleLightVAO);
+    glBindVertexArray(singleLightVAO);
+    glBindBuffer(GL_ARRAY_BUFFER, VBO);
+    glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, byte_stride, (void*)(0 * sizeof(float)));
+    glEnableVertexAttribArray(0);
+
+    glGenVertexArrays(1, &fullscreenVAO);
+
+    cubePos = {
+        glm::vec3( 0.0f,  0.0f,  0.0f),
+        glm::vec3( 2.0f,  5.0f, -15.0f),
+        glm::vec3(-1.5f, -2.2f, -2.5f),
+        glm::vec3(-3.8f, -2.0f, -12.5f),
+        glm::vec3( 2.4f, -0.4f, -3.5f),
+        glm::vec3(-1.7f,  3.0f, -7.5f),
+        glm::vec3( 1.3f, -2.0f, -2.5f),
+        glm::vec3( 1.5f,  2.0f, -2.5f),
+        glm::vec3( 1.5f,  0.2f, -1.5f),
+        glm::vec3(-1.3f,  1.0f, -1.5f),
+    };
+
+    if (stressCubes > 0)
+        cubePos = generateCubeField(stressCubes);
+
+    cubeInstances.resize(cubePos.size());
+    cubeBoxes.resize(cubePos.size());
+    cubeMaterials.resize(cubePos.size());
+    for (size_t i = 0; i < cubeMaterials.size(); ++i)
+        cubeMaterials[i] = static_cast<unsigned int>(i % NR_MATERIALS);
+    glBindBuffer(GL_ARRAY_BUFFER, materialVBO);
+    glBufferData(GL_ARRAY_BUFFER, GLsizeiptr(cubeMaterials.size() * sizeof(unsigned int)), cubeMaterials.data(),
+                 GL_STATIC_DRAW);
+    lightInstances.reserve(NR_POINT_LIGHTS);
+
+    if (clusteredLights > 0)
+    {
+        generateClusterLights(clusteredLights, CLUSTERED_LIGHT_OVERLAP);
+        lightClusters.create();
+        std::cout << "Clustered lights: " << clusterLights.size() << " (radius " << clusterLights[0].radius << "), froxels "
+                  << LightClusters::TILES_X << "x" << LightClusters::TILES_Y << "x" << LightClusters::SLICES << ", "
+                  << lightClusters.threadCount() << " worker threads" << std::endl;
+    }
+    if (culledLights > 0)
+    {
+        generateClusterLights(culledLights, CULLED_LIGHT_OVERLAP);
+        attenuateCulledLights();
+        auto range = std::minmax_element(clusterLights.begin(), clusterLights.end(),
+            [](LightClusters::Light const & a, LightClusters::Light const & b) { return a.radius < b.radius; });
+        std::cout << "Culled lights: " << clusterLights.size() << " (radius " << range.first->radius << "-"
+                  << range.second->radius << " at luminance " << CULLED_LUMINANCE_THRESHOLD << ")" << std::endl;
+    }
+
+    std::cout << "Cubes: " << cubePos.size() << ", instancing " << (instancingOn ? "on" : "off")
+              << ", shader variants " << (variantsOn ? "on" : "off") << ", specular " << SpecularModel::name(specularModel)
+              << ", deferred shading " << (deferredOn ? "on" : "off") << " (G-buffer " << GBuffer::BYTES_PER_PIXEL
+              << " bytes per pixel)" << std::endl;
+
+    // profiling zones (--profile)
+    uniformsZone = profiler->zone("uniforms");
+    clustersZone = profiler->zone("light clusters");
+    cullingZone = profiler->zone("light culling");
+    lightPassZone = profiler->zone("light pass", true);
+    objectPassZone = profiler->zone("object pass", true);
+    geometryPassZone = profiler->zone("geometry pass", true);
+    lightingPassZone = profiler->zone("lighting pass", true);
+    return true;
+}
+
+void MultipleLightsScene::render()
+{
+    // clear the color buffer
+    glClearColor(0.1f, 0.1f, 0.1f, 1.0f);
+    glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+
+    // set up camera related props
+    glm::mat4 projection = glm::mat4(1.0f);
+    projection = glm::perspective(glm::radians(camera.Zoom), aspectRatio(), NEAR_PLANE, FAR_PLANE);
+    glm::mat4 view = camera.GetViewMatrix();
+
+    // emission feature
+    float glow = 0.0f;
+    if (time < glowStart + glowDuration * 1.2f)
+    {
+        glow = std::max(1.0f - (time - glowStart) / glowDuration, 0.0f);
+    }
+
+    // clustered mode: lights move, then they are assigned to the froxels of this view
+    if (clusteredLights > 0)
+    {
+        ProfileZone zone(*profiler, clustersZone);
+        animateClusterLights();
+        lightClusters.update(LightClusters::View{view, glm::radians(camera.Zoom), aspectRatio(), NEAR_PLANE, FAR_PLANE,
+                                                 width, height}, clusterLights);
+    }
+
+    // cubes of this frame, then in culled mode lights move and each cube gets the lights that reach its box
+    updateCubes();
+    if (culledLights > 0)
+    {
+        ProfileZone zone(*profiler, cullingZone);
+        animateClusterLights();
+        lightCulling.update(clusterLights, cubeBoxes);
+    }
+
+    {
+        ProfileZone zone(*profiler, uniformsZone);
+        PerFrameBlock perFrame;
+        perFrame.projection = projection;
+        perFrame.view = view;
+        perFrame.viewPos = camera.Position;
+        perFrameBuffer.upload(perFrame);
+
+        // lights (whole Lights block is uploaded at once)
+        glm::vec3 ambientColor = lightColor * glm::vec3(0.2f);
+        glm::vec3 diffuseColor = lightColor * glm::vec3(0.5f);
+
+        float amplitude = std::max(std::abs(std::cos(glm::radians(time * 10))), 0.1f);
+
+        LightsBlock<NR_POINT_LIGHTS> lights;
+        lights.dirLight.direction = glm::vec3(-0.2f, -1.0f, -0.3f);
+        lights.dirLight.ambient = ambientColor * amplitude;
+        lights.dirLight.diffuse = diffuseColor * amplitude;
+        lights.dirLight.specular = glm::vec3(1.0f, 1.0f, 1.0f) * amplitude;
+
+        // lights that are on come first: object variant loops over them only (all-lights variant: zero color of the rest)
+        size_t slot = 0;
+        for (bool on : {true, false})
+        {
+            for (size_t i = 0; i < NR_POINT_LIGHTS; ++i)
+            {
+                if (lightState[i] != on)
+                    continue;
+                PointLightData & pointLight = lights.pointLights[slot++];
+
+                pointLight.position = pointLightsPos[i];
+
+                pointLight.constant = ATTENUATION_CONSTANT;
+                pointLight.linear = ATTENUATION_LINEAR;
+                pointLight.quadratic = ATTENUATION_QUADRATIC;
+
+                if (on)
+                {
+                    pointLight.ambient = ambientColor;
+                    pointLight.diffuse = diffuseColor;
+                    pointLight.specular = glm::vec3(1.0f, 1.0f, 1.0f);
+                }
+                else
+                {
+                    pointLight.ambient = glm::vec3(0.0f);
+                    pointLight.diffuse = glm::vec3(0.0f);
+                    pointLight.specular = glm::vec3(0.0f);
+                }
+            }
+        }
+
+        SpotLightData & spotLight = lights.spotLight;
+        spotLight.position = camera.Position;
+        spotLight.direction = camera.Front;
+        spotLight.cutOff = glm::cos(glm::radians(12.5f));
+        spotLight.outerCutOff = glm::cos(glm::radians(18.0f));
+
+        spotLight.constant = ATTENUATION_CONSTANT;
+        spotLight.linear = ATTENUATION_LINEAR;
+        spotLight.quadratic = ATTENUATION_QUADRATIC;
+
+        if (flashlightOn)
+        {
+            spotLight.ambient = glm::vec3(0.1f);
+            spotLight.diffuse = glm::vec3(1.0f);
+            spotLight.specular = glm::vec3(1.0f, 1.0f, 1.0f);
+        }
+        else 
+        {
+            spotLight.ambient = glm::vec3(0.0f);
+            spotLight.diffuse = glm::vec3(0.0f);
+            spotLight.specular = glm::vec3(0.0f);
+        }
+        lightsBuffer.upload(lights);
+    }
+
+    // deferred mode draws light cubes after the lighting pass (it writes depth of the G-buffer)
+    if (deferredOn)
+    {
+        renderDeferred(projection, view, glow);
+    }
+    else
+    {
+        drawLightCubes();
+        renderForward(glow);
+    }
+
+    // finish
+    glBindVertexArray(0);
+}
+
+void MultipleLightsScene::drawLightCubes()
+{
+    ProfileZone zone(*profiler, lightPassZone);
+    lightingShader.use();
+    lightingShader.setVec3("color", lightColor);
+
+    glm::mat4 model;
+    lightInstances.clear();
+    for (size_t indx = 0; indx < pointLightsPos.size() && clusterLights.empty(); ++indx)
+    {
+        if (lightState.at(indx) == false)
+            continue;
+        model = glm::mat4(1.0f);
+        model = glm::translate(model, pointLightsPos.at(indx));
+        model = glm::scale(model, glm::vec3(0.1f));
+
+        lightInstances.push_back(makeInstance(model));
+    }
+    for (LightClusters::Light const & light : clusterLights)
+    {
+        model = glm::translate(glm::mat4(1.0f), light.position);
+        lightInstances.push_back(makeInstance(glm::scale(model, glm::vec3(CLUSTER_CUBE_SCALE))));
+    }
+
+    if (instancingOn)
+    {
+        lightInstanceBuffer.upload(lightInstances);
+        glBindVertexArray(lightVAO);
+        glDrawArraysInstanced(GL_TRIANGLES, 0, 36, lightInstanceBuffer.size());
+    }
+    else
+    {
+        glBindVertexArray(singleLightVAO);
+        for (auto const & instance : lightInstances)
+        {
+            InstanceBuffer::setCurrent(instance);
+            glDrawArrays(GL_TRIANGLES, 0, 36);
+        }
+    }
+}
+
+void MultipleLightsScene::bindMaterialMaps(Shader const & shader, float glow)
+{
+    // material maps (the rest of materials is in Materials block)
+    shader.setInt("diffuseMaps", 0);
+    shader.setInt("specularMaps", 1);
+    shader.setInt("emissionMap", 2);
+
+    // emission feature
+    float shift = time / glowDuration;
+    shader.setFloat("textShift", shift);
+    shader.setFloat("textGlow", glow);
+
+    // same binds for every material
+    glActiveTexture(GL_TEXTURE0);
+    glBindTexture(GL_TEXTURE_2D_ARRAY, diffuseMaps.id());
+    glActiveTexture(GL_TEXTURE1);
+    glBindTexture(GL_TEXTURE_2D_ARRAY, specularMaps.id());
+    glActiveTexture(GL_TEXTURE2);
+    glBindTexture(GL_TEXTURE_2D, emissionMap.id());
+}
+
+void MultipleLightsScene::updateCubes()
+{
+    for (size_t i = 0; i < cubePos.size(); i++)
+        cubeInstances[i] = makeInstance(cubeModel(cubePos[i], i, time));
+    if (culledLights == 0)
+        return;
+
+    // box of the rotated unit cube: half size along each axis is half of the absolute row sum of the rotation
+    for (size_t i = 0; i < cubePos.size(); i++)
+    {
+        glm::mat4 const & model = cubeInstances[i].model;
+        glm::vec3 center(model[3]);
+        glm::vec3 half = 0.5f * (glm::abs(glm::vec3(model[0])) + glm::abs(glm::vec3(model[1])) + glm::abs(glm::vec3(model[2])));
+        cubeBoxes[i] = LightCulling::Box{center - half, center + half};
+    }
+}
+
+void MultipleLightsScene::drawCubes()
+{
+    if (instancingOn)
+    {
+        cubeInstanceBuffer.upload(cubeInstances);
+
+        glBindVertexArray(VAO);
+        glDrawArraysInstanced(GL_TRIANGLES, 0, 36, cubeInstanceBuffer.size());
+    }
+    else
+    {
+        glBindVertexArray(singleVAO);
+        for (size_t i = 0; i < cubePos.size(); i++)
+        {
+            // model matrix of each object is passed to shader before drawing
+            InstanceBuffer::setCurrent(cubeInstances[i]);
+            glVertexAttribI1ui(InstanceAttrib::MATERIAL, cubeMaterials[i]);
+            if (culledLights > 0)
+            {
+                glm::uvec2 const & list = lightCulling.lists()[i];
+                glVertexAttribI2ui(InstanceAttrib::LIGHT_LIST, list.x, list.y);
+            }
+
+            // now render the triangles
+            glDrawArrays(GL_TRIANGLES, 0, 36);
+        }
+    }
+}
+
+void MultipleLightsScene::renderForward(float glow)
+{
+    ProfileZone zone(*profiler, objectPassZone);
+    // program without the lights that are off (all-lights program of start specular model until it is built)
+    ShaderVariants::Key variant = lightsVariant(!variantsOn, glow > 0.0f, specularModel, false);
+    ShaderVariants::Key fallback = lightsVariant(true, true, startSpecularModel, false);
+    Shader const & objectShader = objectShaders.select(variant, fallback);
+    objectShader.use();
+
+    bindMaterialMaps(objectShader, glow);
+    // light lists of the froxels (texture units 3-5) or of the cubes (3-4)
+    if (clusteredLights > 0)
+        lightClusters.bind(objectShader, 3);
+    if (culledLights > 0)
+        lightCulling.bind(objectShader, 3);
+
+    drawCubes();
+}
+
+void MultipleLightsScene::renderDeferred(glm::mat4 const & projection, glm::mat4 const & view, float glow)
+{
+    // lit pixels go to the framebuffer of the frame (window or offscreen target)
+    GLint target = 0;
+    glGetIntegerv(GL_DRAW_FRAMEBUFFER_BINDING, &target);
+    if (gBuffer.getWidth() != width || gBuffer.getHeight() != height)
+    {
+        gBuffer.destroy();
+        if (!gBuffer.create(width, height))
+        {
+            gBuffer.destroy();
+            glBindFramebuffer(GL_FRAMEBUFFER, GLuint(target));
+            deferredOn = false;
+            std::cout << "Deferred shading turns off!" << std::endl;
+            drawLightCubes();
+            renderForward(glow);
+            return;
+        }
+    }
+
+    // geometry pass: nearest fragment of every pixel, material maps are sampled once per pixel that is written
+    {
+        ProfileZone zone(*profiler, geometryPassZone);
+        gBuffer.bindGeometry();
+        gbufferShader.use();
+        bindMaterialMaps(gbufferShader, glow);
+        drawCubes();
+    }
+
+    // lighting pass: every lit pixel once, same lights and variants as the object pass
+    {
+        ProfileZone zone(*profiler, lightingPassZone);
+        glBindFramebuffer(GL_FRAMEBUFFER, GLuint(target));
+        glViewport(0, 0, width, height);
+
+        ShaderVariants::Key variant = lightsVariant(!variantsOn, glow > 0.0f, specularModel, true);
+        ShaderVariants::Key fallback = lightsVariant(true, true, startSpecularModel, true);
+        Shader const & lightingPass = deferredShaders.select(variant, fallback);
+        lightingPass.use();
+
+        lightingPass.setInt("gAlbedoSpecular", int(GBUFFER_UNIT + GBuffer::ALBEDO_SPECULAR));
+        lightingPass.setInt("gNormalMaterial", int(GBUFFER_UNIT + GBuffer::NORMAL_MATERIAL));
+        lightingPass.setInt("gEmission", int(GBUFFER_UNIT + GBuffer::EMISSION));
+        lightingPass.setInt("gDepth", int(GBUFFER_UNIT + GBuffer::COUNT));
+        lightingPass.setMat4("inverseViewProjection", glm::inverse(projection * view));
+        gBuffer.bindTextures(GBUFFER_UNIT);
+        // light lists of the froxels (texture units 3-5): tile and depth slice of the pixel
+        if (clusteredLights > 0)
+            lightClusters.bind(lightingPass, 3);
+
+        // depth of the G-buffer replaces the cleared one (pixels without fragment are discarded)
+        glDepthFunc(GL_ALWAYS);
+        glBindVertexArray(fullscreenVAO);
+        glDrawArrays(GL_TRIANGLES, 0, 3);
+        glDepthFunc(GL_LESS);
+    }
+
+    drawLightCubes();
+}
+
+void MultipleLightsScene::destroy()
+{
+    glDeleteVertexArrays(1, &VAO);
+    glDeleteVertexArrays(1, &singleVAO);
+    glDeleteVertexArrays(1, &lightVAO);
+    glDeleteVertexArrays(1, &singleLightVAO);
+    glDeleteVertexArrays(1, &fullscreenVAO);
+    glDeleteBuffers(1, &VBO);
+    glDeleteBuffers(1, &materialVBO);
+    VAO = singleVAO = lightVAO = singleLightVAO = fullscreenVAO = VBO = materialVBO = 0;
+    diffuseMaps.destroy();
+    specularMaps.destroy();
+    emissionMap.destroy();
+    cubeInstanceBuffer.destroy();
+    lightInstanceBuffer.destroy();
+    perFrameBuffer.destroy();
+    lightsBuffer.destroy();
+    materialsBuffer.destroy();
+    objectShaders.destroy();
+    deferredShaders.destroy();
+    gbufferShader.destroy();
+    lightingShader.destroy();
+    lightClusters.destroy();
+    lightCulling.destroy();
+    gBuffer.destroy();
+}
+
+void MultipleLightsScene::generateClusterLights(size_t count, float overlap)
+{
+    // box around the cube field
+    glm::vec3 low = cubePos[0];
+    glm::vec3 high = cubePos[0];
+    for (glm::vec3 const & pos : cubePos)
+    {
+        low = glm::min(low, pos);
+        high = glm::max(high, pos);
+    }
+    low -= glm::vec3(1.0f);
+    high += glm::vec3(1.0f);
+
+    // radius of the light spheres: about overlap of them cover a point of the box
+    glm::vec3 size = high - low;
+    float volume = size.x * size.y * size.z;
+    float radius = std::cbrt(3.0f * overlap * volume / (4.0f * glm::pi<float>() * float(count)));
+    radius = std::clamp(radius, 0.25f, 5.0f);
+
+    std::mt19937 rng(7);
+    auto random = [&rng](float from, float to) {
+        return from + (to - from) * float(rng() - rng.min()) / float(rng.max() - rng.min());
+    };
+    clusterLights.resize(count);
+    clusterOrbits.resize(count);
+    for (size_t i = 0; i < count; ++i)
+    {
+        clusterOrbits[i] = glm::vec4(random(low.x, high.x), random(low.y, high.y), random(low.z, high.z),
+                                     random(0.0f, 2.0f * glm::pi<float>()));
+        clusterLights[i].position = glm::vec3(clusterOrbits[i]);
+        clusterLights[i].radius = radius;
+        // saturated colors, overlapping lights add up to about white
+        clusterLights[i].color = glm::vec3(random(0.1f, 1.0f), random(0.1f, 1.0f), random(0.1f, 1.0f)) * 0.5f;
+    }
+}
+
+void MultipleLightsScene::attenuateCulledLights()
+{
+    auto luminance = [](glm::vec3 const & color) { return glm::dot(color, glm::vec3(0.2126f, 0.7152f, 0.0722f)); };
+    std::mt19937 rng(11);
+    auto random = [&rng](float from, float to) {
+        return from + (to - from) * float(rng() - rng.min()) / float(rng.max() - rng.min());
+    };
+    for (LightClusters::Light & light : clusterLights)
+    {
+        // intensity that fades to the threshold at 50-100% of the radius of the light density
+        float r = random(0.5f, 1.0f) * light.radius;
+        float peak = CULLED_LUMINANCE_THRESHOLD * (ATTENUATION_CONSTANT + ATTENUATION_LINEAR * r + ATTENUATION_QUADRATIC * r * r);
+        light.color *= peak / luminance(light.color);
+        light.radius = LightCulling::effectiveRadius(ATTENUATION_CONSTANT, ATTENUATION_LINEAR, ATTENUATION_QUADRATIC,
+                                                     luminance(light.color), CULLED_LUMINANCE_THRESHOLD);
+    }
+}
+
+void MultipleLightsScene::animateClusterLights()
+{
+    for (size_t i = 0; i < clusterLights.size(); ++i)
+    {
+        glm::vec4 const & orbit = clusterOrbits[i];
+        float angle = time + orbit.w;
+        clusterLights[i].position = glm::vec3(orbit) + CLUSTER_ORBIT * glm::vec3(std::sin(angle), std::cos(1.3f * angle), std::cos(angle));
+    }
+}
+
+std::vector<int> MultipleLightsScene::heldKeys() const
+{
+    return {GLFW_KEY_G};
+}
+
+void MultipleLightsScene::onKeyHeld(int key, float /*dt*/)
+{
+    // emission feature: glow restarts while key is held
+    if (key == GLFW_KEY_G)
+        glowStart = time;
+}
+
+bool MultipleLightsScene::onKeyPress(int key)
+{
+    switch (key)
+    {
+        case GLFW_KEY_F:
+            flashlightOn = !flashlightOn;
+            std::cout << "Flash light turns " << (flashlightOn ? "on" : "off") << "!" << std::endl;
+            return true;
+        case GLFW_KEY_B:
+            specularModel = SpecularModel::next(specularModel);
+            std::cout << "Specular model: " << SpecularModel::name(specularModel) << std::endl;
+            return true;
+        case GLFW_KEY_M:
+            if (culledLights > 0)
+            {
+                std::cout << "Deferred shading is off: culled lights are listed per cube" << std::endl;
+                return true;
+            }
+            deferredOn = !deferredOn;
+            std::cout << "Deferred shading turns " << (deferredOn ? "on" : "off") << "!" << std::endl;
+            return true;
+        case GLFW_KEY_I:
+            instancingOn = !instancingOn;
+            std::cout << "Instancing turns " << (instancingOn ? "on" : "off") << "!" << std::endl;
+            return true;
+        case GLFW_KEY_1:
+        case GLFW_KEY_2:
+        case GLFW_KEY_3:
+        case GLFW_KEY_4:
+        {
+            size_t indx = size_t(key - GLFW_KEY_1);
+            auto & state = lightState.at(indx);
+            state = !state;
+            std::cout << "Point light " << indx << " is " << (state ? "on" : "off") << "!" << std::endl;
+            return true;
+        }
+    }
+    return false;
+}
@@ -0,0 +1,159 @@
+#pragma once
+
+#include "utils/scene.hpp"
+#include "utils/shader.hpp"
+#include "utils/shader_variants.hpp"
+#include "utils/specular_model.hpp"
+#include "utils/uniform_blocks.hpp"
+#include "utils/uniform_buffer.hpp"
+#include "utils/instance_buffer.hpp"
+#include "utils/light_clusters.hpp"
+#include "utils/light_culling.hpp"
+#include "utils/gbuffer.hpp"
+
+#include <array>
+
+//! @brief Lesson 5: directional, point and spot lights on a field of cubes.
+//! Cubes have one of NR_MATERIALS materials: layers of diffuse and specular map arrays, one bind for all of them.
+//! Object program is a variant (ShaderVariants) without code for point lights, spot light and emission that are off.
+//! Options: "--stress [count]" - procedural field of count cubes, "--no-instancing" - draw call per cube,
+//! "--no-variants" - one program with all lights (off ones have zero color),
+//! "--specular phong|blinn|fast" - specular model (part of the variant key in both modes),
+//! "--clustered [count]" - count animated point lights around the cubes instead of the 4 of the Lights block,
+//! clustered forward shading (LightClusters): each fragment loops over the lights of its froxel only,
+//! "--culled [count]" - count animated point lights with the lesson attenuation, each cube is shaded with the lights
+//! whose effective radius reaches it (LightCulling, per-object lists),
+//! "--deferred" - deferred shading: geometry pass writes a compact G-buffer (GBuffer), full-screen lighting pass
+//! shades every pixel once (froxel light lists of the pixel in clustered mode).
+class MultipleLightsScene : public Scene
+{
+public:
+    // must match NR_POINT_LIGHTS of object.fs
+    static constexpr size_t NR_POINT_LIGHTS = 4;
+    // must match NR_MATERIALS of object.fs
+    static constexpr size_t NR_MATERIALS = 3;
+    // stress mode: cube field is replaced with procedurally placed cubes
+    static constexpr size_t STRESS_CUBES_DEFAULT = 100000;
+    // clustered mode: number of lights, lights that reach an average point of the cube field
+    static constexpr size_t CLUSTERED_LIGHTS_DEFAULT = 10000;
+    static constexpr float CLUSTERED_LIGHT_OVERLAP = 8.0f;
+    // culled mode: number of lights, lights that reach an average point, luminance where a light stops
+    static constexpr size_t CULLED_LIGHTS_DEFAULT = 1000;
+    static constexpr float CULLED_LIGHT_OVERLAP = 32.0f;
+    static constexpr float CULLED_LUMINANCE_THRESHOLD = 5.0f / 256.0f;
+
+    std::string name() const override { return "05_multiple-lights"; }
+    bool parseArgument(int argc, char ** argv, int & i) override;
+
+    void render() override;
+    void destroy() override;
+
+    // G - emission glow
+    std::vector<int> heldKeys() const override;
+    void onKeyHeld(int key, float dt) override;
+    // F - flashlight, I - instancing, 1-4 - point lights, B - specular model, M - deferred shading
+    bool onKeyPress(int key) override;
+
+protected:
+    bool init() override;
+
+private:
+    // object program variant: point lights in use (first ones of Lights block), spot light, emission, specular model
+    static ShaderVariants::Key objectVariant(size_t pointLights, bool spotLight, bool emission,
+                                             SpecularModel::Tier specular, bool clustered, bool culled, bool deferred);
+    // variant of every light (fallback) or of the lights in use, clustered or culled lights in their modes
+    ShaderVariants::Key lightsVariant(bool all, bool emission, SpecularModel::Tier specular, bool deferred) const;
+    // cubes of the point lights (light program)
+    void drawLightCubes();
+    // material map units and emission uniforms of object or geometry pass program in use
+    void bindMaterialMaps(Shader const & shader, float glow);
+    // cube field with the program in use (object or geometry pass)
+    void drawCubes();
+    // object pass of forward shading, geometry and lighting passes of deferred shading
+    void renderForward(float glow);
+    void renderDeferred(glm::mat4 const & projection, glm::mat4 const & view, float glow);
+    // clustered and culled modes: count lights randomly placed around the cube field, each on its own orbit,
+    // radius such that about overlap lights reach a point of the field
+    void generateClusterLights(size_t count, float overlap);
+    // culled mode: lesson attenuation, intensity of each light fades to the threshold within the radius
+    void attenuateCulledLights();
+    // model matrix and bounding box of every cube at current time
+    void updateCubes();
+    void animateClusterLights();
+    static std::string objectDefines(ShaderVariants::Key key);
+
+    ShaderVariants objectShaders;
+    Shader lightingShader;
+    // deferred shading: geometry pass program, lighting pass variants (object.fs with DEFERRED, full-screen triangle)
+    Shader gbufferShader;
+    ShaderVariants deferredShaders;
+
+    // shared uniform blocks
+    UniformBuffer<PerFrameBlock> perFrameBuffer;
+    UniformBuffer<LightsBlock<NR_POINT_LIGHTS>> lightsBuffer;
+    UniformBuffer<MaterialsBlock<NR_MATERIALS>> materialsBuffer;
+
+    unsigned int VBO{0};
+    unsigned int VAO{0};
+    unsigned int singleVAO{0};
+    unsigned int lightVAO{0};
+    unsigned int singleLightVAO{0};
+    // no attributes: full-screen triangle of the lighting pass
+    unsigned int fullscreenVAO{0};
+    // per-instance model matrices
+    InstanceBuffer cubeInstanceBuffer;
+    InstanceBuffer lightInstanceBuffer;
+    // per-instance material IDs (static)
+    unsigned int materialVBO{0};
+
+    // textures (placeholders until loaded): maps of all materials in arrays
+    TextureHandle diffuseMaps;
+    TextureHandle specularMaps;
+    TextureHandle emissionMap;
+
+    std::vector<glm::vec3> cubePos;
+    std::vector<InstanceData> cubeInstances;
+    std::vector<unsigned int> cubeMaterials;
+    std::vector<InstanceData> lightInstances;
+    size_t stressCubes{0};
+
+    // clustered mode: lights assigned to froxels every frame, orbit center (xyz) and phase (w) of each light
+    size_t clusteredLights{0};
+    LightClusters lightClusters;
+    // culled mode: same lights, listed per cube every frame
+    size_t culledLights{0};
+    LightCulling lightCulling;
+    std::vector<LightCulling::Box> cubeBoxes;
+    std::vector<LightClusters::Light> clusterLights;
+    std::vector<glm::vec4> clusterOrbits;
+
+    // deferred mode: G-buffer of the viewport size (created on first deferred frame and on resize)
+    bool deferredOn{false};
+    GBuffer gBuffer;
+
+    // lighting
+    glm::vec3 lightColor{1.0f, 1.0f, 1.0f};
+    bool flashlightOn{false};
+
+    static constexpr float glowDuration = 3.0f;
+    float glowStart{-2.0f * glowDuration};
+
+    std::array<bool, NR_POINT_LIGHTS> lightState{false, false, false, true};
+
+    // instancing: one draw call per mesh instead of one per cube
+    bool instancingOn{true};
+    // program variant of the lights in use instead of the one with all lights
+    bool variantsOn{true};
+    // specular model of object program; all-lights variant of the start one is the fallback of every variant
+    SpecularModel::Tier specularModel{SpecularModel::PHONG};
+    SpecularModel::Tier startSpecularModel{SpecularModel::PHONG};
+
+    // profiling zones
+    int uniformsZone{0};
+    int clustersZone{0};
+    int cullingZone{0};
+    int lightPassZone{0};
+    int objectPassZone{0};
+    int geometryPassZone{0};
+    int lightingPassZone{0};
+};
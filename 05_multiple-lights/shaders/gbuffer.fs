@@ -0,0 +1,67 @@
+#version 330 core
+// geometry pass of the deferred path: material maps and normal of the fragment into the G-buffer (utils/gbuffer.hpp),
+// lights are added by the lighting pass (object.fs with DEFERRED)
+
+// std140 layout of MaterialData of utils/uniform_blocks.hpp
+struct Material {
+   int diffuseLayer;
+   int specularLayer;   // -1: no specular map, constant specular
+   float specular;
+   float shininess;
+};
+
+#define NR_MATERIALS 3
+
+// input parameters (from vertex shader object.vs)
+in vec3 Normal;
+in vec2 TexCoords;
+flat in uint MaterialID;
+
+layout (std140) uniform Materials
+{
+   Material materials[NR_MATERIALS];
+};
+
+// maps of all materials, layer is selected by material
+uniform sampler2DArray diffuseMaps;
+uniform sampler2DArray specularMaps;  // gray masks, red channel only (single channel texture)
+uniform sampler2D emissionMap;
+
+uniform float textShift;
+uniform float textGlow;
+
+// G-buffer attachments
+layout (location = 0) out vec4 AlbedoSpecular;  // diffuse texel, specular mask
+layout (location = 1) out vec4 NormalMaterial;  // octahedral normal, material ID / 1023, flags / 3
+layout (location = 2) out vec4 Emission;        // emission with glow, read where the emission flag is set
+
+// octahedral encoding: unit normal on the two components of 10 bits
+vec2 encodeNormal(vec3 n)
+{
+   n /= abs(n.x) + abs(n.y) + abs(n.z);
+   vec2 e = n.xy;
+   if (n.z < 0.0)
+      e = (1.0 - abs(n.yx)) * vec2(n.x >= 0.0 ? 1.0 : -1.0, n.y >= 0.0 ? 1.0 : -1.0);
+   return e * 0.5 + 0.5;
+}
+
+void main()
+{
+   Material material = materials[MaterialID];
+   vec3 diffuse = texture(diffuseMaps, vec3(TexCoords, material.diffuseLayer)).rgb;
+   float specular = material.specular;
+   if (material.specularLayer >= 0)
+      specular = texture(specularMaps, vec3(TexCoords, material.specularLayer)).r;
+
+   // flags: 1 - lit fragment, 3 - lit fragment with emission (where specular map is black)
+   float flags = 1.0;
+   Emission = vec4(0.0);
+   if (material.specularLayer >= 0 && specular == 0.0)
+   {
+      flags = 3.0;
+      Emission = vec4(texture(emissionMap, TexCoords + vec2(0.0, textShift)).rgb * textGlow, 1.0);
+   }
+
+   AlbedoSpecular = vec4(diffuse, specular);
+   NormalMaterial = vec4(encodeNormal(normalize(Normal)), float(MaterialID) / 1023.0, flags / 3.0);
+}
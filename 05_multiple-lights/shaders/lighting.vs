@@ -1,14 +1,19 @@
 #version 330 core
 
 layout (location = 0) in vec3 aPos;
+// per instance (or constant for single draw)
+layout (location = 3) in mat4 aModel;
 
-uniform mat4 model;
-uniform mat4 view;
-uniform mat4 projection;
+layout (std140) uniform PerFrame
+{
+   mat4 projection;
+   mat4 view;
+   vec3 viewPos;
+};
 
 out vec2 TexCoord;
 
 void main()
 {
-   gl_Position = projection * view * model * vec4(aPos, 1.0);
+   gl_Position = projection * view * aModel * vec4(aPos, 1.0);
 }
@@ -1,11 +1,13 @@
 #version 330 core
+// std140 layout of MaterialData of utils/uniform_blocks.hpp
 struct Material {
-   sampler2D diffuse;
-   sampler2D specular;
-   sampler2D emission;
+   int diffuseLayer;
+   int specularLayer;   // -1: no specular map, constant specular
+   float specular;
    float shininess;
 };
 
+// light structs follow std140 layout of utils/uniform_blocks.hpp: every vec3 is paired with a float
 struct DirLight {
    vec3 direction;
 
@@ -16,111 +18,279 @@ struct DirLight {
 
 struct PointLight {
    vec3 position;
-
    float constant;
-   float linear;
-   float quadratic;
 
    vec3 ambient;
+   float linear;
    vec3 diffuse;
+   float quadratic;
    vec3 specular;
 };
 
 struct SpotLight {
     vec3 position;
-    vec3 direction;
     float cutOff;
+    vec3 direction;
     float outerCutOff;
-  
-    float constant;
-    float linear;
-    float quadratic;
-  
+
     vec3 ambient;
+    float constant;
     vec3 diffuse;
+    float linear;
     vec3 specular;
+    float quadratic;
 };
 
 #define NR_POINT_LIGHTS 4
+#define NR_MATERIALS 3
 
-vec3 CalcDirLight(DirLight light, vec3 normal, vec3 viewDir);
-vec3 CalcPointLight(PointLight light, vec3 normal, vec3 fragPos, vec3 viewDir);
-vec3 CalcSpotLight(SpotLight light, vec3 normal, vec3 fragPos, vec3 viewDir);
+// variant of the program (defines of the scene, everything on without them):
+// lights in use are the first POINT_LIGHT_COUNT ones, features that are off have no code at all
+#ifndef POINT_LIGHT_COUNT
+#define POINT_LIGHT_COUNT NR_POINT_LIGHTS
+#endif
+#ifndef SPOT_LIGHT
+#define SPOT_LIGHT 1
+#endif
+#ifndef EMISSION
+#define EMISSION 1
+#endif
+// clustered point lights (utils/light_clusters.hpp) instead of the Lights block ones
+#ifndef CLUSTERED
+#define CLUSTERED 0
+#endif
+// point lights listed for the object (utils/light_culling.hpp) instead of the Lights block ones
+#ifndef CULLED
+#define CULLED 0
+#endif
+// lighting pass of the deferred path (deferred.vs): surface of the pixel from the G-buffer of gbuffer.fs
+#ifndef DEFERRED
+#define DEFERRED 0
+#endif
 
-// input parameters (from fragment shader)
+// material maps at the fragment: sampled once in main, shared by all lights
+struct Surface {
+   vec3 diffuse;     // diffuse map texel (ambient and diffuse color)
+   vec3 specular;    // specular map texel or constant specular of the material
+   float shininess;
+};
+
+vec3 CalcDirLight(DirLight light, Surface surface, vec3 normal, vec3 viewDir);
+vec3 CalcPointLight(PointLight light, Surface surface, vec3 normal, vec3 fragPos, vec3 viewDir);
+vec3 CalcSpotLight(SpotLight light, Surface surface, vec3 normal, vec3 fragPos, vec3 viewDir);
+vec3 CalcClusterLights(Surface surface, vec3 normal, vec3 fragPos, vec3 viewDir);
+vec3 CalcObjectLights(Surface surface, vec3 normal, vec3 fragPos, vec3 viewDir);
+
+#if DEFERRED
+// G-buffer attachments (utils/gbuffer.hpp)
+uniform sampler2D gAlbedoSpecular;   // diffuse texel, specular mask
+uniform sampler2D gNormalMaterial;   // octahedral normal, material ID / 1023, flags / 3 (0 - no fragment)
+uniform sampler2D gEmission;         // emission with glow, where flags are 3
+uniform sampler2D gDepth;
+uniform mat4 inverseViewProjection;  // world position from window depth
+#else
+// input parameters (from vertex shader)
 in vec3 Normal;
 in vec3 FragPos;
 in vec2 TexCoords;
+flat in uint MaterialID;
+#endif
+#if CULLED
+flat in uvec2 LightList;
+#endif
 
-// uniform parameters (is set in main)
-uniform Material material;
-uniform DirLight dirLight;
-uniform PointLight pointLights[NR_POINT_LIGHTS];
-uniform SpotLight spotLight;
+// uniform blocks (are shared between programs and uploaded once per frame)
+layout (std140) uniform PerFrame
+{
+   mat4 projection;
+   mat4 view;
+   vec3 viewPos;
+};
 
-uniform vec3 viewPos;
+layout (std140) uniform Lights
+{
+   DirLight dirLight;
+   PointLight pointLights[NR_POINT_LIGHTS];
+   SpotLight spotLight;
+};
+
+layout (std140) uniform Materials
+{
+   Material materials[NR_MATERIALS];
+};
+
+#if !DEFERRED
+// uniform parameters (is set in main): maps of all materials, layer is selected by material
+uniform sampler2DArray diffuseMaps;
+uniform sampler2DArray specularMaps;  // gray masks, red channel only (single channel texture)
+uniform sampler2D emissionMap;
 
 uniform float textShift;
 uniform float textGlow;
+#endif
+
+#if CLUSTERED
+// must match LightClusters::TILES_X, TILES_Y and SLICES
+#define CLUSTER_TILES_X 16
+#define CLUSTER_TILES_Y 9
+#define CLUSTER_SLICES 24
+
+uniform samplerBuffer clusterLights;    // 2 texels per light: position and radius, color
+uniform usamplerBuffer clusterGrid;     // per froxel: offset in clusterIndices and light count
+uniform usamplerBuffer clusterIndices;  // light lists of all froxels
+uniform vec2 clusterScreen;             // tiles per pixel
+uniform vec2 clusterDepth;              // slice = log(view depth) * x + y
+#endif
+
+#if CULLED
+uniform samplerBuffer culledLights;     // 2 texels per light: position and radius, color
+uniform usamplerBuffer culledIndices;   // light lists of all objects
+#endif
 
 // out parameter
 out vec4 FragColor;
 
+// specular model of the program (SPECULAR_MODEL define of the scene, Phong without it), utils/specular_model.hpp:
+// 0 - Phong, 1 - Blinn-Phong, 2 - Blinn-Phong with approximated pow
+#ifndef SPECULAR_MODEL
+#define SPECULAR_MODEL 0
+#endif
+
+float specularFactor(vec3 normal, vec3 lightDir, vec3 viewDir, float shininess)
+{
+#if SPECULAR_MODEL == 0
+   vec3 reflectDir = reflect(-lightDir, normal);
+   return pow(max(dot(viewDir, reflectDir), 0.0), shininess);
+#else
+   // angle to the half vector is about half of the reflection angle: 4x exponent keeps the highlight size
+   vec3 halfwayDir = normalize(lightDir + viewDir);
+   float x = max(dot(normal, halfwayDir), 0.0);
+   float n = 4.0 * shininess;
+#if SPECULAR_MODEL == 1
+   return pow(x, n);
+#else
+   // Schlick: pow(x, n) ~ x / (n - n * x + x), a division instead of exp2(n * log2(x))
+   return x / (n - n * x + x);
+#endif
+#endif
+}
+
+#if DEFERRED
+// inverse of encodeNormal of gbuffer.fs
+vec3 decodeNormal(vec2 e)
+{
+   e = e * 2.0 - 1.0;
+   vec3 n = vec3(e, 1.0 - abs(e.x) - abs(e.y));
+   float t = max(-n.z, 0.0);
+   n.xy -= vec2(n.x >= 0.0 ? t : -t, n.y >= 0.0 ? t : -t);
+   return normalize(n);
+}
+#else
+// maps of the material of the instance, one fetch per map
+Surface sampleSurface(Material material)
+{
+   Surface surface;
+   surface.diffuse = texture(diffuseMaps, vec3(TexCoords, material.diffuseLayer)).rgb;
+   if (material.specularLayer < 0)
+      surface.specular = vec3(material.specular);
+   else
+      surface.specular = vec3(texture(specularMaps, vec3(TexCoords, material.specularLayer)).r);
+   surface.shininess = material.shininess;
+   return surface;
+}
+#endif
+
 void main()
 {   
+#if DEFERRED
+   // pixel of the G-buffer, background keeps the clear color
+   ivec2 pixel = ivec2(gl_FragCoord.xy);
+   vec4 normalMaterial = texelFetch(gNormalMaterial, pixel, 0);
+   int flags = int(normalMaterial.a * 3.0 + 0.5);
+   if (flags == 0)
+      discard;
+   Material material = materials[int(normalMaterial.b * 1023.0 + 0.5)];
+   vec4 albedoSpecular = texelFetch(gAlbedoSpecular, pixel, 0);
+   Surface surface = Surface(albedoSpecular.rgb, vec3(albedoSpecular.a), material.shininess);
+   vec3 norm = decodeNormal(normalMaterial.rg);
+   // position from depth; depth is written for the light cubes drawn after this pass
+   float depth = texelFetch(gDepth, pixel, 0).r;
+   vec4 position = inverseViewProjection
+                 * vec4(gl_FragCoord.xy / vec2(textureSize(gDepth, 0)) * 2.0 - 1.0, depth * 2.0 - 1.0, 1.0);
+   vec3 fragPos = position.xyz / position.w;
+   gl_FragDepth = depth;
+#else
+   Material material = materials[MaterialID];
+   Surface surface = sampleSurface(material);
    // properties
    vec3 norm = normalize(Normal);
-   vec3 viewDir = normalize(viewPos - FragPos);
+   vec3 fragPos = FragPos;
+#endif
+   vec3 viewDir = normalize(viewPos - fragPos);
 
    vec3 result = vec3(0.0);
    // phase 1: Directional lighting
-   result += CalcDirLight(dirLight, norm, viewDir);
+   result += CalcDirLight(dirLight, surface, norm, viewDir);
    // phase 2: Point lights
-   for (int i = 0; i < NR_POINT_LIGHTS; ++i)
-      result += CalcPointLight(pointLights[i], norm, FragPos, viewDir);
+   for (int i = 0; i < POINT_LIGHT_COUNT; ++i)
+      result += CalcPointLight(pointLights[i], surface, norm, fragPos, viewDir);
+#if CLUSTERED
+   // phase 2b: point lights of the froxel of the fragment
+   result += CalcClusterLights(surface, norm, fragPos, viewDir);
+#endif
+#if CULLED
+   // phase 2c: point lights whose radius reaches the object
+   result += CalcObjectLights(surface, norm, fragPos, viewDir);
+#endif
+#if SPOT_LIGHT
    // phase 3: spot light
-   result += CalcSpotLight(spotLight, norm, FragPos, viewDir);
+   result += CalcSpotLight(spotLight, surface, norm, fragPos, viewDir);
+#endif
 
-   // phase 4: emission part
+#if EMISSION && DEFERRED
+   // phase 4: emission part, sampled by the geometry pass
+   if (flags == 3)
+      result += texelFetch(gEmission, pixel, 0).rgb;
+#elif EMISSION
+   // phase 4: emission part (where specular map is black)
    vec3 emission = vec3(0.0);
-   if (texture(material.specular, TexCoords).r == 0.0)
+   if (material.specularLayer >= 0 && surface.specular.r == 0.0)
    {
-      emission = texture(material.emission, TexCoords + vec2(0.0, textShift)).rgb;
+      emission = texture(emissionMap, TexCoords + vec2(0.0, textShift)).rgb;
       result += emission * textGlow;
    }
+#endif
    FragColor = vec4(result, 1.0);
 }
 
-vec3 CalcDirLight(DirLight light, vec3 normal, vec3 viewDir)
+vec3 CalcDirLight(DirLight light, Surface surface, vec3 normal, vec3 viewDir)
 {
    vec3 lightDir = normalize(-light.direction);
    // diffuse shading
    float diff = max(dot(normal, lightDir), 0.0);
    // specular shading
-   vec3 reflectDir = reflect(-lightDir, normal);
-   float spec = pow(max(dot(viewDir, reflectDir), 0.0), material.shininess);
+   float spec = specularFactor(normal, lightDir, viewDir, surface.shininess);
    // combine results
-   vec3 ambient  = light.ambient  * vec3(texture(material.diffuse, TexCoords));
-   vec3 diffuse  = light.diffuse  * diff * vec3(texture(material.diffuse, TexCoords));
-   vec3 specular = light.specular * spec * vec3(texture(material.specular, TexCoords));
+   vec3 ambient  = light.ambient  * surface.diffuse;
+   vec3 diffuse  = light.diffuse  * diff * surface.diffuse;
+   vec3 specular = light.specular * spec * surface.specular;
    return (ambient + diffuse + specular);
 }
 
-vec3 CalcPointLight(PointLight light, vec3 normal, vec3 fragPos, vec3 viewDir)
+vec3 CalcPointLight(PointLight light, Surface surface, vec3 normal, vec3 fragPos, vec3 viewDir)
 {
    vec3 lightDir = normalize(light.position - fragPos);
    // diffuse shading
    float diff = max(dot(normal, lightDir), 0.0);
    // specular shading
-   vec3 reflectDir = reflect(-lightDir, normal);
-   float spec = pow(max(dot(viewDir, reflectDir), 0.0), material.shininess);
+   float spec = specularFactor(normal, lightDir, viewDir, surface.shininess);
    // attenuation 
    float distance = length(light.position - fragPos);
    float attenuation = 1.0 / (light.constant + light.linear * distance + light.quadratic * (distance * distance));
    // combine results
-   vec3 ambient  = light.ambient  * vec3(texture(material.diffuse, TexCoords));
-   vec3 diffuse  = light.diffuse  * diff * vec3(texture(material.diffuse, TexCoords));
-   vec3 specular = light.specular * spec * vec3(texture(material.specular, TexCoords));
+   vec3 ambient  = light.ambient  * surface.diffuse;
+   vec3 diffuse  = light.diffuse  * diff * surface.diffuse;
+   vec3 specular = light.specular * spec * surface.specular;
 
    ambient *= attenuation;
    diffuse *= attenuation;
@@ -130,14 +300,13 @@ vec3 CalcPointLight(PointLight light, vec3 normal, vec3 fragPos, vec3 viewDir)
 }
 
 // calculates the color when using a spot light.
-vec3 CalcSpotLight(SpotLight light, vec3 normal, vec3 fragPos, vec3 viewDir)
+vec3 CalcSpotLight(SpotLight light, Surface surface, vec3 normal, vec3 fragPos, vec3 viewDir)
 {
    vec3 lightDir = normalize(light.position - fragPos);
    // diffuse shading
    float diff = max(dot(normal, lightDir), 0.0);
    // specular shading
-   vec3 reflectDir = reflect(-lightDir, normal);
-   float spec = pow(max(dot(viewDir, reflectDir), 0.0), material.shininess);
+   float spec = specularFactor(normal, lightDir, viewDir, surface.shininess);
 
    // attenuation
    float distance = length(light.position - fragPos);
@@ -149,9 +318,9 @@ vec3 CalcSpotLight(SpotLight light, vec3 normal, vec3 fragPos, vec3 viewDir)
    float intensity = clamp((theta - light.outerCutOff) / epsilon, 0.0, 1.0);
 
    // combine results
-   vec3 ambient = light.ambient * vec3(texture(material.diffuse, TexCoords));
-   vec3 diffuse = light.diffuse * diff * vec3(texture(material.diffuse, TexCoords));
-   vec3 specular = light.specular * spec * vec3(texture(material.specular, TexCoords));
+   vec3 ambient = light.ambient * surface.diffuse;
+   vec3 diffuse = light.diffuse * diff * surface.diffuse;
+   vec3 specular = light.specular * spec * surface.specular;
 
    ambient *= attenuation * intensity;
    diffuse *= attenuation * intensity;
@@ -159,3 +328,67 @@ vec3 CalcSpotLight(SpotLight light, vec3 normal, vec3 fragPos, vec3 viewDir)
 
    return (ambient + diffuse + specular);
 }
+
+#if CLUSTERED
+// sum of the lights listed in the froxel of the fragment; light fades to zero at its radius
+vec3 CalcClusterLights(Surface surface, vec3 normal, vec3 fragPos, vec3 viewDir)
+{
+   float depth = -(view * vec4(fragPos, 1.0)).z;
+   ivec2 tile = min(ivec2(gl_FragCoord.xy * clusterScreen), ivec2(CLUSTER_TILES_X - 1, CLUSTER_TILES_Y - 1));
+   int slice = clamp(int(floor(log(depth) * clusterDepth.x + clusterDepth.y)), 0, CLUSTER_SLICES - 1);
+   uvec2 list = texelFetch(clusterGrid, (slice * CLUSTER_TILES_Y + tile.y) * CLUSTER_TILES_X + tile.x).rg;
+
+   vec3 result = vec3(0.0);
+   for (uint i = 0u; i < list.y; ++i)
+   {
+      int light = int(texelFetch(clusterIndices, int(list.x + i)).r);
+      vec4 positionRadius = texelFetch(clusterLights, 2 * light);
+      vec3 color = texelFetch(clusterLights, 2 * light + 1).rgb;
+
+      vec3 toLight = positionRadius.xyz - fragPos;
+      float distance = length(toLight);
+      vec3 lightDir = toLight / distance;
+      // diffuse and specular shading
+      float diff = max(dot(normal, lightDir), 0.0);
+      float spec = specularFactor(normal, lightDir, viewDir, surface.shininess);
+      // attenuation of the lesson lights, windowed to reach zero at the radius
+      float window = clamp(1.0 - pow(distance / positionRadius.w, 4.0), 0.0, 1.0);
+      float attenuation = window * window / (1.0 + 0.09 * distance + 0.032 * (distance * distance));
+
+      result += color * (diff * surface.diffuse + spec * surface.specular) * attenuation;
+   }
+   return result;
+}
+#endif
+
+#if CULLED
+// lesson attenuation of the culled lights
+float lessonAttenuation(float distance)
+{
+   return 1.0 / (1.0 + 0.09 * distance + 0.032 * (distance * distance));
+}
+
+// sum of the lights listed for the object; attenuation is lowered by its value at the effective radius, so a light
+// fades to zero there and lights that are not listed (sphere does not touch the box) would add nothing
+vec3 CalcObjectLights(Surface surface, vec3 normal, vec3 fragPos, vec3 viewDir)
+{
+   vec3 result = vec3(0.0);
+   for (uint i = 0u; i < LightList.y; ++i)
+   {
+      int light = int(texelFetch(culledIndices, int(LightList.x + i)).r);
+      vec4 positionRadius = texelFetch(culledLights, 2 * light);
+      vec3 color = texelFetch(culledLights, 2 * light + 1).rgb;
+
+      vec3 toLight = positionRadius.xyz - fragPos;
+      float distance = length(toLight);
+      vec3 lightDir = toLight / distance;
+      // diffuse and specular shading
+      float diff = max(dot(normal, lightDir), 0.0);
+      float spec = specularFactor(normal, lightDir, viewDir, surface.shininess);
+      float attenuation = max(lessonAttenuation(distance) - lessonAttenuation(positionRadius.w), 0.0);
+
+      result += color * (diff * surface.diffuse + spec * surface.specular) * attenuation;
+   }
+   return result;
+}
+#endif
@@ -3,19 +3,41 @@
 layout (location = 0) in vec3 aPos;
 layout (location = 1) in vec3 aNormal;
 layout (location = 2) in vec2 aTexCoords;
+// per instance (or constant for single draw)
+layout (location = 3) in mat4 aModel;
+layout (location = 7) in mat3 aNormalMatrix;
+layout (location = 10) in uint aMaterial;
 
-uniform mat4 model;
-uniform mat4 view;
-uniform mat4 projection;
+// per-object light lists (utils/light_culling.hpp), defines of the object program variant
+#ifndef CULLED
+#define CULLED 0
+#endif
+#if CULLED
+// offset in light indices and light count of the instance
+layout (location = 11) in uvec2 aLightList;
+flat out uvec2 LightList;
+#endif
+
+layout (std140) uniform PerFrame
+{
+   mat4 projection;
+   mat4 view;
+   vec3 viewPos;
+};
 
 out vec3 Normal;
 out vec3 FragPos;
 out vec2 TexCoords;
+flat out uint MaterialID;
 
 void main()
 {
-   gl_Position = projection * view * model * vec4(aPos, 1.0);
-   FragPos = vec3(model * vec4(aPos, 1.0));
-   Normal = mat3(transpose(inverse(model))) * aNormal;
+   gl_Position = projection * view * aModel * vec4(aPos, 1.0);
+   FragPos = vec3(aModel * vec4(aPos, 1.0));
+   Normal = aNormalMatrix * aNormal;
    TexCoords = aTexCoords;
+   MaterialID = aMaterial;
+#if CULLED
+   LightList = aLightList;
+#endif
 }
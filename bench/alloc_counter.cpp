@@ -0,0 +1,27 @@
+#include "alloc_counter.hpp"
+
+#include <atomic>
+#include <cstdlib>
+#include <new>
+
+static std::atomic<size_t> sAllocations{0};
+
+size_t AllocCounter::count()
+{
+    return sAllocations.load(std::memory_order_relaxed);
+}
+
+static void * countedAlloc(std::size_t size)
+{
+    sAllocations.fetch_add(1, std::memory_order_relaxed);
+    if (void * ptr = std::malloc(size ? size : 1))
+        return ptr;
+    throw std::bad_alloc();
+}
+
+void * operator new(std::size_t size) { return countedAlloc(size); }
+void * operator new[](std::size_t size) { return countedAlloc(size); }
+void operator delete(void * ptr) noexcept { std::free(ptr); }
+void operator delete[](void * ptr) noexcept { std::free(ptr); }
+void operator delete(void * ptr, std::size_t) noexcept { std::free(ptr); }
+void operator delete[](void * ptr, std::size_t) noexcept { std::free(ptr); }
@@ -0,0 +1,11 @@
+#pragma once
+
+#include <cstddef>
+
+// Test hook: global operator new is replaced in alloc_counter.cpp to count heap allocations.
+// Link alloc_counter.cpp into a binary to enable it.
+namespace AllocCounter
+{
+    //! @brief Number of operator new calls since program start
+    size_t count();
+}
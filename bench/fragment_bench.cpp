@@ -0,0 +1,273 @@
+// Fragment throughput of the "05_multiple-lights" object shader in a headless context (Mesa llvmpipe without GPU).
+// Full-screen quads with the lesson textures and lights, one per material, so every pixel runs the lighting.
+// Compares two ways to read the material maps:
+//   naive   - maps are sampled again in every light function (lesson 5 before)
+//   surface - maps are sampled once per fragment into Surface, shared by all lights (lesson 5 now)
+// Both run as the variant with all lights on and as the one of the lesson start state (one point light).
+// Specular models of the lesson shader (utils/specular_model.hpp) are compared with its Phong variant:
+//   blinn   - Blinn-Phong, half vector instead of reflected light direction
+//   fast    - Blinn-Phong with Schlick's approximation of pow
+// Usage: fragment_bench [size] [frames]
+#include "glad/glad.h"
+
+#include <glm/glm.hpp>
+
+#include "utils/shader.hpp"
+#include "utils/shader_library.hpp"
+#include "utils/uniform_blocks.hpp"
+#include "utils/uniform_buffer.hpp"
+#include "utils/instance_buffer.hpp"
+#include "utils/headless_context.hpp"
+#include "utils/offscreen_target.hpp"
+#include "utils/specular_model.hpp"
+#include "utils/texture_loader.hpp"
+
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <iostream>
+#include <string>
+
+// =============================================
+
+static const std::string LESSON_DIR = "05_multiple-lights";
+static const std::string BENCH_DIR = "fragment_bench";
+
+// must match NR_POINT_LIGHTS and NR_MATERIALS of object.fs
+static const size_t NR_POINT_LIGHTS = 4;
+static const size_t NR_MATERIALS = 3;
+
+// same materials as lesson 5: container2 (with specular map), container, wall
+static const std::array<MaterialData, NR_MATERIALS> materials = {
+    MaterialData{0, 0, 0.0f, 64.0f},
+    MaterialData{1, -1, 0.1f, 32.0f},
+    MaterialData{2, -1, 0.05f, 8.0f},
+};
+
+// program of a measurement: fragment shader and variant, ratio is given against the baseline case
+struct Case
+{
+    char const * name;
+    bool naive;
+    bool allLights;
+    SpecularModel::Tier specular;
+    int baseline;
+};
+
+static const std::array<Case, 8> cases = {
+    Case{"all lights, naive", true, true, SpecularModel::PHONG, -1},
+    Case{"all lights, surface", false, true, SpecularModel::PHONG, 0},
+    Case{"all lights, blinn", false, true, SpecularModel::BLINN_PHONG, 1},
+    Case{"all lights, fast", false, true, SpecularModel::FAST, 1},
+    Case{"one light, naive", true, false, SpecularModel::PHONG, -1},
+    Case{"one light, surface", false, false, SpecularModel::PHONG, 4},
+    Case{"one light, blinn", false, false, SpecularModel::BLINN_PHONG, 5},
+    Case{"one light, fast", false, false, SpecularModel::FAST, 5},
+};
+
+// quad over the whole target (identity view and projection), facing the viewer
+static const float quadVertices[] = {
+    // positions          // normals           // texture coords
+    -1.0f, -1.0f,  0.0f,  0.0f,  0.0f,  1.0f,  0.0f,  0.0f,
+     1.0f, -1.0f,  0.0f,  0.0f,  0.0f,  1.0f,  1.0f,  0.0f,
+     1.0f,  1.0f,  0.0f,  0.0f,  0.0f,  1.0f,  1.0f,  1.0f,
+     1.0f,  1.0f,  0.0f,  0.0f,  0.0f,  1.0f,  1.0f,  1.0f,
+    -1.0f,  1.0f,  0.0f,  0.0f,  0.0f,  1.0f,  0.0f,  1.0f,
+    -1.0f, -1.0f,  0.0f,  0.0f,  0.0f,  1.0f,  0.0f,  0.0f,
+};
+
+using bench_clock = std::chrono::steady_clock;
+
+static double elapsedMs(bench_clock::time_point start)
+{
+    return std::chrono::duration<double, std::milli>(bench_clock::now() - start).count();
+}
+
+// defines of the object program variant (as MultipleLightsScene::objectDefines)
+static std::string objectDefines(size_t pointLights, bool spotLight, bool emission)
+{
+    return "#define POINT_LIGHT_COUNT " + std::to_string(pointLights)
+         + "\n#define SPOT_LIGHT " + (spotLight ? "1" : "0")
+         + "\n#define EMISSION " + (emission ? "1" : "0") + "\n";
+}
+
+// all lights on and lit from the front: no fragment skips a light
+static LightsBlock<NR_POINT_LIGHTS> frontLights(glm::vec3 const & viewPos)
+{
+    LightsBlock<NR_POINT_LIGHTS> lights;
+    lights.dirLight.direction = glm::vec3(-0.2f, -0.3f, -1.0f);
+    lights.dirLight.ambient = glm::vec3(0.1f);
+    lights.dirLight.diffuse = glm::vec3(0.25f);
+    lights.dirLight.specular = glm::vec3(0.5f);
+
+    for (size_t i = 0; i < NR_POINT_LIGHTS; ++i)
+    {
+        PointLightData & pointLight = lights.pointLights[i];
+        pointLight.position = glm::vec3(i % 2 ? 0.6f : -0.6f, i / 2 ? 0.6f : -0.6f, 1.0f);
+        pointLight.constant = 1.0f;
+        pointLight.linear = 0.09f;
+        pointLight.quadratic = 0.032f;
+        pointLight.ambient = glm::vec3(0.05f);
+        pointLight.diffuse = glm::vec3(0.3f);
+        pointLight.specular = glm::vec3(1.0f);
+    }
+
+    SpotLightData & spotLight = lights.spotLight;
+    spotLight.position = viewPos;
+    spotLight.direction = glm::vec3(0.0f, 0.0f, -1.0f);
+    spotLight.cutOff = glm::cos(glm::radians(12.5f));
+    spotLight.outerCutOff = glm::cos(glm::radians(18.0f));
+    spotLight.constant = 1.0f;
+    spotLight.linear = 0.09f;
+    spotLight.quadratic = 0.032f;
+    spotLight.ambient = glm::vec3(0.1f);
+    spotLight.diffuse = glm::vec3(1.0f);
+    spotLight.specular = glm::vec3(1.0f);
+    return lights;
+}
+
+// Draw the quad once per material `frames` times, returns mean milliseconds per frame
+static double measure(Shader const & shader, unsigned int VAO, int frames)
+{
+    shader.use();
+    shader.setInt("diffuseMaps", 0);
+    shader.setInt("specularMaps", 1);
+    shader.setInt("emissionMap", 2);
+    shader.setFloat("textShift", 0.0f);
+    shader.setFloat("textGlow", 1.0f);
+    glBindVertexArray(VAO);
+
+    double total = 0.0;
+    for (int i = -2; i < frames; ++i) // two warm-up frames
+    {
+        auto start = bench_clock::now();
+        glClear(GL_COLOR_BUFFER_BIT);
+        for (size_t material = 0; material < NR_MATERIALS; ++material)
+        {
+            glVertexAttribI1ui(InstanceAttrib::MATERIAL, static_cast<GLuint>(material));
+            glDrawArrays(GL_TRIANGLES, 0, 6);
+        }
+        glFinish();
+        if (i >= 0)
+            total += elapsedMs(start);
+    }
+    return total / frames;
+}
+
+// ===========================================================
+int main(int argc, char ** argv)
+{
+    int size = argc > 1 ? std::atoi(argv[1]) : 512;
+    int frames = argc > 2 ? std::atoi(argv[2]) : 20;
+    if (size < 1)
+        size = 1;
+    if (frames < 1)
+        frames = 1;
+
+    HeadlessContext context;
+    if (!context.create())
+        return -1;
+
+    OffscreenTarget target;
+    if (!target.create(size, size))
+        return -1;
+
+    std::string benchPath = "shaders/" + BENCH_DIR + "/";
+    std::string lessonPath = "shaders/" + LESSON_DIR + "/";
+    std::array<Shader, cases.size()> programs;
+    ShaderLibrary shaders;
+    for (size_t i = 0; i < cases.size(); ++i)
+    {
+        Case const & c = cases[i];
+        // all lights on or the lesson start state (one point light)
+        std::string defines = c.allLights ? objectDefines(NR_POINT_LIGHTS, true, true) : objectDefines(1, false, false);
+        std::string fragmentPath = c.naive ? benchPath + "object_naive.fs" : lessonPath + "object.fs";
+        shaders.add(programs[i], lessonPath + "object.vs", fragmentPath, defines + SpecularModel::define(c.specular));
+    }
+    if (!shaders.build())
+        return -1;
+
+    UniformBuffer<PerFrameBlock> perFrameBuffer(UniformBlockBinding::PER_FRAME);
+    UniformBuffer<LightsBlock<NR_POINT_LIGHTS>> lightsBuffer(UniformBlockBinding::LIGHTS);
+    UniformBuffer<MaterialsBlock<NR_MATERIALS>> materialsBuffer(UniformBlockBinding::MATERIALS);
+    for (Shader & shader : programs)
+    {
+        shader.bindUniformBlock("PerFrame", perFrameBuffer.getBindingPoint());
+        shader.bindUniformBlock("Lights", lightsBuffer.getBindingPoint());
+        shader.bindUniformBlock("Materials", materialsBuffer.getBindingPoint());
+    }
+
+    PerFrameBlock perFrame;
+    perFrame.projection = glm::mat4(1.0f);
+    perFrame.view = glm::mat4(1.0f);
+    perFrame.viewPos = glm::vec3(0.0f, 0.0f, 3.0f);
+    perFrameBuffer.upload(perFrame);
+    lightsBuffer.upload(frontLights(perFrame.viewPos));
+    MaterialsBlock<NR_MATERIALS> materialsBlock;
+    std::copy(materials.begin(), materials.end(), materialsBlock.materials);
+    materialsBuffer.upload(materialsBlock);
+
+    // lesson textures, all uploaded before measuring
+    TextureLoader textureLoader;
+    textureLoader.create();
+    std::string texturePath = "textures/" + LESSON_DIR + "/";
+    TextureHandle diffuseMaps = textureLoader.loadArray({texturePath + "container2.png", texturePath + "container.jpg",
+                                                         texturePath + "wall.jpg"});
+    TextureHandle specularMaps = textureLoader.loadArray({texturePath + "container2_specular.png"});
+    TextureHandle emissionMap = textureLoader.load(texturePath + "matrix.jpg");
+    textureLoader.finish();
+    glActiveTexture(GL_TEXTURE0);
+    glBindTexture(GL_TEXTURE_2D_ARRAY, diffuseMaps.id());
+    glActiveTexture(GL_TEXTURE1);
+    glBindTexture(GL_TEXTURE_2D_ARRAY, specularMaps.id());
+    glActiveTexture(GL_TEXTURE2);
+    glBindTexture(GL_TEXTURE_2D, emissionMap.id());
+
+    unsigned int VBO, VAO;
+    glGenBuffers(1, &VBO);
+    glGenVertexArrays(1, &VAO);
+    glBindVertexArray(VAO);
+    glBindBuffer(GL_ARRAY_BUFFER, VBO);
+    glBufferData(GL_ARRAY_BUFFER, sizeof(quadVertices), quadVertices, GL_STATIC_DRAW);
+    unsigned int byte_stride = 8 * sizeof(float);
+    glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, byte_stride, (void*)(0 * sizeof(float)));
+    glEnableVertexAttribArray(0);
+    glVertexAttribPointer(1, 3, GL_FLOAT, GL_FALSE, byte_stride, (void*)(3 * sizeof(float)));
+    glEnableVertexAttribArray(1);
+    glVertexAttribPointer(2, 2, GL_FLOAT, GL_FALSE, byte_stride, (void*)(6 * sizeof(float)));
+    glEnableVertexAttribArray(2);
+    // single quad: model and normal matrix are constant attributes
+    InstanceBuffer::setCurrent(makeInstance(glm::mat4(1.0f)));
+
+    std::array<double, cases.size()> ms;
+    for (size_t i = 0; i < cases.size(); ++i)
+        ms[i] = measure(programs[i], VAO, frames);
+
+    // megapixels per millisecond * 1000 = megapixels per second
+    double pixels = double(size) * double(size) * double(NR_MATERIALS);
+    std::cout << NR_MATERIALS << " full-screen quads per frame (" << pixels / 1e6 << " M fragments), " << frames
+              << " frames, " << size << "x" << size << " target" << std::endl;
+    for (size_t i = 0; i < cases.size(); ++i)
+    {
+        Case const & c = cases[i];
+        std::printf("%-20s: %8.3f ms/frame, %7.2f M fragments/s", c.name, ms[i], pixels / ms[i] / 1e3);
+        if (c.baseline >= 0)
+            std::printf(" (x%.2f of %s)", ms[c.baseline] / ms[i], cases[c.baseline].name);
+        std::printf("\n");
+    }
+
+    glDeleteVertexArrays(1, &VAO);
+    glDeleteBuffers(1, &VBO);
+    diffuseMaps.destroy();
+    specularMaps.destroy();
+    emissionMap.destroy();
+    textureLoader.destroy();
+    lightsBuffer.destroy();
+    materialsBuffer.destroy();
+    perFrameBuffer.destroy();
+    target.destroy();
+    context.destroy();
+    return 0;
+}
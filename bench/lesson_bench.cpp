@@ -0,0 +1,313 @@
+// Frame time of every lesson scene in a headless context (Mesa llvmpipe without GPU).
+// Each lesson runs at each resolution on its own offscreen target: warm-up frames first (not measured),
+// then measured frames with the same profiling zones as "--profile" of the lesson executables.
+// Usage: lesson_bench [--warmup N] [--frames M] [--resolution WxH]... [--lesson name]... [--report file.json]
+//                     [lesson options, e.g. --stress 100000 --no-instancing]
+#include "glad/glad.h"
+
+#include "utils/asset_pack.hpp"
+#include "utils/headless_context.hpp"
+#include "utils/offscreen_target.hpp"
+#include "utils/profiler.hpp"
+#include "utils/texture_loader.hpp"
+#include "01_colors/scene.hpp"
+#include "02_basics/scene.hpp"
+#include "03_materials/scene.hpp"
+#include "04_lighting-maps/scene.hpp"
+#include "05_multiple-lights/scene.hpp"
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <functional>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <vector>
+
+// =============================================
+
+// same time step as "--headless" of the lessons
+static const float DELTA_TIME = 1.0f / 60.0f;
+
+using bench_clock = std::chrono::steady_clock;
+
+using SceneFactory = std::function<std::unique_ptr<Scene>()>;
+
+// all lessons in order, new scene object for every run
+static std::vector<SceneFactory> lessonScenes()
+{
+    return {
+        [] { return std::unique_ptr<Scene>(new ColorsScene); },
+        [] { return std::unique_ptr<Scene>(new BasicsScene); },
+        [] { return std::unique_ptr<Scene>(new MaterialsScene); },
+        [] { return std::unique_ptr<Scene>(new LightingMapsScene); },
+        [] { return std::unique_ptr<Scene>(new MultipleLightsScene); },
+    };
+}
+
+struct Resolution
+{
+    int width;
+    int height;
+};
+
+struct Run
+{
+    std::string lesson;
+    Resolution resolution;
+    //! @brief Scene::create() time and time until all its textures are uploaded
+    double createMs{0.0};
+    double texturesMs{0.0};
+    //! @brief Texel data of the scene textures
+    size_t textureBytes{0};
+    std::vector<Profiler::ZoneStats> zones;
+};
+
+// pass lesson options to scene, mark options the scene knows in used
+static void applyOptions(Scene & scene, std::vector<std::string> const & options, std::vector<bool> * used = nullptr)
+{
+    std::vector<char *> argv;
+    for (std::string const & option : options)
+        argv.push_back(const_cast<char *>(option.c_str()));
+
+    for (int i = 0; i < int(argv.size()); ++i)
+    {
+        int first = i;
+        if (scene.parseArgument(int(argv.size()), argv.data(), i) && used)
+        {
+            for (int j = first; j <= i; ++j)
+                (*used)[j] = true;
+        }
+    }
+}
+
+static double elapsedMs(bench_clock::time_point start)
+{
+    return std::chrono::duration<double, std::milli>(bench_clock::now() - start).count();
+}
+
+// Warm-up and measured frames of one scene, fills startup times and stats of all zones (milliseconds)
+static void measure(Scene & scene, TextureLoader & textureLoader, OffscreenTarget const & target,
+                    int warmup, int frames, Run & run)
+{
+    Profiler profiler;
+    int presentZone = profiler.zone("present");
+    int texturesZone = profiler.zone("texture upload");
+
+    target.bind();
+    scene.setViewport(target.getWidth(), target.getHeight());
+    auto start = bench_clock::now();
+    if (!scene.create(profiler, textureLoader))
+        return;
+    run.createMs = elapsedMs(start);
+
+    // profiler is disabled during warm-up: zone calls are ignored
+    for (int frame = 0; frame < warmup + frames; ++frame)
+    {
+        if (frame == warmup)
+        {
+            // measured frames draw final textures
+            textureLoader.finish();
+            profiler.enable();
+        }
+        scene.setTime(float(frame) * DELTA_TIME, frame == 0 ? 0.0f : DELTA_TIME);
+
+        profiler.beginFrame();
+        {
+            ProfileZone zone(profiler, texturesZone);
+            textureLoader.update();
+        }
+        if (run.texturesMs == 0.0 && textureLoader.pending() == 0)
+            run.texturesMs = elapsedMs(start);
+        scene.render();
+        {
+            ProfileZone zone(profiler, presentZone);
+            glFinish();
+        }
+        profiler.endFrame();
+    }
+
+    for (TextureHandle::Info const & info : textureLoader.memory())
+        run.textureBytes += info.bytes;
+    run.zones = profiler.summary();
+    profiler.reset();
+    scene.destroy();
+}
+
+static bool parseResolution(std::string const & value, Resolution & resolution)
+{
+    return std::sscanf(value.c_str(), "%dx%d", &resolution.width, &resolution.height) == 2
+        && resolution.width > 0 && resolution.height > 0;
+}
+
+static bool writeReport(std::string const & path, std::string const & renderer, int warmup, int frames,
+                        std::vector<Run> const & runs)
+{
+    std::ofstream file(path);
+    file << "{\n  \"renderer\": \"" << Profiler::jsonEscape(renderer) << "\",\n  \"warmup\": " << warmup << ",\n  \"frames\": " << frames
+         << ",\n  \"unit\": \"ms\",\n  \"runs\": [";
+    for (size_t r = 0; r < runs.size(); ++r)
+    {
+        Run const & run = runs[r];
+        file << (r == 0 ? "\n" : ",\n") << "    {\"lesson\": \"" << Profiler::jsonEscape(run.lesson) << "\", \"width\": " << run.resolution.width
+             << ", \"height\": " << run.resolution.height << ", \"createMs\": " << run.createMs
+             << ", \"texturesMs\": " << run.texturesMs << ", \"textureBytes\": " << run.textureBytes
+             << ", \"zones\": [";
+        for (size_t i = 0; i < run.zones.size(); ++i)
+        {
+            Profiler::Stats const & s = run.zones[i].stats;
+            file << (i == 0 ? "\n" : ",\n") << "      {\"name\": \"" << Profiler::jsonEscape(run.zones[i].name) << "\", \"side\": \"" << run.zones[i].side
+                 << "\", \"samples\": " << s.count << ", \"mean\": " << s.mean << ", \"p50\": " << s.p50
+                 << ", \"p95\": " << s.p95 << ", \"p99\": " << s.p99 << ", \"max\": " << s.max << "}";
+        }
+        file << "\n    ]}";
+    }
+    file << "\n  ]\n}\n";
+
+    if (!file)
+    {
+        std::cerr << "ERROR::LESSON_BENCH::FILE_NOT_SUCCESFULLY_WRITTEN " << path << std::endl;
+        return false;
+    }
+    return true;
+}
+
+// ===========================================================
+int main(int argc, char ** argv)
+{
+    int warmup = 30;
+    int frames = 300;
+    std::vector<Resolution> resolutions;
+    std::vector<std::string> lessons;
+    std::string reportPath;
+    // everything else is an option of the lesson scenes
+    std::vector<std::string> sceneOptions;
+
+    for (int i = 1; i < argc; ++i)
+    {
+        std::string arg = argv[i];
+        bool hasValue = i + 1 < argc;
+        if (arg == "--warmup" && hasValue)
+        {
+            warmup = std::atoi(argv[++i]);
+        }
+        else if (arg == "--frames" && hasValue)
+        {
+            frames = std::atoi(argv[++i]);
+        }
+        else if (arg == "--resolution" && hasValue)
+        {
+            Resolution resolution;
+            if (!parseResolution(argv[++i], resolution))
+            {
+                std::cerr << "ERROR::LESSON_BENCH::BAD_RESOLUTION " << argv[i] << " (expected WxH)" << std::endl;
+                return -1;
+            }
+            resolutions.push_back(resolution);
+        }
+        else if (arg == "--lesson" && hasValue)
+        {
+            lessons.push_back(argv[++i]);
+        }
+        else if (arg == "--report" && hasValue)
+        {
+            reportPath = argv[++i];
+        }
+        else
+        {
+            sceneOptions.push_back(arg);
+        }
+    }
+    if (resolutions.empty())
+        resolutions.push_back(Resolution{800, 600});
+    if (frames < 1)
+        frames = 1;
+
+    // lessons to run and check that each option is known to some of them
+    std::vector<SceneFactory> factories;
+    std::vector<bool> usedOptions(sceneOptions.size(), false);
+    for (SceneFactory const & factory : lessonScenes())
+    {
+        std::unique_ptr<Scene> scene = factory();
+        applyOptions(*scene, sceneOptions, &usedOptions);
+        bool selected = lessons.empty();
+        for (std::string const & lesson : lessons)
+            selected = selected || lesson == scene->name();
+        if (selected)
+            factories.push_back(factory);
+    }
+    // a mistyped option would silently measure other settings than asked for
+    bool unknownOptions = false;
+    for (size_t i = 0; i < sceneOptions.size(); ++i)
+    {
+        if (!usedOptions[i])
+        {
+            std::cerr << "Unknown argument: " << sceneOptions[i] << std::endl;
+            unknownOptions = true;
+        }
+    }
+    if (unknownOptions)
+    {
+        std::cerr << "ERROR::LESSON_BENCH::UNKNOWN_ARGUMENTS" << std::endl;
+        return -1;
+    }
+    if (factories.empty())
+    {
+        std::cerr << "ERROR::LESSON_BENCH::NO_LESSON_SELECTED" << std::endl;
+        return -1;
+    }
+
+    HeadlessContext context;
+    if (!context.create())
+        return -1;
+    std::string renderer = reinterpret_cast<char const *>(glGetString(GL_RENDERER));
+    // lessons read shaders and textures from the asset pack of the build (loose files without it)
+    AssetPack::mounted().open(AssetPack::FILE_DEFAULT);
+    TextureLoader textureLoader;
+    textureLoader.create();
+    std::cout << "Renderer: " << renderer << ", " << warmup << " warm-up + " << frames << " measured frames" << std::endl;
+
+    std::vector<Run> runs;
+    for (Resolution const & resolution : resolutions)
+    {
+        OffscreenTarget target;
+        if (!target.create(resolution.width, resolution.height))
+        {
+            textureLoader.destroy();
+            context.destroy();
+            return -1;
+        }
+        for (SceneFactory const & factory : factories)
+        {
+            std::unique_ptr<Scene> scene = factory();
+            applyOptions(*scene, sceneOptions);
+            Run run{scene->name(), resolution};
+            measure(*scene, textureLoader, target, warmup, frames, run);
+            if (run.zones.empty())
+            {
+                std::cerr << "ERROR::LESSON_BENCH::SCENE_NOT_CREATED " << run.lesson << std::endl;
+                continue;
+            }
+
+            std::printf("\n%s %dx%d: create %.1f ms, textures ready %.1f ms, %.1f KiB\n", run.lesson.c_str(),
+                        resolution.width, resolution.height, run.createMs, run.texturesMs, double(run.textureBytes) / 1024.0);
+            std::printf("%-16s %-4s %9s %9s %9s %9s %9s\n", "zone", "", "mean ms", "p50", "p95", "p99", "max");
+            for (Profiler::ZoneStats const & z : run.zones)
+            {
+                Profiler::Stats const & s = z.stats;
+                if (s.count > 0)
+                    std::printf("%-16s %-4s %9.3f %9.3f %9.3f %9.3f %9.3f\n", z.name.c_str(), z.side.c_str(), s.mean, s.p50, s.p95, s.p99, s.max);
+            }
+            runs.push_back(std::move(run));
+        }
+        target.destroy();
+    }
+
+    textureLoader.destroy();
+    context.destroy();
+    if (!reportPath.empty() && !writeReport(reportPath, renderer, warmup, frames, runs))
+        return -1;
+    return 0;
+}
@@ -0,0 +1,213 @@
+#version 330 core
+// fragment_bench: lesson 5 object.fs before the surface struct (maps are sampled again in every light function)
+// std140 layout of MaterialData of utils/uniform_blocks.hpp
+struct Material {
+   int diffuseLayer;
+   int specularLayer;   // -1: no specular map, constant specular
+   float specular;
+   float shininess;
+};
+
+// light structs follow std140 layout of utils/uniform_blocks.hpp: every vec3 is paired with a float
+struct DirLight {
+   vec3 direction;
+
+   vec3 ambient;
+   vec3 diffuse;
+   vec3 specular;
+};
+
+struct PointLight {
+   vec3 position;
+   float constant;
+
+   vec3 ambient;
+   float linear;
+   vec3 diffuse;
+   float quadratic;
+   vec3 specular;
+};
+
+struct SpotLight {
+    vec3 position;
+    float cutOff;
+    vec3 direction;
+    float outerCutOff;
+
+    vec3 ambient;
+    float constant;
+    vec3 diffuse;
+    float linear;
+    vec3 specular;
+    float quadratic;
+};
+
+#define NR_POINT_LIGHTS 4
+#define NR_MATERIALS 3
+
+// variant of the program (defines of the scene, everything on without them):
+// lights in use are the first POINT_LIGHT_COUNT ones, features that are off have no code at all
+#ifndef POINT_LIGHT_COUNT
+#define POINT_LIGHT_COUNT NR_POINT_LIGHTS
+#endif
+#ifndef SPOT_LIGHT
+#define SPOT_LIGHT 1
+#endif
+#ifndef EMISSION
+#define EMISSION 1
+#endif
+
+vec3 CalcDirLight(DirLight light, vec3 normal, vec3 viewDir);
+vec3 CalcPointLight(PointLight light, vec3 normal, vec3 fragPos, vec3 viewDir);
+vec3 CalcSpotLight(SpotLight light, vec3 normal, vec3 fragPos, vec3 viewDir);
+
+// input parameters (from fragment shader)
+in vec3 Normal;
+in vec3 FragPos;
+in vec2 TexCoords;
+flat in uint MaterialID;
+
+// uniform blocks (are shared between programs and uploaded once per frame)
+layout (std140) uniform PerFrame
+{
+   mat4 projection;
+   mat4 view;
+   vec3 viewPos;
+};
+
+layout (std140) uniform Lights
+{
+   DirLight dirLight;
+   PointLight pointLights[NR_POINT_LIGHTS];
+   SpotLight spotLight;
+};
+
+layout (std140) uniform Materials
+{
+   Material materials[NR_MATERIALS];
+};
+
+// uniform parameters (is set in main): maps of all materials, layer is selected by material
+uniform sampler2DArray diffuseMaps;
+uniform sampler2DArray specularMaps;  // gray masks, red channel only (single channel texture)
+uniform sampler2D emissionMap;
+
+uniform float textShift;
+uniform float textGlow;
+
+// out parameter
+out vec4 FragColor;
+
+// material of the instance (set in main)
+Material material;
+
+vec3 diffuseTexel()
+{
+   return texture(diffuseMaps, vec3(TexCoords, material.diffuseLayer)).rgb;
+}
+
+vec3 specularTexel()
+{
+   if (material.specularLayer < 0)
+      return vec3(material.specular);
+   return vec3(texture(specularMaps, vec3(TexCoords, material.specularLayer)).r);
+}
+
+void main()
+{   
+   material = materials[MaterialID];
+   // properties
+   vec3 norm = normalize(Normal);
+   vec3 viewDir = normalize(viewPos - FragPos);
+
+   vec3 result = vec3(0.0);
+   // phase 1: Directional lighting
+   result += CalcDirLight(dirLight, norm, viewDir);
+   // phase 2: Point lights
+   for (int i = 0; i < POINT_LIGHT_COUNT; ++i)
+      result += CalcPointLight(pointLights[i], norm, FragPos, viewDir);
+#if SPOT_LIGHT
+   // phase 3: spot light
+   result += CalcSpotLight(spotLight, norm, FragPos, viewDir);
+#endif
+
+#if EMISSION
+   // phase 4: emission part (where specular map is black)
+   vec3 emission = vec3(0.0);
+   if (material.specularLayer >= 0 && specularTexel().r == 0.0)
+   {
+      emission = texture(emissionMap, TexCoords + vec2(0.0, textShift)).rgb;
+      result += emission * textGlow;
+   }
+#endif
+   FragColor = vec4(result, 1.0);
+}
+
+vec3 CalcDirLight(DirLight light, vec3 normal, vec3 viewDir)
+{
+   vec3 lightDir = normalize(-light.direction);
+   // diffuse shading
+   float diff = max(dot(normal, lightDir), 0.0);
+   // specular shading
+   vec3 reflectDir = reflect(-lightDir, normal);
+   float spec = pow(max(dot(viewDir, reflectDir), 0.0), material.shininess);
+   // combine results
+   vec3 ambient  = light.ambient  * diffuseTexel();
+   vec3 diffuse  = light.diffuse  * diff * diffuseTexel();
+   vec3 specular = light.specular * spec * specularTexel();
+   return (ambient + diffuse + specular);
+}
+
+vec3 CalcPointLight(PointLight light, vec3 normal, vec3 fragPos, vec3 viewDir)
+{
+   vec3 lightDir = normalize(light.position - fragPos);
+   // diffuse shading
+   float diff = max(dot(normal, lightDir), 0.0);
+   // specular shading
+   vec3 reflectDir = reflect(-lightDir, normal);
+   float spec = pow(max(dot(viewDir, reflectDir), 0.0), material.shininess);
+   // attenuation 
+   float distance = length(light.position - fragPos);
+   float attenuation = 1.0 / (light.constant + light.linear * distance + light.quadratic * (distance * distance));
+   // combine results
+   vec3 ambient  = light.ambient  * diffuseTexel();
+   vec3 diffuse  = light.diffuse  * diff * diffuseTexel();
+   vec3 specular = light.specular * spec * specularTexel();
+
+   ambient *= attenuation;
+   diffuse *= attenuation;
+   specular *= attenuation;
+
+   return (ambient + diffuse + specular);
+}
+
+// calculates the color when using a spot light.
+vec3 CalcSpotLight(SpotLight light, vec3 normal, vec3 fragPos, vec3 viewDir)
+{
+   vec3 lightDir = normalize(light.position - fragPos);
+   // diffuse shading
+   float diff = max(dot(normal, lightDir), 0.0);
+   // specular shading
+   vec3 reflectDir = reflect(-lightDir, normal);
+   float spec = pow(max(dot(viewDir, reflectDir), 0.0), material.shininess);
+
+   // attenuation
+   float distance = length(light.position - fragPos);
+   float attenuation = 1.0 / (light.constant + light.linear * distance + light.quadratic * (distance * distance));    
+
+   // spotlight intensity
+   float theta = dot(lightDir, normalize(-light.direction)); 
+   float epsilon = light.cutOff - light.outerCutOff;
+   float intensity = clamp((theta - light.outerCutOff) / epsilon, 0.0, 1.0);
+
+   // combine results
+   vec3 ambient = light.ambient * diffuseTexel();
+   vec3 diffuse = light.diffuse * diff * diffuseTexel();
+   vec3 specular = light.specular * spec * specularTexel();
+
+   ambient *= attenuation * intensity;
+   diffuse *= attenuation * intensity;
+   specular *= attenuation * intensity;
+
+   return (ambient + diffuse + specular);
+}
@@ -0,0 +1,10 @@
+#version 330 core
+
+uniform vec3 color;
+
+out vec4 FragColor;
+
+void main()
+{
+   FragColor = vec4(color, 1.0); // set all 4 vector values to 1.0
+}
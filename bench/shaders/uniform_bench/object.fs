@@ -0,0 +1,161 @@
+#version 330 core
+struct Material {
+   sampler2D diffuse;
+   sampler2D specular;
+   sampler2D emission;
+   float shininess;
+};
+
+struct DirLight {
+   vec3 direction;
+
+   vec3 ambient;
+   vec3 diffuse;
+   vec3 specular;
+};
+
+struct PointLight {
+   vec3 position;
+
+   float constant;
+   float linear;
+   float quadratic;
+
+   vec3 ambient;
+   vec3 diffuse;
+   vec3 specular;
+};
+
+struct SpotLight {
+    vec3 position;
+    vec3 direction;
+    float cutOff;
+    float outerCutOff;
+  
+    float constant;
+    float linear;
+    float quadratic;
+  
+    vec3 ambient;
+    vec3 diffuse;
+    vec3 specular;
+};
+
+#define NR_POINT_LIGHTS 4
+
+vec3 CalcDirLight(DirLight light, vec3 normal, vec3 viewDir);
+vec3 CalcPointLight(PointLight light, vec3 normal, vec3 fragPos, vec3 viewDir);
+vec3 CalcSpotLight(SpotLight light, vec3 normal, vec3 fragPos, vec3 viewDir);
+
+// input parameters (from fragment shader)
+in vec3 Normal;
+in vec3 FragPos;
+in vec2 TexCoords;
+
+// uniform parameters (is set in main)
+uniform Material material;
+uniform DirLight dirLight;
+uniform PointLight pointLights[NR_POINT_LIGHTS];
+uniform SpotLight spotLight;
+
+uniform vec3 viewPos;
+
+uniform float textShift;
+uniform float textGlow;
+
+// out parameter
+out vec4 FragColor;
+
+void main()
+{   
+   // properties
+   vec3 norm = normalize(Normal);
+   vec3 viewDir = normalize(viewPos - FragPos);
+
+   vec3 result = vec3(0.0);
+   // phase 1: Directional lighting
+   result += CalcDirLight(dirLight, norm, viewDir);
+   // phase 2: Point lights
+   for (int i = 0; i < NR_POINT_LIGHTS; ++i)
+      result += CalcPointLight(pointLights[i], norm, FragPos, viewDir);
+   // phase 3: spot light
+   result += CalcSpotLight(spotLight, norm, FragPos, viewDir);
+
+   // phase 4: emission part
+   vec3 emission = vec3(0.0);
+   if (texture(material.specular, TexCoords).r == 0.0)
+   {
+      emission = texture(material.emission, TexCoords + vec2(0.0, textShift)).rgb;
+      result += emission * textGlow;
+   }
+   FragColor = vec4(result, 1.0);
+}
+
+vec3 CalcDirLight(DirLight light, vec3 normal, vec3 viewDir)
+{
+   vec3 lightDir = normalize(-light.direction);
+   // diffuse shading
+   float diff = max(dot(normal, lightDir), 0.0);
+   // specular shading
+   vec3 reflectDir = reflect(-lightDir, normal);
+   float spec = pow(max(dot(viewDir, reflectDir), 0.0), material.shininess);
+   // combine results
+   vec3 ambient  = light.ambient  * vec3(texture(material.diffuse, TexCoords));
+   vec3 diffuse  = light.diffuse  * diff * vec3(texture(material.diffuse, TexCoords));
+   vec3 specular = light.specular * spec * vec3(texture(material.specular, TexCoords));
+   return (ambient + diffuse + specular);
+}
+
+vec3 CalcPointLight(PointLight light, vec3 normal, vec3 fragPos, vec3 viewDir)
+{
+   vec3 lightDir = normalize(light.position - fragPos);
+   // diffuse shading
+   float diff = max(dot(normal, lightDir), 0.0);
+   // specular shading
+   vec3 reflectDir = reflect(-lightDir, normal);
+   float spec = pow(max(dot(viewDir, reflectDir), 0.0), material.shininess);
+   // attenuation 
+   float distance = length(light.position - fragPos);
+   float attenuation = 1.0 / (light.constant + light.linear * distance + light.quadratic * (distance * distance));
+   // combine results
+   vec3 ambient  = light.ambient  * vec3(texture(material.diffuse, TexCoords));
+   vec3 diffuse  = light.diffuse  * diff * vec3(texture(material.diffuse, TexCoords));
+   vec3 specular = light.specular * spec * vec3(texture(material.specular, TexCoords));
+
+   ambient *= attenuation;
+   diffuse *= attenuation;
+   specular *= attenuation;
+
+   return (ambient + diffuse + specular);
+}
+
+// calculates the color when using a spot light.
+vec3 CalcSpotLight(SpotLight light, vec3 normal, vec3 fragPos, vec3 viewDir)
+{
+   vec3 lightDir = normalize(light.position - fragPos);
+   // diffuse shading
+   float diff = max(dot(normal, lightDir), 0.0);
+   // specular shading
+   vec3 reflectDir = reflect(-lightDir, normal);
+   float spec = pow(max(dot(viewDir, reflectDir), 0.0), material.shininess);
+
+   // attenuation
+   float distance = length(light.position - fragPos);
+   float attenuation = 1.0 / (light.constant + light.linear * distance + light.quadratic * (distance * distance));    
+
+   // spotlight intensity
+   float theta = dot(lightDir, normalize(-light.direction)); 
+   float epsilon = light.cutOff - light.outerCutOff;
+   float intensity = clamp((theta - light.outerCutOff) / epsilon, 0.0, 1.0);
+
+   // combine results
+   vec3 ambient = light.ambient * vec3(texture(material.diffuse, TexCoords));
+   vec3 diffuse = light.diffuse * diff * vec3(texture(material.diffuse, TexCoords));
+   vec3 specular = light.specular * spec * vec3(texture(material.specular, TexCoords));
+
+   ambient *= attenuation * intensity;
+   diffuse *= attenuation * intensity;
+   specular *= attenuation * intensity;
+
+   return (ambient + diffuse + specular);
+}
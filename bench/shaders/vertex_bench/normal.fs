@@ -0,0 +1,13 @@
+#version 330 core
+
+// cheap shading, so frame time is dominated by vertex work
+in vec3 Normal;
+in vec3 FragPos;
+in vec2 TexCoords;
+
+out vec4 FragColor;
+
+void main()
+{
+   FragColor = vec4(normalize(Normal) * 0.5 + 0.5, 1.0);
+}
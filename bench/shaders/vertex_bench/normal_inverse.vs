@@ -0,0 +1,26 @@
+#version 330 core
+
+layout (location = 0) in vec3 aPos;
+layout (location = 1) in vec3 aNormal;
+layout (location = 2) in vec2 aTexCoords;
+// per instance, normal matrix is derived per vertex (lesson 5 before per-instance normal matrices)
+layout (location = 3) in mat4 aModel;
+
+layout (std140) uniform PerFrame
+{
+   mat4 projection;
+   mat4 view;
+   vec3 viewPos;
+};
+
+out vec3 Normal;
+out vec3 FragPos;
+out vec2 TexCoords;
+
+void main()
+{
+   gl_Position = projection * view * aModel * vec4(aPos, 1.0);
+   FragPos = vec3(aModel * vec4(aPos, 1.0));
+   Normal = mat3(transpose(inverse(aModel))) * aNormal;
+   TexCoords = aTexCoords;
+}
@@ -0,0 +1,595 @@
+// Micro-benchmark of per-frame uniform upload of the "05_multiple-lights" scene in a headless context.
+// Compares five ways to feed the same uniforms:
+//   legacy  - glGetUniformLocation on every set call (old Shader behaviour)
+//   name    - Shader setters by name, resolved through the uniform table
+//   struct  - Shader setters by name, point lights through Shader::structArray
+//   handle  - Shader setters by pre-resolved UniformHandle
+//   ubo     - PerFrame and Lights uniform blocks uploaded once per frame (as in lesson 5)
+// First four modes use a copy of lesson 5 shaders with loose uniforms (bench/shaders).
+// Steady state of "struct", "handle" and "ubo" must not touch the heap, the run fails otherwise.
+#include "glad/glad.h"
+
+#include <glm/glm.hpp>
+#include <glm/gtc/matrix_transform.hpp>
+#include <glm/gtc/type_ptr.hpp>
+
+#include "utils/shader.hpp"
+#include "utils/shader_library.hpp"
+#include "utils/uniform_blocks.hpp"
+#include "utils/uniform_buffer.hpp"
+#include "utils/instance_buffer.hpp"
+#include "utils/headless_context.hpp"
+#include "utils/offscreen_target.hpp"
+#include "05_multiple-lights/cube_vertices.hpp"
+#include "alloc_counter.hpp"
+
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+// =============================================
+
+static const std::string LESSON_DIR = "05_multiple-lights";
+// NR_MATERIALS of lesson 5 object shader
+static const size_t MATERIALS = 3;
+static const std::string BENCH_DIR = "uniform_bench";
+
+static const unsigned int SCR_WIDTH = 800;
+static const unsigned int SCR_HEIGHT = 600;
+// small target: the measured CPU side does not depend on it, draws and glFinish of llvmpipe stay cheap
+static const int TARGET_SIZE = 128;
+
+static const std::array cubePos = {
+    glm::vec3( 0.0f,  0.0f,  0.0f),
+    glm::vec3( 2.0f,  5.0f, -15.0f),
+    glm::vec3(-1.5f, -2.2f, -2.5f),
+    glm::vec3(-3.8f, -2.0f, -12.5f),
+    glm::vec3( 2.4f, -0.4f, -3.5f),
+    glm::vec3(-1.7f,  3.0f, -7.5f),
+    glm::vec3( 1.3f, -2.0f, -2.5f),
+    glm::vec3( 1.5f,  2.0f, -2.5f),
+    glm::vec3( 1.5f,  0.2f, -1.5f),
+    glm::vec3(-1.3f,  1.0f, -1.5f),
+};
+
+static const std::array pointLightsPos = {
+    glm::vec3( 0.7f,  0.2f,  2.0f),
+    glm::vec3( 2.3f, -3.3f, -4.0f),
+    glm::vec3(-4.0f,  2.0f, -12.0f),
+    glm::vec3( 0.0f,  0.0f,  -3.0f),
+};
+
+// Per-frame input of the scene
+struct Frame
+{
+    float time{0.0f};
+    glm::mat4 projection{1.0f};
+    glm::mat4 view{1.0f};
+    glm::vec3 cameraPos{0.0f, 0.0f, 3.0f};
+    glm::vec3 cameraFront{0.0f, 0.0f, -1.0f};
+};
+
+// Old Shader behaviour: one driver round trip per set call
+struct LegacyShader
+{
+    unsigned int ID{0};
+
+    void setInt(std::string const & name, int value) const { glUniform1i(glGetUniformLocation(ID, name.c_str()), value); }
+    void setFloat(std::string const & name, float value) const { glUniform1f(glGetUniformLocation(ID, name.c_str()), value); }
+    void setVec3(std::string const & name, glm::vec3 const & value) const { glUniform3fv(glGetUniformLocation(ID, name.c_str()), 1, glm::value_ptr(value)); }
+    void setVec3(std::string const & name, float x, float y, float z) const { glUniform3f(glGetUniformLocation(ID, name.c_str()), x, y, z); }
+    void setMat4(std::string const & name, glm::mat4 const & value) const { glUniformMatrix4fv(glGetUniformLocation(ID, name.c_str()), 1, GL_FALSE, glm::value_ptr(value)); }
+};
+
+// Uniforms of lesson 5 resolved once
+struct SceneHandles
+{
+    UniformHandle lightProjection, lightView, lightColor, lightModel;
+
+    UniformHandle materialDiffuse, materialSpecular, materialEmission, materialShininess;
+    UniformHandle dirDirection, dirAmbient, dirDiffuse, dirSpecular;
+    UniformHandle textShift, textGlow;
+    struct Point { UniformHandle position, constant, linear, quadratic, ambient, diffuse, specular; };
+    std::array<Point, pointLightsPos.size()> points;
+    UniformHandle spotPosition, spotDirection, spotCutOff, spotOuterCutOff;
+    UniformHandle spotConstant, spotLinear, spotQuadratic;
+    UniformHandle spotAmbient, spotDiffuse, spotSpecular;
+    UniformHandle viewPos, projection, view, model;
+
+    SceneHandles(Shader const & object, Shader const & lighting)
+    {
+        lightProjection = lighting.uniform("projection");
+        lightView = lighting.uniform("view");
+        lightColor = lighting.uniform("color");
+        lightModel = lighting.uniform("model");
+
+        materialDiffuse = object.uniform("material.diffuse");
+        materialSpecular = object.uniform("material.specular");
+        materialEmission = object.uniform("material.emission");
+        materialShininess = object.uniform("material.shininess");
+        dirDirection = object.uniform("dirLight.direction");
+        dirAmbient = object.uniform("dirLight.ambient");
+        dirDiffuse = object.uniform("dirLight.diffuse");
+        dirSpecular = object.uniform("dirLight.specular");
+        textShift = object.uniform("textShift");
+        textGlow = object.uniform("textGlow");
+        for (size_t i = 0; i < points.size(); ++i)
+        {
+            std::string prefix = "pointLights[" + std::to_string(i) + "].";
+            points[i].position = object.uniform(prefix + "position");
+            points[i].constant = object.uniform(prefix + "constant");
+            points[i].linear = object.uniform(prefix + "linear");
+            points[i].quadratic = object.uniform(prefix + "quadratic");
+            points[i].ambient = object.uniform(prefix + "ambient");
+            points[i].diffuse = object.uniform(prefix + "diffuse");
+            points[i].specular = object.uniform(prefix + "specular");
+        }
+        spotPosition = object.uniform("spotLight.position");
+        spotDirection = object.uniform("spotLight.direction");
+        spotCutOff = object.uniform("spotLight.cutOff");
+        spotOuterCutOff = object.uniform("spotLight.outerCutOff");
+        spotConstant = object.uniform("spotLight.constant");
+        spotLinear = object.uniform("spotLight.linear");
+        spotQuadratic = object.uniform("spotLight.quadratic");
+        spotAmbient = object.uniform("spotLight.ambient");
+        spotDiffuse = object.uniform("spotLight.diffuse");
+        spotSpecular = object.uniform("spotLight.specular");
+        viewPos = object.uniform("viewPos");
+        projection = object.uniform("projection");
+        view = object.uniform("view");
+        model = object.uniform("model");
+    }
+};
+
+// Point light uniforms as in lesson 5 before struct arrays: names built per frame
+template <typename ShaderT>
+void uploadPointLightsByPrefix(ShaderT const & objectShader, glm::vec3 const & ambientColor, glm::vec3 const & diffuseColor)
+{
+    for (uint8_t i = 0; i < pointLightsPos.size(); ++i)
+    {
+        std::ostringstream oss;
+        oss << "pointLights[" << char('0' + i) <<  "].";
+        std::string prefix = oss.str();
+
+        objectShader.setVec3(prefix + "position", pointLightsPos[i]);
+        objectShader.setFloat(prefix + "constant", 1.0f);
+        objectShader.setFloat(prefix + "linear", 0.09f);
+        objectShader.setFloat(prefix + "quadratic", 0.032f);
+        objectShader.setVec3(prefix + "ambient", ambientColor);
+        objectShader.setVec3(prefix + "diffuse", diffuseColor);
+        objectShader.setVec3(prefix + "specular", glm::vec3(1.0f));
+    }
+}
+
+// Same work as the render loop of lesson 5, uniforms set by name
+template <typename ShaderT, typename PointLightsFn>
+void renderByName(ShaderT const & objectShader, ShaderT const & lightingShader,
+    unsigned int VAO, unsigned int lightVAO, Frame const & f, PointLightsFn && uploadPointLights)
+{
+    glm::vec3 lightColor(1.0f);
+    glUseProgram(lightingShader.ID);
+    lightingShader.setMat4("projection", f.projection);
+    lightingShader.setMat4("view", f.view);
+    lightingShader.setVec3("color", lightColor);
+    glBindVertexArray(lightVAO);
+    for (auto const & pos : pointLightsPos)
+    {
+        glm::mat4 model = glm::scale(glm::translate(glm::mat4(1.0f), pos), glm::vec3(0.1f));
+        lightingShader.setMat4("model", model);
+        glDrawArrays(GL_TRIANGLES, 0, 36);
+    }
+
+    glUseProgram(objectShader.ID);
+    objectShader.setInt("material.diffuse", 0);
+    objectShader.setInt("material.specular", 1);
+    objectShader.setInt("material.emission", 2);
+    objectShader.setFloat("material.shininess", 64.0f);
+
+    glm::vec3 ambientColor = lightColor * glm::vec3(0.2f);
+    glm::vec3 diffuseColor = lightColor * glm::vec3(0.5f);
+    float amplitude = std::max(std::abs(std::cos(glm::radians(f.time * 10))), 0.1f);
+
+    objectShader.setVec3("dirLight.direction", -0.2f, -1.0f, -0.3f);
+    objectShader.setVec3("dirLight.ambient", ambientColor * amplitude);
+    objectShader.setVec3("dirLight.diffuse", diffuseColor * amplitude);
+    objectShader.setVec3("dirLight.specular", glm::vec3(1.0f) * amplitude);
+    objectShader.setFloat("textShift", f.time / 3.0f);
+    objectShader.setFloat("textGlow", 0.0f);
+
+    uploadPointLights(ambientColor, diffuseColor);
+
+    objectShader.setVec3("spotLight.position", f.cameraPos);
+    objectShader.setVec3("spotLight.direction", f.cameraFront);
+    objectShader.setFloat("spotLight.cutOff", glm::cos(glm::radians(12.5f)));
+    objectShader.setFloat("spotLight.outerCutOff", glm::cos(glm::radians(18.0f)));
+    objectShader.setFloat("spotLight.constant", 1.0f);
+    objectShader.setFloat("spotLight.linear", 0.09f);
+    objectShader.setFloat("spotLight.quadratic", 0.032f);
+    objectShader.setVec3("spotLight.ambient", glm::vec3(0.1f));
+    objectShader.setVec3("spotLight.diffuse", glm::vec3(1.0f));
+    objectShader.setVec3("spotLight.specular", glm::vec3(1.0f));
+
+    objectShader.setVec3("viewPos", f.cameraPos);
+    objectShader.setMat4("projection", f.projection);
+    objectShader.setMat4("view", f.view);
+
+    glBindVertexArray(VAO);
+    for (unsigned int i = 0; i < cubePos.size(); i++)
+    {
+        glm::mat4 model = glm::translate(glm::mat4(1.0f), cubePos[i]);
+        float angle = f.time * 20.0f * (i % 3 + 1);
+        model = glm::rotate(model, glm::radians(angle), glm::vec3(1.0f, 0.3f, 0.5f));
+        objectShader.setMat4("model", model);
+        glDrawArrays(GL_TRIANGLES, 0, 36);
+    }
+}
+
+// Same work as the render loop of lesson 5, uniforms set by handle
+void renderByHandle(Shader const & objectShader, Shader const & lightingShader, SceneHandles const & h,
+    unsigned int VAO, unsigned int lightVAO, Frame const & f)
+{
+    glm::vec3 lightColor(1.0f);
+    lightingShader.use();
+    lightingShader.setMat4(h.lightProjection, f.projection);
+    lightingShader.setMat4(h.lightView, f.view);
+    lightingShader.setVec3(h.lightColor, lightColor);
+    glBindVertexArray(lightVAO);
+    for (auto const & pos : pointLightsPos)
+    {
+        glm::mat4 model = glm::scale(glm::translate(glm::mat4(1.0f), pos), glm::vec3(0.1f));
+        lightingShader.setMat4(h.lightModel, model);
+        glDrawArrays(GL_TRIANGLES, 0, 36);
+    }
+
+    objectShader.use();
+    objectShader.setInt(h.materialDiffuse, 0);
+    objectShader.setInt(h.materialSpecular, 1);
+    objectShader.setInt(h.materialEmission, 2);
+    objectShader.setFloat(h.materialShininess, 64.0f);
+
+    glm::vec3 ambientColor = lightColor * glm::vec3(0.2f);
+    glm::vec3 diffuseColor = lightColor * glm::vec3(0.5f);
+    float amplitude = std::max(std::abs(std::cos(glm::radians(f.time * 10))), 0.1f);
+
+    objectShader.setVec3(h.dirDirection, -0.2f, -1.0f, -0.3f);
+    objectShader.setVec3(h.dirAmbient, ambientColor * amplitude);
+    objectShader.setVec3(h.dirDiffuse, diffuseColor * amplitude);
+    objectShader.setVec3(h.dirSpecular, glm::vec3(1.0f) * amplitude);
+    objectShader.setFloat(h.textShift, f.time / 3.0f);
+    objectShader.setFloat(h.textGlow, 0.0f);
+
+    for (size_t i = 0; i < pointLightsPos.size(); ++i)
+    {
+        auto const & p = h.points[i];
+        objectShader.setVec3(p.position, pointLightsPos[i]);
+        objectShader.setFloat(p.constant, 1.0f);
+        objectShader.setFloat(p.linear, 0.09f);
+        objectShader.setFloat(p.quadratic, 0.032f);
+        objectShader.setVec3(p.ambient, ambientColor);
+        objectShader.setVec3(p.diffuse, diffuseColor);
+        objectShader.setVec3(p.specular, glm::vec3(1.0f));
+    }
+
+    objectShader.setVec3(h.spotPosition, f.cameraPos);
+    objectShader.setVec3(h.spotDirection, f.cameraFront);
+    objectShader.setFloat(h.spotCutOff, glm::cos(glm::radians(12.5f)));
+    objectShader.setFloat(h.spotOuterCutOff, glm::cos(glm::radians(18.0f)));
+    objectShader.setFloat(h.spotConstant, 1.0f);
+    objectShader.setFloat(h.spotLinear, 0.09f);
+    objectShader.setFloat(h.spotQuadratic, 0.032f);
+    objectShader.setVec3(h.spotAmbient, glm::vec3(0.1f));
+    objectShader.setVec3(h.spotDiffuse, glm::vec3(1.0f));
+    objectShader.setVec3(h.spotSpecular, glm::vec3(1.0f));
+
+    objectShader.setVec3(h.viewPos, f.cameraPos);
+    objectShader.setMat4(h.projection, f.projection);
+    objectShader.setMat4(h.view, f.view);
+
+    glBindVertexArray(VAO);
+    for (unsigned int i = 0; i < cubePos.size(); i++)
+    {
+        glm::mat4 model = glm::translate(glm::mat4(1.0f), cubePos[i]);
+        float angle = f.time * 20.0f * (i % 3 + 1);
+        model = glm::rotate(model, glm::radians(angle), glm::vec3(1.0f, 0.3f, 0.5f));
+        objectShader.setMat4(h.model, model);
+        glDrawArrays(GL_TRIANGLES, 0, 36);
+    }
+}
+
+// Lesson 5 shaders with uniform blocks
+struct UboScene
+{
+    Shader const & objectShader;
+    Shader const & lightingShader;
+    UniformBuffer<PerFrameBlock> const & perFrameBuffer;
+    UniformBuffer<LightsBlock<pointLightsPos.size()>> const & lightsBuffer;
+
+    UniformHandle lightColor;
+    UniformHandle diffuseMaps, specularMaps, emissionMap;
+    UniformHandle textShift, textGlow;
+
+    UboScene(Shader const & object, Shader const & lighting,
+        UniformBuffer<PerFrameBlock> const & perFrame, UniformBuffer<LightsBlock<pointLightsPos.size()>> const & lights)
+        : objectShader(object), lightingShader(lighting), perFrameBuffer(perFrame), lightsBuffer(lights)
+    {
+        lightColor = lighting.uniform("color");
+        diffuseMaps = object.uniform("diffuseMaps");
+        specularMaps = object.uniform("specularMaps");
+        emissionMap = object.uniform("emissionMap");
+        textShift = object.uniform("textShift");
+        textGlow = object.uniform("textGlow");
+    }
+};
+
+// Same work as the render loop of lesson 5, cameras and lights in uniform blocks
+// (model matrix is a per-draw constant vertex attribute, as in lesson 5 without instancing)
+void renderByUbo(UboScene const & s, unsigned int VAO, unsigned int lightVAO, Frame const & f)
+{
+    PerFrameBlock perFrame;
+    perFrame.projection = f.projection;
+    perFrame.view = f.view;
+    perFrame.viewPos = f.cameraPos;
+    s.perFrameBuffer.upload(perFrame);
+
+    glm::vec3 lightColor(1.0f);
+    s.lightingShader.use();
+    s.lightingShader.setVec3(s.lightColor, lightColor);
+    glBindVertexArray(lightVAO);
+    for (auto const & pos : pointLightsPos)
+    {
+        glm::mat4 model = glm::scale(glm::translate(glm::mat4(1.0f), pos), glm::vec3(0.1f));
+        InstanceBuffer::setCurrent(makeInstance(model));
+        glDrawArrays(GL_TRIANGLES, 0, 36);
+    }
+
+    // materials are in their own block, uploaded once (material ID attribute is 0 by default)
+    s.objectShader.use();
+    s.objectShader.setInt(s.diffuseMaps, 0);
+    s.objectShader.setInt(s.specularMaps, 1);
+    s.objectShader.setInt(s.emissionMap, 2);
+    s.objectShader.setFloat(s.textShift, f.time / 3.0f);
+    s.objectShader.setFloat(s.textGlow, 0.0f);
+
+    glm::vec3 ambientColor = lightColor * glm::vec3(0.2f);
+    glm::vec3 diffuseColor = lightColor * glm::vec3(0.5f);
+    float amplitude = std::max(std::abs(std::cos(glm::radians(f.time * 10))), 0.1f);
+
+    LightsBlock<pointLightsPos.size()> lights;
+    lights.dirLight.direction = glm::vec3(-0.2f, -1.0f, -0.3f);
+    lights.dirLight.ambient = ambientColor * amplitude;
+    lights.dirLight.diffuse = diffuseColor * amplitude;
+    lights.dirLight.specular = glm::vec3(1.0f) * amplitude;
+    for (size_t i = 0; i < pointLightsPos.size(); ++i)
+    {
+        PointLightData & p = lights.pointLights[i];
+        p.position = pointLightsPos[i];
+        p.constant = 1.0f;
+        p.linear = 0.09f;
+        p.quadratic = 0.032f;
+        p.ambient = ambientColor;
+        p.diffuse = diffuseColor;
+        p.specular = glm::vec3(1.0f);
+    }
+    SpotLightData & spot = lights.spotLight;
+    spot.position = f.cameraPos;
+    spot.direction = f.cameraFront;
+    spot.cutOff = glm::cos(glm::radians(12.5f));
+    spot.outerCutOff = glm::cos(glm::radians(18.0f));
+    spot.constant = 1.0f;
+    spot.linear = 0.09f;
+    spot.quadratic = 0.032f;
+    spot.ambient = glm::vec3(0.1f);
+    spot.diffuse = glm::vec3(1.0f);
+    spot.specular = glm::vec3(1.0f);
+    s.lightsBuffer.upload(lights);
+
+    glBindVertexArray(VAO);
+    for (unsigned int i = 0; i < cubePos.size(); i++)
+    {
+        glm::mat4 model = glm::translate(glm::mat4(1.0f), cubePos[i]);
+        float angle = f.time * 20.0f * (i % 3 + 1);
+        model = glm::rotate(model, glm::radians(angle), glm::vec3(1.0f, 0.3f, 0.5f));
+        InstanceBuffer::setCurrent(makeInstance(model));
+        glDrawArrays(GL_TRIANGLES, 0, 36);
+    }
+}
+
+// Shader exposes program id only through getter, adapt it for renderByName
+struct NamedShader
+{
+    Shader const & shader;
+    unsigned int ID;
+
+    explicit NamedShader(Shader const & s) : shader(s), ID(s.getID()) {}
+
+    void setInt(std::string_view name, int value) const { shader.setInt(name, value); }
+    void setFloat(std::string_view name, float value) const { shader.setFloat(name, value); }
+    void setVec3(std::string_view name, glm::vec3 const & value) const { shader.setVec3(name, value); }
+    void setVec3(std::string_view name, float x, float y, float z) const { shader.setVec3(name, x, y, z); }
+    void setMat4(std::string_view name, glm::mat4 const & value) const { shader.setMat4(name, value); }
+};
+
+struct Stats
+{
+    double mean{0.0};
+    double p50{0.0};
+    double p95{0.0};
+    size_t allocations{0}; // heap allocations inside measured frames
+};
+
+template <typename RenderFn>
+Stats measure(RenderFn && render, int warmup, int frames)
+{
+    using clock = std::chrono::steady_clock;
+    Stats s;
+    std::vector<double> samples;
+    samples.reserve(size_t(frames));
+
+    for (int i = 0; i < warmup + frames; ++i)
+    {
+        Frame f;
+        f.time = float(i) / 60.0f;
+        f.projection = glm::perspective(glm::radians(45.0f), float(SCR_WIDTH) / float(SCR_HEIGHT), 0.1f, 100.0f);
+        f.view = glm::lookAt(f.cameraPos, f.cameraPos + f.cameraFront, glm::vec3(0.0f, 1.0f, 0.0f));
+
+        glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+        size_t allocationsBefore = AllocCounter::count();
+        auto start = clock::now();
+        render(f);
+        auto stop = clock::now();
+        size_t allocations = AllocCounter::count() - allocationsBefore;
+        // keep the driver queue from growing between samples
+        glFinish();
+
+        if (i >= warmup)
+        {
+            samples.push_back(std::chrono::duration<double, std::micro>(stop - start).count());
+            s.allocations += allocations;
+        }
+    }
+
+    for (double v : samples)
+        s.mean += v;
+    s.mean /= double(samples.size());
+    std::sort(samples.begin(), samples.end());
+    s.p50 = samples[samples.size() / 2];
+    s.p95 = samples[std::min(samples.size() - 1, samples.size() * 95 / 100)];
+    return s;
+}
+
+void report(char const * name, Stats const & s, Stats const & baseline)
+{
+    std::cout << name << ": mean " << s.mean << " us, p50 " << s.p50 << " us, p95 " << s.p95
+              << " us (x" << baseline.mean / s.mean << " vs legacy), "
+              << s.allocations << " allocations" << std::endl;
+}
+
+// ===========================================================
+int main(int argc, char ** argv)
+{
+    int frames = argc > 1 ? std::atoi(argv[1]) : 200;
+    int warmup = frames / 10;
+
+    HeadlessContext context;
+    if (!context.create())
+        return -1;
+
+    OffscreenTarget target;
+    if (!target.create(TARGET_SIZE, TARGET_SIZE))
+        return -1;
+    glEnable(GL_DEPTH_TEST);
+
+    ShaderLibrary shaders;
+    // loose uniforms
+    Shader objectShader, lightingShader;
+    std::string shaderPath = "shaders/" + BENCH_DIR + "/object";
+    shaders.add(objectShader, shaderPath + ".vs", shaderPath + ".fs");
+    shaderPath = "shaders/" + BENCH_DIR + "/lighting";
+    shaders.add(lightingShader, shaderPath + ".vs", shaderPath + ".fs");
+
+    // uniform blocks
+    Shader uboObjectShader, uboLightingShader;
+    shaderPath = "shaders/" + LESSON_DIR + "/object";
+    shaders.add(uboObjectShader, shaderPath + ".vs", shaderPath + ".fs");
+    shaderPath = "shaders/" + LESSON_DIR + "/lighting";
+    shaders.add(uboLightingShader, shaderPath + ".vs", shaderPath + ".fs");
+    if (!shaders.build())
+        return -1;
+
+    UniformBuffer<PerFrameBlock> perFrameBuffer(UniformBlockBinding::PER_FRAME);
+    UniformBuffer<LightsBlock<pointLightsPos.size()>> lightsBuffer(UniformBlockBinding::LIGHTS);
+    uboObjectShader.bindUniformBlock("PerFrame", perFrameBuffer.getBindingPoint());
+    uboObjectShader.bindUniformBlock("Lights", lightsBuffer.getBindingPoint());
+    uboLightingShader.bindUniformBlock("PerFrame", perFrameBuffer.getBindingPoint());
+    UniformBuffer<MaterialsBlock<MATERIALS>> materialsBuffer(UniformBlockBinding::MATERIALS);
+    uboObjectShader.bindUniformBlock("Materials", materialsBuffer.getBindingPoint());
+    MaterialsBlock<MATERIALS> materials;
+    for (MaterialData & material : materials.materials)
+        material = MaterialData{0, 0, 0.0f, 64.0f};
+    materialsBuffer.upload(materials);
+
+    unsigned int VBO, VAO, lightVAO;
+    glGenBuffers(1, &VBO);
+    glGenVertexArrays(1, &VAO);
+    glBindVertexArray(VAO);
+    glBindBuffer(GL_ARRAY_BUFFER, VBO);
+    glBufferData(GL_ARRAY_BUFFER, sizeof(fullCubeVertices), fullCubeVertices, GL_STATIC_DRAW);
+    unsigned int byte_stride = 8 * sizeof(float);
+    glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, byte_stride, (void*)(0 * sizeof(float)));
+    glEnableVertexAttribArray(0);
+    glVertexAttribPointer(1, 3, GL_FLOAT, GL_FALSE, byte_stride, (void*)(3 * sizeof(float)));
+    glEnableVertexAttribArray(1);
+    glVertexAttribPointer(2, 2, GL_FLOAT, GL_FALSE, byte_stride, (void*)(6 * sizeof(float)));
+    glEnableVertexAttribArray(2);
+    glGenVertexArrays(1, &lightVAO);
+    glBindVertexArray(lightVAO);
+    glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, byte_stride, (void*)(0 * sizeof(float)));
+    glEnableVertexAttribArray(0);
+
+    LegacyShader legacyObject{objectShader.getID()};
+    LegacyShader legacyLighting{lightingShader.getID()};
+    NamedShader namedObject(objectShader);
+    NamedShader namedLighting(lightingShader);
+    SceneHandles handles(objectShader, lightingShader);
+    UboScene uboScene(uboObjectShader, uboLightingShader, perFrameBuffer, lightsBuffer);
+
+    std::cout << "Lesson 5 scene, " << frames << " measured frames, CPU time of uniform upload + draw submission" << std::endl;
+
+    UniformStructArray pointLights = objectShader.structArray("pointLights");
+    auto byStruct = [&](glm::vec3 const & ambientColor, glm::vec3 const & diffuseColor) {
+        for (size_t i = 0; i < pointLightsPos.size(); ++i)
+        {
+            UniformStruct pointLight = pointLights.at(i);
+            pointLight.set("position", pointLightsPos[i]);
+            pointLight.set("constant", 1.0f);
+            pointLight.set("linear", 0.09f);
+            pointLight.set("quadratic", 0.032f);
+            pointLight.set("ambient", ambientColor);
+            pointLight.set("diffuse", diffuseColor);
+            pointLight.set("specular", glm::vec3(1.0f));
+        }
+    };
+
+    Stats legacy = measure([&](Frame const & f) {
+        renderByName(legacyObject, legacyLighting, VAO, lightVAO, f, [&](glm::vec3 const & a, glm::vec3 const & d) {
+            uploadPointLightsByPrefix(legacyObject, a, d);
+        });
+    }, warmup, frames);
+    Stats named = measure([&](Frame const & f) {
+        renderByName(namedObject, namedLighting, VAO, lightVAO, f, [&](glm::vec3 const & a, glm::vec3 const & d) {
+            uploadPointLightsByPrefix(namedObject, a, d);
+        });
+    }, warmup, frames);
+    Stats structs = measure([&](Frame const & f) { renderByName(namedObject, namedLighting, VAO, lightVAO, f, byStruct); }, warmup, frames);
+    Stats handle = measure([&](Frame const & f) { renderByHandle(objectShader, lightingShader, handles, VAO, lightVAO, f); }, warmup, frames);
+    Stats ubo = measure([&](Frame const & f) { renderByUbo(uboScene, VAO, lightVAO, f); }, warmup, frames);
+
+    report("legacy", legacy, legacy);
+    report("name  ", named, legacy);
+    report("struct", structs, legacy);
+    report("handle", handle, legacy);
+    report("ubo   ", ubo, legacy);
+
+    int result = 0;
+    if (structs.allocations != 0 || handle.allocations != 0 || ubo.allocations != 0)
+    {
+        std::cerr << "ERROR: steady state uniform upload allocates on the heap" << std::endl;
+        result = 1;
+    }
+
+    glDeleteVertexArrays(1, &VAO);
+    glDeleteVertexArrays(1, &lightVAO);
+    glDeleteBuffers(1, &VBO);
+    perFrameBuffer.destroy();
+    lightsBuffer.destroy();
+    materialsBuffer.destroy();
+    target.destroy();
+    context.destroy();
+    return result;
+}
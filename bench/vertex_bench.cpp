@@ -0,0 +1,166 @@
+// Vertex throughput of the "05_multiple-lights" cube field in a headless context (Mesa llvmpipe without GPU).
+// Compares two ways to get normal matrix:
+//   inverse   - mat3(transpose(inverse(aModel))) per vertex in vertex shader (lesson 5 before)
+//   attribute - computed once per instance on CPU, passed as aNormalMatrix (lesson 5 now)
+// CPU cost of the per-instance normal matrices (rotation fast path vs full inverse) is reported as well.
+#include "glad/glad.h"
+
+#include <glm/glm.hpp>
+#include <glm/gtc/matrix_transform.hpp>
+
+#include "utils/shader.hpp"
+#include "utils/shader_library.hpp"
+#include "utils/uniform_blocks.hpp"
+#include "utils/uniform_buffer.hpp"
+#include "utils/instance_buffer.hpp"
+#include "utils/headless_context.hpp"
+#include "utils/offscreen_target.hpp"
+#include "05_multiple-lights/cube_vertices.hpp"
+
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+
+// =============================================
+
+static const std::string LESSON_DIR = "05_multiple-lights";
+static const std::string BENCH_DIR = "vertex_bench";
+
+// small target: fragment work stays negligible compared to vertex work
+static const int TARGET_SIZE = 128;
+
+using bench_clock = std::chrono::steady_clock;
+
+static double elapsedMs(bench_clock::time_point start)
+{
+    return std::chrono::duration<double, std::milli>(bench_clock::now() - start).count();
+}
+
+// Same placement as stress mode of lesson 5
+static std::vector<glm::mat4> generateModels(size_t count)
+{
+    float extent = 2.0f * std::cbrt(float(count));
+    std::mt19937 rng(42);
+    auto random = [&rng](float from, float to) {
+        return from + (to - from) * float(rng() - rng.min()) / float(rng.max() - rng.min());
+    };
+
+    std::vector<glm::mat4> models(count);
+    for (size_t i = 0; i < count; ++i)
+    {
+        glm::vec3 pos(random(-0.5f * extent, 0.5f * extent), random(-0.5f * extent, 0.5f * extent), random(-extent, -1.0f));
+        glm::mat4 model = glm::translate(glm::mat4(1.0f), pos);
+        models[i] = glm::rotate(model, glm::radians(20.0f * (i % 3 + 1)), glm::vec3(1.0f, 0.3f, 0.5f));
+    }
+    return models;
+}
+
+// Draw all instances `frames` times, returns mean milliseconds per frame
+static double measure(Shader const & shader, unsigned int VAO, GLsizei instances, int frames)
+{
+    shader.use();
+    glBindVertexArray(VAO);
+
+    double total = 0.0;
+    for (int i = -2; i < frames; ++i) // two warm-up frames
+    {
+        auto start = bench_clock::now();
+        glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+        glDrawArraysInstanced(GL_TRIANGLES, 0, 36, instances);
+        glFinish();
+        if (i >= 0)
+            total += elapsedMs(start);
+    }
+    return total / frames;
+}
+
+// ===========================================================
+int main(int argc, char ** argv)
+{
+    size_t count = argc > 1 ? std::strtoul(argv[1], nullptr, 10) : 100000;
+    int frames = argc > 2 ? std::atoi(argv[2]) : 20;
+
+    HeadlessContext context;
+    if (!context.create())
+        return -1;
+
+    OffscreenTarget target;
+    if (!target.create(TARGET_SIZE, TARGET_SIZE))
+        return -1;
+    glEnable(GL_DEPTH_TEST);
+
+    std::string benchPath = "shaders/" + BENCH_DIR + "/";
+    std::string lessonPath = "shaders/" + LESSON_DIR + "/";
+    Shader inverseShader, attributeShader;
+    ShaderLibrary shaders;
+    shaders.add(inverseShader, benchPath + "normal_inverse.vs", benchPath + "normal.fs");
+    shaders.add(attributeShader, lessonPath + "object.vs", benchPath + "normal.fs");
+    if (!shaders.build())
+        return -1;
+
+    UniformBuffer<PerFrameBlock> perFrameBuffer(UniformBlockBinding::PER_FRAME);
+    inverseShader.bindUniformBlock("PerFrame", perFrameBuffer.getBindingPoint());
+    attributeShader.bindUniformBlock("PerFrame", perFrameBuffer.getBindingPoint());
+
+    PerFrameBlock perFrame;
+    perFrame.projection = glm::perspective(glm::radians(45.0f), 1.0f, 0.1f, 1000.0f);
+    perFrame.viewPos = glm::vec3(0.0f, 0.0f, 3.0f);
+    perFrame.view = glm::lookAt(perFrame.viewPos, glm::vec3(0.0f, 0.0f, -1.0f), glm::vec3(0.0f, 1.0f, 0.0f));
+    perFrameBuffer.upload(perFrame);
+
+    unsigned int VBO, VAO;
+    glGenBuffers(1, &VBO);
+    glGenVertexArrays(1, &VAO);
+    glBindVertexArray(VAO);
+    glBindBuffer(GL_ARRAY_BUFFER, VBO);
+    glBufferData(GL_ARRAY_BUFFER, sizeof(fullCubeVertices), fullCubeVertices, GL_STATIC_DRAW);
+    unsigned int byte_stride = 8 * sizeof(float);
+    glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, byte_stride, (void*)(0 * sizeof(float)));
+    glEnableVertexAttribArray(0);
+    glVertexAttribPointer(1, 3, GL_FLOAT, GL_FALSE, byte_stride, (void*)(3 * sizeof(float)));
+    glEnableVertexAttribArray(1);
+    glVertexAttribPointer(2, 2, GL_FLOAT, GL_FALSE, byte_stride, (void*)(6 * sizeof(float)));
+    glEnableVertexAttribArray(2);
+    InstanceBuffer instanceBuffer;
+    instanceBuffer.attach();
+
+    // CPU: normal matrices once per instance
+    std::vector<glm::mat4> models = generateModels(count);
+    std::vector<InstanceData> instances(count);
+
+    auto start = bench_clock::now();
+    for (size_t i = 0; i < count; ++i)
+        instances[i].normal = glm::transpose(glm::inverse(glm::mat3(models[i])));
+    double cpuInverseMs = elapsedMs(start);
+
+    start = bench_clock::now();
+    for (size_t i = 0; i < count; ++i)
+        instances[i] = makeInstance(models[i]);
+    double cpuFastMs = elapsedMs(start);
+
+    instanceBuffer.upload(instances);
+
+    // GPU (or llvmpipe): same draw, different vertex shader
+    double inverseMs = measure(inverseShader, VAO, instanceBuffer.size(), frames);
+    double attributeMs = measure(attributeShader, VAO, instanceBuffer.size(), frames);
+
+    double vertices = double(count) * 36.0;
+    std::cout << count << " cubes (" << vertices / 1e6 << " M vertices), " << frames << " frames, "
+              << TARGET_SIZE << "x" << TARGET_SIZE << " target" << std::endl;
+    std::cout << "inverse   : " << inverseMs << " ms/frame, " << vertices / inverseMs / 1e3 << " M vertices/s" << std::endl;
+    std::cout << "attribute : " << attributeMs << " ms/frame, " << vertices / attributeMs / 1e3 << " M vertices/s"
+              << " (x" << inverseMs / attributeMs << ")" << std::endl;
+    std::cout << "CPU normal matrices: full inverse " << cpuInverseMs << " ms, makeInstance " << cpuFastMs << " ms" << std::endl;
+
+    glDeleteVertexArrays(1, &VAO);
+    glDeleteBuffers(1, &VBO);
+    instanceBuffer.destroy();
+    perFrameBuffer.destroy();
+    target.destroy();
+    context.destroy();
+    return 0;
+}
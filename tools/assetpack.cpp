@@ -0,0 +1,67 @@
+// Asset packer: writes the shaders, images and baked textures of the build folder into one archive (AssetPack),
+// which lessons map at startup instead of opening every file.
+// Entry names are paths relative to the root folder; directories are packed with everything below them.
+// Usage: assetpack output.pack --root dir path...
+#include "utils/asset_pack.hpp"
+
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <iostream>
+#include <string>
+#include <vector>
+
+namespace fs = std::filesystem;
+
+int main(int argc, char ** argv)
+{
+    std::string root = ".";
+    std::vector<std::string> paths;
+    for (int i = 1; i < argc; ++i)
+    {
+        if (std::strcmp(argv[i], "--root") == 0 && i + 1 < argc)
+            root = argv[++i];
+        else
+            paths.push_back(argv[i]);
+    }
+    if (paths.size() < 2)
+    {
+        std::cerr << "Usage: assetpack output.pack --root dir path..." << std::endl;
+        return -1;
+    }
+
+    // entry name: path below root with forward slashes, as lessons open it
+    std::vector<AssetPack::Source> sources;
+    auto add = [&root, &sources](fs::path const & file) {
+        sources.push_back(AssetPack::Source{file.lexically_relative(root).generic_string(), file.string()});
+    };
+    for (size_t i = 1; i < paths.size(); ++i)
+    {
+        fs::path path = fs::path(root) / paths[i];
+        std::error_code error;
+        if (fs::is_directory(path, error))
+        {
+            for (fs::directory_entry const & entry : fs::recursive_directory_iterator(path, error))
+            {
+                if (entry.is_regular_file(error))
+                    add(entry.path());
+            }
+        }
+        else if (fs::is_regular_file(path, error))
+        {
+            add(path);
+        }
+        else
+        {
+            std::cerr << "ERROR::ASSETPACK::PATH_NOT_FOUND " << path.string() << std::endl;
+            return -1;
+        }
+    }
+
+    if (!AssetPack::write(paths[0], sources))
+        return -1;
+    std::printf("%s: %zu files, %ju KiB\n", paths[0].c_str(), sources.size(),
+                std::uintmax_t(fs::file_size(paths[0])) / 1024);
+    return 0;
+}
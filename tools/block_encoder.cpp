@@ -0,0 +1,257 @@
+#include "block_encoder.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+
+#if defined(__SSE2__) || defined(_M_X64)
+#define BLOCK_ENCODER_SSE2
+#include <emmintrin.h>
+#endif
+
+namespace
+{
+    // per-channel bounds of 16 RGBA texels
+    void bounds(const unsigned char rgba[64], unsigned char low[4], unsigned char high[4])
+    {
+#ifdef BLOCK_ENCODER_SSE2
+        __m128i rows[4];
+        for (int i = 0; i < 4; ++i)
+            rows[i] = _mm_loadu_si128(reinterpret_cast<const __m128i *>(rgba + 16 * i));
+        __m128i minimum = _mm_min_epu8(_mm_min_epu8(rows[0], rows[1]), _mm_min_epu8(rows[2], rows[3]));
+        __m128i maximum = _mm_max_epu8(_mm_max_epu8(rows[0], rows[1]), _mm_max_epu8(rows[2], rows[3]));
+        // 4 texels per register: fold texels 2,3 onto 0,1 and 1 onto 0
+        minimum = _mm_min_epu8(minimum, _mm_srli_si128(minimum, 8));
+        maximum = _mm_max_epu8(maximum, _mm_srli_si128(maximum, 8));
+        minimum = _mm_min_epu8(minimum, _mm_srli_si128(minimum, 4));
+        maximum = _mm_max_epu8(maximum, _mm_srli_si128(maximum, 4));
+        uint32_t lowBits = uint32_t(_mm_cvtsi128_si32(minimum));
+        uint32_t highBits = uint32_t(_mm_cvtsi128_si32(maximum));
+        for (int c = 0; c < 4; ++c)
+        {
+            low[c] = static_cast<unsigned char>(lowBits >> (8 * c));
+            high[c] = static_cast<unsigned char>(highBits >> (8 * c));
+        }
+#else
+        for (int c = 0; c < 4; ++c)
+        {
+            low[c] = 255;
+            high[c] = 0;
+        }
+        for (int i = 0; i < 16; ++i)
+        {
+            for (int c = 0; c < 4; ++c)
+            {
+                low[c] = std::min(low[c], rgba[4 * i + c]);
+                high[c] = std::max(high[c], rgba[4 * i + c]);
+            }
+        }
+#endif
+    }
+
+    // position of every texel on line from origin in direction axis (RGBA weights), scaled to 0..steps
+    // and rounded to nearest step
+    void project(const unsigned char rgba[64], const int origin[4], const int axis[4], int steps, int result[16])
+    {
+        int length2 = axis[0] * axis[0] + axis[1] * axis[1] + axis[2] * axis[2] + axis[3] * axis[3];
+        float scale = float(steps) / float(length2);
+#ifdef BLOCK_ENCODER_SSE2
+        const __m128i mask = _mm_set1_epi32(0xFF);
+        const __m128 zero = _mm_setzero_ps();
+        const __m128 last = _mm_set1_ps(float(steps));
+        for (int i = 0; i < 4; ++i)
+        {
+            // 4 texels, one channel per register
+            __m128i texels = _mm_loadu_si128(reinterpret_cast<const __m128i *>(rgba + 16 * i));
+            __m128 distance = _mm_setzero_ps();
+            for (int c = 0; c < 4; ++c)
+            {
+                if (axis[c] == 0)
+                    continue;
+                __m128i channel = _mm_and_si128(_mm_srli_epi32(texels, 8 * c), mask);
+                __m128 offset = _mm_sub_ps(_mm_cvtepi32_ps(channel), _mm_set1_ps(float(origin[c])));
+                distance = _mm_add_ps(distance, _mm_mul_ps(offset, _mm_set1_ps(float(axis[c]))));
+            }
+            __m128 position = _mm_min_ps(_mm_max_ps(_mm_mul_ps(distance, _mm_set1_ps(scale)), zero), last);
+            _mm_storeu_si128(reinterpret_cast<__m128i *>(result + 4 * i), _mm_cvtps_epi32(position));
+        }
+#else
+        for (int i = 0; i < 16; ++i)
+        {
+            int distance = 0;
+            for (int c = 0; c < 4; ++c)
+                distance += (int(rgba[4 * i + c]) - origin[c]) * axis[c];
+            float position = std::min(std::max(float(distance) * scale, 0.0f), float(steps));
+            result[i] = int(std::nearbyint(position));  // to nearest even, as _mm_cvtps_epi32
+        }
+#endif
+    }
+
+    uint16_t pack565(int r, int g, int b)
+    {
+        return static_cast<uint16_t>(((r * 31 + 127) / 255) << 11 | ((g * 63 + 127) / 255) << 5 | ((b * 31 + 127) / 255));
+    }
+
+    void unpack565(uint16_t color, int rgb[3])
+    {
+        int r = color >> 11, g = (color >> 5) & 63, b = color & 31;
+        rgb[0] = (r << 3) | (r >> 2);
+        rgb[1] = (g << 2) | (g >> 4);
+        rgb[2] = (b << 3) | (b >> 2);
+    }
+
+    // texels of block at (x, y) as RGBA, clamped to image
+    void fetchBlock(const unsigned char * pixels, int width, int height, int components, int x, int y,
+                    unsigned char rgba[64])
+    {
+        for (int j = 0; j < 4; ++j)
+        {
+            int row = std::min(y + j, height - 1);
+            for (int i = 0; i < 4; ++i)
+            {
+                int column = std::min(x + i, width - 1);
+                const unsigned char * texel = pixels + (size_t(row) * size_t(width) + size_t(column)) * size_t(components);
+                unsigned char * out = rgba + 4 * (4 * j + i);
+                switch (components)
+                {
+                    case 1: out[0] = out[1] = out[2] = texel[0]; out[3] = 255; break;
+                    case 2: out[0] = out[1] = out[2] = texel[0]; out[3] = texel[1]; break;
+                    case 3: out[0] = texel[0]; out[1] = texel[1]; out[2] = texel[2]; out[3] = 255; break;
+                    default: out[0] = texel[0]; out[1] = texel[1]; out[2] = texel[2]; out[3] = texel[3]; break;
+                }
+            }
+        }
+    }
+}
+
+namespace BlockEncoder
+{
+    int blockBytes(Format format)
+    {
+        return format == BC1 || format == BC4 ? 8 : 16;
+    }
+
+    void encodeBC1(const unsigned char rgba[64], unsigned char out[8])
+    {
+        unsigned char low[4], high[4];
+        bounds(rgba, low, high);
+
+        // bounding box diagonal follows the texels: swap red/blue ends if they fall while green rises
+        float mean[3] = {0.0f, 0.0f, 0.0f};
+        for (int i = 0; i < 16; ++i)
+            for (int c = 0; c < 3; ++c)
+                mean[c] += rgba[4 * i + c] / 16.0f;
+        float covarianceRG = 0.0f, covarianceBG = 0.0f;
+        for (int i = 0; i < 16; ++i)
+        {
+            float g = rgba[4 * i + 1] - mean[1];
+            covarianceRG += (rgba[4 * i + 0] - mean[0]) * g;
+            covarianceBG += (rgba[4 * i + 2] - mean[2]) * g;
+        }
+
+        // inset box by 1/16 of its size: ends of the line are rarely hit exactly
+        int end0[3], end1[3];
+        for (int c = 0; c < 3; ++c)
+        {
+            int inset = (high[c] - low[c]) / 16;
+            end0[c] = high[c] - inset;
+            end1[c] = low[c] + inset;
+        }
+        if (covarianceRG < 0.0f)
+            std::swap(end0[0], end1[0]);
+        if (covarianceBG < 0.0f)
+            std::swap(end0[2], end1[2]);
+
+        uint16_t color0 = pack565(end0[0], end0[1], end0[2]);
+        uint16_t color1 = pack565(end1[0], end1[1], end1[2]);
+        // color0 > color1 selects 4 color mode (no transparent black)
+        if (color0 < color1)
+            std::swap(color0, color1);
+
+        uint32_t indices = 0;
+        if (color0 != color1)
+        {
+            int origin[4] = {0, 0, 0, 0}, axis[4] = {0, 0, 0, 0};
+            int rgb0[3], rgb1[3];
+            unpack565(color0, rgb0);
+            unpack565(color1, rgb1);
+            for (int c = 0; c < 3; ++c)
+            {
+                origin[c] = rgb1[c];
+                axis[c] = rgb0[c] - rgb1[c];
+            }
+            // position 0..3 from color1 to color0 -> palette index (0: color0, 1: color1, 2: 2/3 color0, 3: 1/3 color0)
+            static const uint32_t PALETTE[4] = {1, 3, 2, 0};
+            int positions[16];
+            project(rgba, origin, axis, 3, positions);
+            for (int i = 0; i < 16; ++i)
+                indices |= PALETTE[positions[i]] << (2 * i);
+        }
+
+        out[0] = static_cast<unsigned char>(color0);
+        out[1] = static_cast<unsigned char>(color0 >> 8);
+        out[2] = static_cast<unsigned char>(color1);
+        out[3] = static_cast<unsigned char>(color1 >> 8);
+        for (int i = 0; i < 4; ++i)
+            out[4 + i] = static_cast<unsigned char>(indices >> (8 * i));
+    }
+
+    void encodeBC4(const unsigned char rgba[64], int channel, unsigned char out[8])
+    {
+        unsigned char low[4], high[4];
+        bounds(rgba, low, high);
+        // 8 value mode: value0 > value1, both ends are exact (black stays black)
+        int value0 = high[channel];
+        int value1 = low[channel];
+
+        uint64_t indices = 0;
+        if (value0 != value1)
+        {
+            int origin[4] = {0, 0, 0, 0}, axis[4] = {0, 0, 0, 0};
+            origin[channel] = value1;
+            axis[channel] = value0 - value1;
+            // position 0..7 from value1 to value0 -> palette index (0: value0, 1: value1, 2..7: value0 to value1)
+            int positions[16];
+            project(rgba, origin, axis, 7, positions);
+            for (int i = 0; i < 16; ++i)
+            {
+                int p = positions[i];
+                uint64_t index = p == 7 ? 0 : (p == 0 ? 1 : 8 - p);
+                indices |= index << (3 * i);
+            }
+        }
+
+        out[0] = static_cast<unsigned char>(value0);
+        out[1] = static_cast<unsigned char>(value1);
+        for (int i = 0; i < 6; ++i)
+            out[2 + i] = static_cast<unsigned char>(indices >> (8 * i));
+    }
+
+    std::vector<unsigned char> encode(Format format, const unsigned char * pixels, int width, int height,
+                                      int components)
+    {
+        int blocksX = (width + 3) / 4;
+        int blocksY = (height + 3) / 4;
+        int bytes = blockBytes(format);
+        std::vector<unsigned char> result(size_t(blocksX) * size_t(blocksY) * size_t(bytes));
+
+        unsigned char rgba[64];
+        unsigned char * out = result.data();
+        for (int y = 0; y < blocksY; ++y)
+        {
+            for (int x = 0; x < blocksX; ++x)
+            {
+                fetchBlock(pixels, width, height, components, 4 * x, 4 * y, rgba);
+                switch (format)
+                {
+                    case BC1: encodeBC1(rgba, out); break;
+                    case BC3: encodeBC4(rgba, 3, out); encodeBC1(rgba, out + 8); break;
+                    case BC4: encodeBC4(rgba, 0, out); break;
+                    case BC5: encodeBC4(rgba, 0, out); encodeBC4(rgba, 1, out + 8); break;
+                }
+                out += bytes;
+            }
+        }
+        return result;
+    }
+}
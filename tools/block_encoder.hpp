@@ -0,0 +1,29 @@
+#pragma once
+
+#include <vector>
+
+//! @brief CPU encoder of 4x4 block compressed formats (BC1/BC3 = S3TC DXT1/DXT5, BC4/BC5 = RGTC).
+//! Endpoints are fitted to bounding box of the block, texels are projected on the endpoint line;
+//! bounds and projection use SSE2 when available.
+namespace BlockEncoder
+{
+    enum Format
+    {
+        BC1,  // RGB, 8 bytes per block
+        BC3,  // RGBA (BC1 color + BC4 alpha), 16 bytes per block
+        BC4,  // R, 8 bytes per block
+        BC5,  // RG (two BC4 blocks), 16 bytes per block
+    };
+
+    int blockBytes(Format format);
+
+    // 16 RGBA texels, row by row
+    void encodeBC1(const unsigned char rgba[64], unsigned char out[8]);
+    // channel of 16 RGBA texels (0 - red ... 3 - alpha)
+    void encodeBC4(const unsigned char rgba[64], int channel, unsigned char out[8]);
+
+    // whole image (1 - gray, 2 - gray + alpha, 3 - RGB, 4 - RGBA), blocks row by row; edge texels repeat
+    // in blocks that are not covered by the image
+    std::vector<unsigned char> encode(Format format, const unsigned char * pixels, int width, int height,
+                                      int components);
+}
@@ -0,0 +1,226 @@
+// Offline texture baking: decodes PNG/JPEG once at build time and writes GPU-ready file (BakedTexture)
+// with full mip chain, so lessons map it and upload levels as they are (no decoding, no glGenerateMipmap).
+// Levels are block compressed by default: gray maps to BC4, opaque color to BC1, color with alpha to BC3.
+// Internal formats are sized; "--srgb" marks color as sRGB encoded (SRGB8, SRGB8_ALPHA8, BC1/BC3 sRGB).
+// "--size WxH" resamples the image first, e.g. to bake layers of one texture array to the same size.
+// "--cache dir" bakes into content-addressed AssetCache entry (source hash + options) and links output to it:
+// the same image of several lessons is baked and stored once, rebuilds with unchanged input do not encode again.
+// Usage: texbake [--no-flip] [--srgb] [--size WxH] [--format auto|raw|r8|bc1|bc3|bc4|bc5] [--cache dir]
+//                input.png output.btex
+#include "block_encoder.hpp"
+#include "utils/asset_cache.hpp"
+#include "utils/baked_texture.hpp"
+#include "utils/image_ops.hpp"
+
+#include <glad/glad.h>
+
+#include "stb/stb_image.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include <string>
+#include <vector>
+
+// part of cache keys: bump when encoder output changes for the same options
+static const int ENCODER_REVISION = 1;
+
+struct BlockFormat
+{
+    const char * name;
+    BlockEncoder::Format format;
+    uint32_t glInternalFormat;
+    //! @brief Same format with sRGB color (glInternalFormat if there is none)
+    uint32_t glInternalFormatSrgb;
+};
+
+static const BlockFormat BLOCK_FORMATS[] = {
+    {"bc1", BlockEncoder::BC1, BakedTexture::COMPRESSED_RGB_S3TC_DXT1, BakedTexture::COMPRESSED_SRGB_S3TC_DXT1},
+    {"bc3", BlockEncoder::BC3, BakedTexture::COMPRESSED_RGBA_S3TC_DXT5, BakedTexture::COMPRESSED_SRGB_ALPHA_S3TC_DXT5},
+    {"bc4", BlockEncoder::BC4, GL_COMPRESSED_RED_RGTC1, GL_COMPRESSED_RED_RGTC1},
+    {"bc5", BlockEncoder::BC5, GL_COMPRESSED_RG_RGTC2, GL_COMPRESSED_RG_RGTC2},
+};
+
+// single channel maps (all texels gray) and maps without transparent texels
+static void analyze(std::vector<unsigned char> const & pixels, int components, bool & gray, bool & opaque)
+{
+    gray = components <= 2;
+    opaque = components == 1 || components == 3;
+    if (!gray)
+    {
+        gray = true;
+        for (size_t i = 0; gray && i < pixels.size(); i += size_t(components))
+            gray = pixels[i] == pixels[i + 1] && pixels[i] == pixels[i + 2];
+    }
+    if (!opaque)
+    {
+        opaque = true;
+        for (size_t i = size_t(components) - 1; opaque && i < pixels.size(); i += size_t(components))
+            opaque = pixels[i] == 255;
+    }
+}
+
+// first channel of every texel
+static std::vector<unsigned char> redChannel(std::vector<unsigned char> const & pixels, int components)
+{
+    std::vector<unsigned char> result(pixels.size() / size_t(components));
+    for (size_t i = 0; i < result.size(); ++i)
+        result[i] = pixels[i * size_t(components)];
+    return result;
+}
+
+int main(int argc, char ** argv)
+{
+    bool flip = true;
+    bool srgb = false;
+    int newWidth = 0, newHeight = 0;
+    std::string formatName = "auto";
+    std::string cacheDirectory;
+    std::vector<std::string> paths;
+    for (int i = 1; i < argc; ++i)
+    {
+        if (std::strcmp(argv[i], "--no-flip") == 0)
+            flip = false;
+        else if (std::strcmp(argv[i], "--srgb") == 0)
+            srgb = true;
+        else if (std::strcmp(argv[i], "--size") == 0 && i + 1 < argc)
+        {
+            if (std::sscanf(argv[++i], "%dx%d", &newWidth, &newHeight) != 2 || newWidth <= 0 || newHeight <= 0)
+            {
+                std::cerr << "ERROR::TEXBAKE::BAD_SIZE " << argv[i] << " (expected WxH)" << std::endl;
+                return -1;
+            }
+        }
+        else if (std::strcmp(argv[i], "--format") == 0 && i + 1 < argc)
+            formatName = argv[++i];
+        else if (std::strcmp(argv[i], "--cache") == 0 && i + 1 < argc)
+            cacheDirectory = argv[++i];
+        else
+            paths.push_back(argv[i]);
+    }
+    if (paths.size() != 2)
+    {
+        std::cerr << "Usage: texbake [--no-flip] [--srgb] [--size WxH] [--format auto|raw|r8|bc1|bc3|bc4|bc5] [--cache dir]"
+                     " input output" << std::endl;
+        return -1;
+    }
+
+    // every option that changes the output is part of the key
+    std::string cacheEntry;
+    if (!cacheDirectory.empty())
+    {
+        std::string parameters = "texbake v" + std::to_string(BakedTexture::VERSION) + " r"
+                               + std::to_string(ENCODER_REVISION) + (flip ? " flip" : "") + (srgb ? " srgb" : "")
+                               + " size " + std::to_string(newWidth) + "x" + std::to_string(newHeight)
+                               + " format " + formatName;
+        std::string key = AssetCache::keyFor(paths[0], parameters);
+        if (!key.empty())
+            cacheEntry = AssetCache::pathFor(cacheDirectory, key, BakedTexture::EXTENSION);
+        if (!cacheEntry.empty() && std::ifstream(cacheEntry).good())
+        {
+            if (!AssetCache::link(cacheEntry, paths[1]))
+                return -1;
+            std::printf("%s: cached %s\n", paths[0].c_str(), cacheEntry.c_str());
+            return 0;
+        }
+    }
+
+    // same orientation as TextureLoader::load(path, flipVertically)
+    stbi_set_flip_vertically_on_load(flip);
+    int width, height, components;
+    unsigned char * pixels = stbi_load(paths[0].c_str(), &width, &height, &components, 0);
+    if (!pixels)
+    {
+        std::cerr << "ERROR::TEXBAKE::FILE_NOT_SUCCESFULLY_READ " << paths[0] << std::endl;
+        return -1;
+    }
+
+    std::vector<std::vector<unsigned char>> levels;
+    if (newWidth > 0 && (newWidth != width || newHeight != height))
+    {
+        levels.push_back(ImageOps::resize(pixels, width, height, components, newWidth, newHeight));
+        width = newWidth;
+        height = newHeight;
+    }
+    else
+    {
+        levels.emplace_back(pixels, pixels + size_t(width) * size_t(height) * size_t(components));
+    }
+    stbi_image_free(pixels);
+
+    uint32_t levelCount = BakedTexture::levelCount(uint32_t(width), uint32_t(height));
+    for (uint32_t level = 1; level < levelCount; ++level)
+    {
+        int w = std::max(width >> (level - 1), 1);
+        int h = std::max(height >> (level - 1), 1);
+        levels.push_back(ImageOps::downsample(levels.back(), w, h, components));
+    }
+    size_t decodedSize = 0;
+    for (std::vector<unsigned char> const & level : levels)
+        decodedSize += level.size();
+
+    if (formatName == "auto")
+    {
+        bool gray, opaque;
+        analyze(levels[0], components, gray, opaque);
+        formatName = !opaque ? "bc3" : (gray ? "bc4" : "bc1");
+    }
+
+    BakedTexture::Format format{};
+    if (formatName == "raw")
+    {
+        if (!BakedTexture::formatFor(components, srgb, format))
+        {
+            std::cerr << "ERROR::TEXBAKE::UNHANDLED_COMPONENTS " << components << std::endl;
+            return -1;
+        }
+    }
+    else if (formatName == "r8")
+    {
+        format = BakedTexture::Format{GL_R8, GL_RED, GL_UNSIGNED_BYTE};
+        for (std::vector<unsigned char> & level : levels)
+            level = redChannel(level, components);
+    }
+    else
+    {
+        auto block = std::find_if(std::begin(BLOCK_FORMATS), std::end(BLOCK_FORMATS),
+                                  [&formatName](BlockFormat const & f) { return formatName == f.name; });
+        if (block == std::end(BLOCK_FORMATS))
+        {
+            std::cerr << "ERROR::TEXBAKE::UNKNOWN_FORMAT " << formatName << std::endl;
+            return -1;
+        }
+        format.glInternalFormat = srgb ? block->glInternalFormatSrgb : block->glInternalFormat;
+        for (size_t level = 0; level < levels.size(); ++level)
+        {
+            int w = std::max(width >> level, 1);
+            int h = std::max(height >> level, 1);
+            levels[level] = BlockEncoder::encode(block->format, levels[level].data(), w, h, components);
+        }
+    }
+
+    uint32_t flags = (flip ? BakedTexture::FLIPPED_VERTICALLY : 0u) | (srgb ? BakedTexture::SRGB : 0u);
+    auto write = [&](std::string const & path) {
+        return BakedTexture::write(path, uint32_t(width), uint32_t(height), format, flags, levels);
+    };
+    if (cacheEntry.empty())
+    {
+        if (!write(paths[1]))
+            return -1;
+    }
+    else if (!AssetCache::store(cacheEntry, write) || !AssetCache::link(cacheEntry, paths[1]))
+    {
+        return -1;
+    }
+
+    size_t size = 0;
+    for (std::vector<unsigned char> const & level : levels)
+        size += level.size();
+    std::printf("%s: %dx%d, %d channels -> %s, %u levels, %zu KiB (decoded %zu KiB)\n", paths[0].c_str(), width,
+                height, components, BakedTexture::formatName(format.glInternalFormat).c_str(), levelCount, size / 1024,
+                decodedSize / 1024);
+    return 0;
+}
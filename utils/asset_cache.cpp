@@ -0,0 +1,113 @@
+#include "asset_cache.hpp"
+
+#include "mapped_file.hpp"
+
+#include <cstdio>
+#include <filesystem>
+#include <iostream>
+#include <random>
+#include <sstream>
+
+namespace fs = std::filesystem;
+
+namespace AssetCache
+{
+    uint64_t hash(const void * data, size_t size, uint64_t seed)
+    {
+        auto bytes = static_cast<const unsigned char *>(data);
+        uint64_t value = seed;
+        for (size_t i = 0; i < size; ++i)
+        {
+            value ^= bytes[i];
+            value *= 0x100000001b3ull;
+        }
+        return value;
+    }
+
+    namespace
+    {
+        std::string toKey(uint64_t value)
+        {
+            // final mix (MurmurHash3 fmix64): keys that differ in the last parameter byte differ in all digits
+            value ^= value >> 33;
+            value *= 0xff51afd7ed558ccdull;
+            value ^= value >> 33;
+            value *= 0xc4ceb9fe1a85ec53ull;
+            value ^= value >> 33;
+
+            char key[17];
+            std::snprintf(key, sizeof(key), "%016llx", static_cast<unsigned long long>(value));
+            return key;
+        }
+    }
+
+    std::string keyFor(std::string const & sourcePath, std::string const & parameters)
+    {
+        MappedFile file;
+        if (!file.open(sourcePath))
+            return std::string();
+        uint64_t value = hash(file.getData(), file.getSize());
+        value = hash(parameters.data(), parameters.size(), value);
+        return toKey(value);
+    }
+
+    std::string keyOf(std::vector<std::string_view> const & parts)
+    {
+        uint64_t value = hash(nullptr, 0);
+        for (std::string_view part : parts)
+        {
+            // length first: ("ab", "c") and ("a", "bc") differ
+            uint64_t length = part.size();
+            value = hash(&length, sizeof(length), value);
+            value = hash(part.data(), part.size(), value);
+        }
+        return toKey(value);
+    }
+
+    std::string pathFor(std::string const & directory, std::string const & key, std::string const & extension)
+    {
+        return directory + "/" + key + extension;
+    }
+
+    bool store(std::string const & entryPath, std::function<bool(std::string const &)> const & writer)
+    {
+        std::error_code error;
+        fs::path entry(entryPath);
+        if (entry.has_parent_path())
+            fs::create_directories(entry.parent_path(), error);
+
+        // unique temporary name: other processes and loader threads may write the same entry
+        std::ostringstream temporary;
+        temporary << entryPath << ".tmp" << std::hex << std::random_device()();
+        if (!writer(temporary.str()))
+        {
+            fs::remove(temporary.str(), error);
+            return false;
+        }
+        fs::rename(temporary.str(), entry, error);
+        if (error)
+        {
+            std::cerr << "ERROR::ASSET_CACHE::ENTRY_NOT_STORED " << entryPath << ": " << error.message() << std::endl;
+            fs::remove(temporary.str(), error);
+            return false;
+        }
+        return true;
+    }
+
+    bool link(std::string const & entryPath, std::string const & outputPath)
+    {
+        std::error_code error;
+        fs::remove(outputPath, error);
+        fs::create_hard_link(entryPath, outputPath, error);
+        if (error)
+            fs::copy_file(entryPath, outputPath, fs::copy_options::overwrite_existing, error);
+        if (error)
+        {
+            std::cerr << "ERROR::ASSET_CACHE::LINK_FAILED " << outputPath << ": " << error.message() << std::endl;
+            return false;
+        }
+        // build tools compare output time with their inputs
+        fs::last_write_time(outputPath, fs::file_time_type::clock::now(), error);
+        return true;
+    }
+}
@@ -0,0 +1,33 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+//! @brief Content-addressed cache of derived assets (baked textures, program binaries) shared by all lessons and benchmarks.
+//! Entry name is a hash of the source file content and of the parameters that produced the entry:
+//! equal files of different lessons share one entry, a changed file or parameter never hits a stale one.
+//! Entries are written once, through a temporary file moved in place.
+namespace AssetCache
+{
+    // folder relative to the working directory of lessons and benchmarks (build folder)
+    static const char * const DIRECTORY_DEFAULT = "asset_cache";
+
+    // 64-bit FNV-1a, seed chains several buffers
+    uint64_t hash(const void * data, size_t size, uint64_t seed = 0xcbf29ce484222325ull);
+    // 16 hex digits of content hash of the file and parameters, empty if the file cannot be read
+    std::string keyFor(std::string const & sourcePath, std::string const & parameters);
+    // 16 hex digits of content hash of several buffers (e.g. shader sources and driver strings)
+    std::string keyOf(std::vector<std::string_view> const & parts);
+    // "directory/key.extension"
+    std::string pathFor(std::string const & directory, std::string const & key, std::string const & extension);
+
+    // create entry with writer(temporary path), then move it in place (directory is created if needed).
+    // Concurrent writers of the same entry are fine: the last rename wins, content is the same
+    bool store(std::string const & entryPath, std::function<bool(std::string const &)> const & writer);
+    // make output a hard link to the entry (copy where links are not supported), modification time is now
+    bool link(std::string const & entryPath, std::string const & outputPath);
+}
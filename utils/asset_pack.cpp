@@ -0,0 +1,166 @@
+#include "asset_pack.hpp"
+
+#include "asset_cache.hpp"
+
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include <unordered_map>
+
+namespace
+{
+    const char MAGIC[4] = {'L', 'G', 'P', 'K'};
+    static_assert(sizeof(AssetPack::Header) == 16 && sizeof(AssetPack::Entry) == 24, "pack layout changed");
+    const uint64_t DATA_ALIGNMENT = 16;
+
+    uint64_t alignUp(uint64_t value)
+    {
+        return (value + DATA_ALIGNMENT - 1) / DATA_ALIGNMENT * DATA_ALIGNMENT;
+    }
+
+    bool readFile(std::string const & path, std::vector<char> & content)
+    {
+        std::ifstream file(path, std::ios::binary);
+        if (!file)
+            return false;
+        content.assign(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+        return true;
+    }
+}
+
+bool AssetPack::open(std::string const & path)
+{
+    close();
+    if (!file.open(path))
+        return false;
+
+    const unsigned char * data = file.getData();
+    size_t size = file.getSize();
+    auto header = reinterpret_cast<Header const *>(data);
+    uint64_t indexEnd = sizeof(Header);
+    bool valid = size >= sizeof(Header) && std::memcmp(header->magic, MAGIC, sizeof(MAGIC)) == 0
+              && header->version == VERSION;
+    if (valid)
+    {
+        indexEnd += uint64_t(header->entryCount) * sizeof(Entry) + header->namesSize;
+        valid = indexEnd <= size;
+    }
+    if (valid)
+    {
+        entries = reinterpret_cast<Entry const *>(data + sizeof(Header));
+        names = reinterpret_cast<const char *>(entries + header->entryCount);
+        count = header->entryCount;
+        for (size_t i = 0; i < count && valid; ++i)
+        {
+            Entry const & entry = entries[i];
+            valid = uint64_t(entry.nameOffset) + entry.nameLength <= header->namesSize
+                 && entry.offset >= indexEnd && entry.offset + entry.size <= size;
+        }
+    }
+    if (!valid)
+    {
+        std::cout << "ERROR: Broken asset pack: " << path << std::endl;
+        close();
+        return false;
+    }
+
+    // the whole pack is used at startup: read ahead at once instead of page faults per file
+    file.prefetch();
+    return true;
+}
+
+void AssetPack::close()
+{
+    file.close();
+    entries = nullptr;
+    names = nullptr;
+    count = 0;
+}
+
+std::string_view AssetPack::find(std::string_view name) const
+{
+    auto nameOf = [this](Entry const & entry) { return std::string_view(names + entry.nameOffset, entry.nameLength); };
+    Entry const * end = entries + count;
+    Entry const * entry = std::lower_bound(entries, end, name,
+                                           [&nameOf](Entry const & e, std::string_view n) { return nameOf(e) < n; });
+    if (entry == end || nameOf(*entry) != name)
+        return std::string_view();
+    return std::string_view(reinterpret_cast<const char *>(file.getData() + entry->offset), size_t(entry->size));
+}
+
+bool AssetPack::write(std::string const & path, std::vector<Source> const & sources)
+{
+    // entries are searched by name
+    std::vector<Source> sorted = sources;
+    std::sort(sorted.begin(), sorted.end(), [](Source const & a, Source const & b) { return a.name < b.name; });
+
+    std::vector<std::vector<char>> contents(sorted.size());
+    std::vector<Entry> table(sorted.size());
+    std::string nameTable;
+    for (size_t i = 0; i < sorted.size(); ++i)
+    {
+        if (!readFile(sorted[i].path, contents[i]))
+        {
+            std::cerr << "ERROR::ASSET_PACK::FILE_NOT_SUCCESFULLY_READ " << sorted[i].path << std::endl;
+            return false;
+        }
+        table[i].nameOffset = uint32_t(nameTable.size());
+        table[i].nameLength = uint32_t(sorted[i].name.size());
+        nameTable += sorted[i].name;
+    }
+
+    Header header{};
+    std::memcpy(header.magic, MAGIC, sizeof(MAGIC));
+    header.version = VERSION;
+    header.entryCount = uint32_t(table.size());
+    header.namesSize = uint32_t(nameTable.size());
+
+    // equal contents are stored once: entries point at the first file with that content
+    std::unordered_map<uint64_t, std::vector<size_t>> byHash;
+    std::vector<size_t> stored;
+    uint64_t offset = alignUp(sizeof(Header) + table.size() * sizeof(Entry) + nameTable.size());
+    for (size_t i = 0; i < table.size(); ++i)
+    {
+        table[i].size = contents[i].size();
+        std::vector<size_t> & candidates = byHash[AssetCache::hash(contents[i].data(), contents[i].size())];
+        auto same = std::find_if(candidates.begin(), candidates.end(),
+                                 [&](size_t j) { return contents[j] == contents[i]; });
+        if (same != candidates.end())
+        {
+            table[i].offset = table[*same].offset;
+            continue;
+        }
+        candidates.push_back(i);
+        stored.push_back(i);
+        table[i].offset = offset;
+        offset = alignUp(offset + table[i].size);
+    }
+
+    std::ofstream file(path, std::ios::binary);
+    file.write(reinterpret_cast<char const *>(&header), sizeof(header));
+    file.write(reinterpret_cast<char const *>(table.data()), std::streamsize(table.size() * sizeof(Entry)));
+    file.write(nameTable.data(), std::streamsize(nameTable.size()));
+    uint64_t position = sizeof(Header) + table.size() * sizeof(Entry) + nameTable.size();
+    const char padding[DATA_ALIGNMENT] = {};
+    for (size_t i : stored)
+    {
+        file.write(padding, std::streamsize(table[i].offset - position));
+        file.write(contents[i].data(), std::streamsize(contents[i].size()));
+        position = table[i].offset + table[i].size;
+    }
+
+    if (!file)
+    {
+        std::cerr << "ERROR::ASSET_PACK::FILE_NOT_SUCCESFULLY_WRITTEN " << path << std::endl;
+        return false;
+    }
+    return true;
+}
+
+AssetPack & AssetPack::mounted()
+{
+    static AssetPack pack;
+    return pack;
+}
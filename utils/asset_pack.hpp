@@ -0,0 +1,69 @@
+#pragma once
+
+#include "mapped_file.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+//! @brief Read-only archive of the build assets (shaders, images and baked textures) written by assetpack:
+//! header, entries sorted by name, name table, then file contents (16 byte aligned, native byte order).
+//! Files with the same content (e.g. an image copied into two lessons) are stored once, their entries share the offset.
+//! The whole pack is one mapping: entries are views into it, no per-file open, read or copy.
+//! Entry names are paths relative to the build folder, as lessons open them ("shaders/<lesson>/object.vs").
+class AssetPack
+{
+public:
+    //! @brief Pack of the build folder, opened by lessons and benchmarks if it exists
+    static constexpr const char * FILE_DEFAULT = "assets.pack";
+    static const uint32_t VERSION = 1;
+
+    struct Header
+    {
+        char magic[4];  // "LGPK"
+        uint32_t version;
+        uint32_t entryCount;
+        uint32_t namesSize;
+    };
+
+    struct Entry
+    {
+        //! @brief From start of file
+        uint64_t offset;
+        uint64_t size;
+        //! @brief In name table
+        uint32_t nameOffset;
+        uint32_t nameLength;
+    };
+
+    //! @brief File to pack: entry name and path on disk
+    struct Source
+    {
+        std::string name;
+        std::string path;
+    };
+
+    // map pack and check its index, false if it does not exist or is broken (pack stays closed)
+    bool open(std::string const & path);
+    void close();
+    bool isOpen() const { return file.isOpen(); }
+    size_t entryCount() const { return count; }
+
+    // content of entry (empty view if pack has no such entry); valid while pack is open
+    std::string_view find(std::string_view name) const;
+
+    // write pack of the files, false if some file cannot be read or pack cannot be written
+    static bool write(std::string const & path, std::vector<Source> const & sources);
+
+    // pack used by Shader and TextureLoader before they go to loose files; open it before loading assets,
+    // it is read from worker threads afterwards
+    static AssetPack & mounted();
+
+private:
+    MappedFile file;
+    Entry const * entries{nullptr};
+    const char * names{nullptr};
+    size_t count{0};
+};
@@ -0,0 +1,158 @@
+#include "baked_texture.hpp"
+
+#include <glad/glad.h>
+
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+
+namespace
+{
+    const char MAGIC[4] = {'L', 'G', 'T', 'X'};
+    const uint64_t DATA_ALIGNMENT = 16;
+
+    uint64_t alignUp(uint64_t value)
+    {
+        return (value + DATA_ALIGNMENT - 1) / DATA_ALIGNMENT * DATA_ALIGNMENT;
+    }
+}
+
+namespace BakedTexture
+{
+    std::string pathFor(std::string const & imagePath)
+    {
+        size_t dot = imagePath.find_last_of('.');
+        size_t slash = imagePath.find_last_of("/\\");
+        if (dot == std::string::npos || (slash != std::string::npos && dot < slash))
+            return imagePath + EXTENSION;
+        return imagePath.substr(0, dot) + EXTENSION;
+    }
+
+    uint32_t levelCount(uint32_t width, uint32_t height)
+    {
+        uint32_t count = 1;
+        for (uint32_t size = std::max(width, height); size > 1; size /= 2)
+            ++count;
+        return count;
+    }
+
+    bool parse(const unsigned char * data, size_t size, View & view)
+    {
+        if (size < sizeof(Header))
+            return false;
+        auto header = reinterpret_cast<Header const *>(data);
+        if (std::memcmp(header->magic, MAGIC, sizeof(MAGIC)) != 0 || header->version != VERSION
+            || header->levelCount == 0 || header->levelCount > levelCount(header->width, header->height))
+        {
+            return false;
+        }
+        if (size < sizeof(Header) + header->levelCount * sizeof(Level))
+            return false;
+
+        auto levels = reinterpret_cast<Level const *>(data + sizeof(Header));
+        for (uint32_t i = 0; i < header->levelCount; ++i)
+        {
+            if (levels[i].offset > size || levels[i].size > size - levels[i].offset)
+                return false;
+        }
+        view.header = header;
+        view.levels = levels;
+        view.file = data;
+        return true;
+    }
+
+    bool formatFor(int components, bool srgb, Format & format)
+    {
+        switch (components)
+        {
+            case 1: format = Format{GL_R8, GL_RED, GL_UNSIGNED_BYTE}; return true;
+            case 2: format = Format{GL_RG8, GL_RG, GL_UNSIGNED_BYTE}; return true;
+            case 3: format = Format{srgb ? GLenum(GL_SRGB8) : GLenum(GL_RGB8), GL_RGB, GL_UNSIGNED_BYTE}; return true;
+            case 4: format = Format{srgb ? GLenum(GL_SRGB8_ALPHA8) : GLenum(GL_RGBA8), GL_RGBA, GL_UNSIGNED_BYTE}; return true;
+        }
+        return false;
+    }
+
+    int channelCount(uint32_t glFormat)
+    {
+        switch (glFormat)
+        {
+            case GL_RED: return 1;
+            case GL_RG: return 2;
+            case GL_RGB: return 3;
+            case GL_RGBA: return 4;
+        }
+        return 0;
+    }
+
+    std::string formatName(uint32_t glInternalFormat)
+    {
+        switch (glInternalFormat)
+        {
+            case GL_R8: return "R8";
+            case GL_RG8: return "RG8";
+            case GL_RGB8: return "RGB8";
+            case GL_RGBA8: return "RGBA8";
+            case GL_SRGB8: return "SRGB8";
+            case GL_SRGB8_ALPHA8: return "SRGB8_ALPHA8";
+            case COMPRESSED_RGB_S3TC_DXT1: return "BC1";
+            case COMPRESSED_SRGB_S3TC_DXT1: return "BC1_SRGB";
+            case COMPRESSED_RGBA_S3TC_DXT5: return "BC3";
+            case COMPRESSED_SRGB_ALPHA_S3TC_DXT5: return "BC3_SRGB";
+            case GL_COMPRESSED_RED_RGTC1: return "BC4";
+            case GL_COMPRESSED_RG_RGTC2: return "BC5";
+            case COMPRESSED_RGB8_ETC2: return "ETC2_RGB8";
+            case COMPRESSED_RGBA8_ETC2_EAC: return "ETC2_RGBA8";
+        }
+        char name[16];
+        std::snprintf(name, sizeof(name), "0x%04X", glInternalFormat);
+        return name;
+    }
+
+    bool write(std::string const & path, uint32_t width, uint32_t height, Format const & format, uint32_t flags,
+               std::vector<std::vector<unsigned char>> const & levels)
+    {
+        Header header{};
+        std::memcpy(header.magic, MAGIC, sizeof(MAGIC));
+        header.version = VERSION;
+        header.flags = format.glFormat == 0 ? flags | COMPRESSED : flags;
+        header.glInternalFormat = format.glInternalFormat;
+        header.glFormat = format.glFormat;
+        header.glType = format.glType;
+        header.width = width;
+        header.height = height;
+        header.levelCount = uint32_t(levels.size());
+
+        std::vector<Level> table(levels.size());
+        uint64_t offset = alignUp(sizeof(Header) + table.size() * sizeof(Level));
+        for (size_t i = 0; i < levels.size(); ++i)
+        {
+            table[i].width = std::max(width >> i, 1u);
+            table[i].height = std::max(height >> i, 1u);
+            table[i].size = levels[i].size();
+            table[i].offset = offset;
+            offset = alignUp(offset + table[i].size);
+        }
+
+        std::ofstream file(path, std::ios::binary);
+        file.write(reinterpret_cast<char const *>(&header), sizeof(header));
+        file.write(reinterpret_cast<char const *>(table.data()), table.size() * sizeof(Level));
+        uint64_t position = sizeof(Header) + table.size() * sizeof(Level);
+        const char padding[DATA_ALIGNMENT] = {};
+        for (size_t i = 0; i < levels.size(); ++i)
+        {
+            file.write(padding, std::streamsize(table[i].offset - position));
+            file.write(reinterpret_cast<char const *>(levels[i].data()), std::streamsize(levels[i].size()));
+            position = table[i].offset + table[i].size;
+        }
+
+        if (!file)
+        {
+            std::cerr << "ERROR::BAKED_TEXTURE::FILE_NOT_SUCCESFULLY_WRITTEN " << path << std::endl;
+            return false;
+        }
+        return true;
+    }
+}
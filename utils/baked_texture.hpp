@@ -0,0 +1,93 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+//! @brief GPU-ready texture file written by texbake (KTX-like layout, native byte order):
+//! header, levelCount level records, then pixel data of all mip levels, largest first.
+//! Rows are tightly packed (upload with GL_UNPACK_ALIGNMENT 1), level data is 16 byte aligned.
+//! Internal format is sized (storage for glTexStorage2D). Compressed levels (COMPRESSED flag) are blocks
+//! for glCompressedTexImage2D, glFormat and glType are 0 then.
+namespace BakedTexture
+{
+    //! @brief File extension, file "name.btex" is the baked version of "name.png"/"name.jpg"
+    static const char * const EXTENSION = ".btex";
+    static const uint32_t VERSION = 3;
+
+    enum Flags : uint32_t
+    {
+        FLIPPED_VERTICALLY = 1u << 0,  // first row is the bottom row of the image (stbi flip on load)
+        COMPRESSED = 1u << 1,
+        SRGB = 1u << 2,  // color channels are sRGB encoded (sRGB internal format where one exists)
+    };
+
+    // compressed formats of extensions (not in GL 3.3 core header); RGTC (BC4/BC5) is core
+    static const uint32_t COMPRESSED_RGB_S3TC_DXT1 = 0x83F0;   // BC1, EXT_texture_compression_s3tc
+    static const uint32_t COMPRESSED_RGBA_S3TC_DXT5 = 0x83F3;  // BC3
+    static const uint32_t COMPRESSED_SRGB_S3TC_DXT1 = 0x8C4C;  // EXT_texture_sRGB
+    static const uint32_t COMPRESSED_SRGB_ALPHA_S3TC_DXT5 = 0x8C4F;
+    static const uint32_t COMPRESSED_RGB8_ETC2 = 0x9274;       // ARB_ES3_compatibility
+    static const uint32_t COMPRESSED_RGBA8_ETC2_EAC = 0x9278;
+
+    //! @brief Arguments of glTexImage2D (glCompressedTexImage2D if format and type are 0)
+    struct Format
+    {
+        uint32_t glInternalFormat;
+        uint32_t glFormat;
+        uint32_t glType;
+    };
+
+    struct Header
+    {
+        char magic[4];  // "LGTX"
+        uint32_t version;
+        uint32_t flags;
+        //! @brief Arguments of glTexImage2D for all levels
+        uint32_t glInternalFormat;
+        uint32_t glFormat;
+        uint32_t glType;
+        uint32_t width;
+        uint32_t height;
+        uint32_t levelCount;
+        uint32_t _pad0;
+    };
+
+    struct Level
+    {
+        //! @brief From start of file
+        uint64_t offset;
+        uint64_t size;
+        uint32_t width;
+        uint32_t height;
+    };
+
+    //! @brief Parsed file in memory (pointers into the mapped file)
+    struct View
+    {
+        Header const * header{nullptr};
+        Level const * levels{nullptr};
+        const unsigned char * file{nullptr};
+    };
+
+    // baked file name for source image: extension is replaced with EXTENSION
+    std::string pathFor(std::string const & imagePath);
+
+    // number of levels of full mip chain down to 1x1
+    uint32_t levelCount(uint32_t width, uint32_t height);
+
+    // check header and level table against file size, false if file is broken
+    bool parse(const unsigned char * data, size_t size, View & view);
+
+    // sized uncompressed format of 1-4 channel image (stb_image components), sRGB for 3 and 4 channels if asked
+    bool formatFor(int components, bool srgb, Format & format);
+    // channels of uncompressed pixel format (GL_RED 1 ... GL_RGBA 4), 0 for compressed and unknown formats
+    int channelCount(uint32_t glFormat);
+    // short name of internal format for reports ("RGBA8", "BC1", ...)
+    std::string formatName(uint32_t glInternalFormat);
+
+    // write file, levels[i] holds pixels (or blocks) of level i, level 0 is width x height
+    bool write(std::string const & path, uint32_t width, uint32_t height, Format const & format, uint32_t flags,
+               std::vector<std::vector<unsigned char>> const & levels);
+}
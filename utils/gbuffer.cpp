@@ -0,0 +1,83 @@
+#include "gbuffer.hpp"
+
+#include <iostream>
+
+namespace
+{
+    // storage of a fetched-only texture: no mipmaps, nearest filter (texelFetch needs a complete texture)
+    unsigned int createTexture(GLenum internalFormat, GLenum format, GLenum type, int width, int height)
+    {
+        unsigned int texture = 0;
+        glGenTextures(1, &texture);
+        glBindTexture(GL_TEXTURE_2D, texture);
+        glTexImage2D(GL_TEXTURE_2D, 0, GLint(internalFormat), width, height, 0, format, type, nullptr);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+        return texture;
+    }
+}
+
+bool GBuffer::create(int w, int h)
+{
+    width = w;
+    height = h;
+
+    colorTextures[ALBEDO_SPECULAR] = createTexture(GL_RGBA8, GL_RGBA, GL_UNSIGNED_BYTE, width, height);
+    colorTextures[NORMAL_MATERIAL] = createTexture(GL_RGB10_A2, GL_RGBA, GL_UNSIGNED_INT_2_10_10_10_REV, width, height);
+    colorTextures[EMISSION] = createTexture(GL_RGBA8, GL_RGBA, GL_UNSIGNED_BYTE, width, height);
+    depthTexture = createTexture(GL_DEPTH_COMPONENT24, GL_DEPTH_COMPONENT, GL_UNSIGNED_INT, width, height);
+    glBindTexture(GL_TEXTURE_2D, 0);
+
+    glGenFramebuffers(1, &ID);
+    glBindFramebuffer(GL_FRAMEBUFFER, ID);
+    std::array<GLenum, COUNT> drawBuffers;
+    for (unsigned int i = 0; i < COUNT; ++i)
+    {
+        glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0 + i, GL_TEXTURE_2D, colorTextures[i], 0);
+        drawBuffers[i] = GL_COLOR_ATTACHMENT0 + i;
+    }
+    glFramebufferTexture2D(GL_FRAMEBUFFER, GL_DEPTH_ATTACHMENT, GL_TEXTURE_2D, depthTexture, 0);
+    glDrawBuffers(COUNT, drawBuffers.data());
+
+    GLenum status = glCheckFramebufferStatus(GL_FRAMEBUFFER);
+    if (status != GL_FRAMEBUFFER_COMPLETE)
+    {
+        std::cerr << "ERROR::GBUFFER::INCOMPLETE 0x" << std::hex << status << std::dec << std::endl;
+        return false;
+    }
+    return true;
+}
+
+void GBuffer::bindGeometry() const
+{
+    glBindFramebuffer(GL_FRAMEBUFFER, ID);
+    glViewport(0, 0, width, height);
+    // zero flags: no fragment; albedo and emission of such pixels are never read
+    const GLfloat noFragment[4] = {0.0f, 0.0f, 0.0f, 0.0f};
+    const GLfloat farDepth = 1.0f;
+    glClearBufferfv(GL_COLOR, NORMAL_MATERIAL, noFragment);
+    glClearBufferfv(GL_DEPTH, 0, &farDepth);
+}
+
+void GBuffer::bindTextures(GLuint firstUnit) const
+{
+    for (unsigned int i = 0; i < COUNT; ++i)
+    {
+        glActiveTexture(GL_TEXTURE0 + firstUnit + i);
+        glBindTexture(GL_TEXTURE_2D, colorTextures[i]);
+    }
+    glActiveTexture(GL_TEXTURE0 + firstUnit + COUNT);
+    glBindTexture(GL_TEXTURE_2D, depthTexture);
+}
+
+void GBuffer::destroy()
+{
+    glDeleteFramebuffers(1, &ID);
+    glDeleteTextures(COUNT, colorTextures.data());
+    glDeleteTextures(1, &depthTexture);
+    ID = depthTexture = 0;
+    colorTextures.fill(0);
+    width = height = 0;
+}
@@ -0,0 +1,45 @@
+#pragma once
+
+#include <glad/glad.h>
+
+#include <array>
+
+//! @brief Compact G-buffer of deferred shading: material and normal of the nearest fragment of every pixel,
+//! written by the geometry pass and read by the lighting pass with texelFetch (channel layout is up to the shaders).
+//! Attachments: ALBEDO_SPECULAR RGBA8, NORMAL_MATERIAL RGB10_A2 (flags in alpha, zero where nothing was drawn),
+//! EMISSION RGBA8 (read only where a flag says so) and 24 bit depth, position is reconstructed from depth.
+class GBuffer
+{
+public:
+    //! @brief Color attachments in draw buffer order (output locations of the geometry pass)
+    enum Attachment : unsigned int
+    {
+        ALBEDO_SPECULAR = 0,
+        NORMAL_MATERIAL = 1,
+        EMISSION = 2,
+        COUNT = 3
+    };
+    // bytes per pixel of all attachments and depth
+    static constexpr unsigned int BYTES_PER_PIXEL = 4 * COUNT + 4;
+
+    // create attachments of given size (false if framebuffer is incomplete)
+    bool create(int width, int height);
+    // bind for geometry pass and set viewport: only NORMAL_MATERIAL and depth are cleared, other attachments are
+    // read where the flags of NORMAL_MATERIAL say a fragment was written
+    void bindGeometry() const;
+    // bind attachments to texture units firstUnit..firstUnit+2 (attachment order) and depth to firstUnit+3
+    void bindTextures(GLuint firstUnit) const;
+    // free GL objects, call before context is destroyed
+    void destroy();
+
+    int getWidth() const { return width; }
+    int getHeight() const { return height; }
+
+private:
+    //! @brief Framebuffer id
+    unsigned int ID{0};
+    std::array<unsigned int, COUNT> colorTextures{};
+    unsigned int depthTexture{0};
+    int width{0};
+    int height{0};
+};
@@ -0,0 +1,86 @@
+#include "headless_context.hpp"
+
+#include <glad/glad.h>
+
+#include <iostream>
+
+#ifdef HEADLESS_EGL
+#include <EGL/egl.h>
+#include <EGL/eglext.h>
+
+bool HeadlessContext::create()
+{
+    // prefer surfaceless platform: it needs neither X server nor GPU device
+    auto getPlatformDisplay = (PFNEGLGETPLATFORMDISPLAYEXTPROC)eglGetProcAddress("eglGetPlatformDisplayEXT");
+    EGLDisplay eglDisplay = EGL_NO_DISPLAY;
+    if (getPlatformDisplay)
+        eglDisplay = getPlatformDisplay(EGL_PLATFORM_SURFACELESS_MESA, EGL_DEFAULT_DISPLAY, NULL);
+    if (eglDisplay == EGL_NO_DISPLAY)
+        eglDisplay = eglGetDisplay(EGL_DEFAULT_DISPLAY);
+
+    EGLint major = 0, minor = 0;
+    if (eglDisplay == EGL_NO_DISPLAY || !eglInitialize(eglDisplay, &major, &minor))
+    {
+        std::cerr << "ERROR::HEADLESS::EGL_INIT_FAILED" << std::endl;
+        return false;
+    }
+    if (!eglBindAPI(EGL_OPENGL_API))
+    {
+        std::cerr << "ERROR::HEADLESS::OPENGL_API_NOT_SUPPORTED" << std::endl;
+        eglTerminate(eglDisplay);
+        return false;
+    }
+
+    const EGLint contextAttribs[] = {
+        EGL_CONTEXT_MAJOR_VERSION, 3,
+        EGL_CONTEXT_MINOR_VERSION, 3,
+        EGL_CONTEXT_OPENGL_PROFILE_MASK, EGL_CONTEXT_OPENGL_CORE_PROFILE_BIT,
+        EGL_NONE
+    };
+    // no surface is ever created, so config is not needed (EGL_KHR_no_config_context)
+    EGLContext eglContext = eglCreateContext(eglDisplay, EGL_NO_CONFIG_KHR, EGL_NO_CONTEXT, contextAttribs);
+    if (eglContext == EGL_NO_CONTEXT || !eglMakeCurrent(eglDisplay, EGL_NO_SURFACE, EGL_NO_SURFACE, eglContext))
+    {
+        std::cerr << "ERROR::HEADLESS::CONTEXT_CREATION_FAILED 0x" << std::hex << eglGetError() << std::dec << std::endl;
+        eglTerminate(eglDisplay);
+        return false;
+    }
+
+    if (!gladLoadGLLoader((GLADloadproc)eglGetProcAddress))
+    {
+        std::cerr << "Failed to initialize GLAD" << std::endl;
+        eglDestroyContext(eglDisplay, eglContext);
+        eglTerminate(eglDisplay);
+        return false;
+    }
+
+    display = eglDisplay;
+    context = eglContext;
+    std::cout << "Headless context: " << glGetString(GL_RENDERER) << ", " << glGetString(GL_VERSION) << std::endl;
+    return true;
+}
+
+void HeadlessContext::destroy()
+{
+    if (display == nullptr)
+        return;
+    eglMakeCurrent(display, EGL_NO_SURFACE, EGL_NO_SURFACE, EGL_NO_CONTEXT);
+    eglDestroyContext(display, context);
+    eglTerminate(display);
+    display = nullptr;
+    context = nullptr;
+}
+
+#else
+
+bool HeadlessContext::create()
+{
+    std::cerr << "ERROR::HEADLESS::NOT_SUPPORTED (built without EGL)" << std::endl;
+    return false;
+}
+
+void HeadlessContext::destroy()
+{
+}
+
+#endif
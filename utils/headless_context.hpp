@@ -0,0 +1,16 @@
+#pragma once
+
+//! @brief OpenGL 3.3 core context without window system and GPU requirements.
+//! Uses EGL surfaceless platform (Mesa llvmpipe works). Render into OffscreenTarget.
+class HeadlessContext
+{
+public:
+    // create context, make it current and load GL functions with glad
+    bool create();
+    // release context (GL objects must be deleted before)
+    void destroy();
+
+private:
+    void * display{nullptr};
+    void * context{nullptr};
+};
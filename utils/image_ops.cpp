@@ -0,0 +1,69 @@
+#include "image_ops.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+
+namespace ImageOps
+{
+    std::vector<unsigned char> downsample(std::vector<unsigned char> const & source, int width, int height,
+                                          int components)
+    {
+        int w = std::max(width / 2, 1);
+        int h = std::max(height / 2, 1);
+        std::vector<unsigned char> result(size_t(w) * size_t(h) * size_t(components));
+        for (int y = 0; y < h; ++y)
+        {
+            int y0 = std::min(2 * y, height - 1);
+            int y1 = std::min(2 * y + 1, height - 1);
+            for (int x = 0; x < w; ++x)
+            {
+                int x0 = std::min(2 * x, width - 1);
+                int x1 = std::min(2 * x + 1, width - 1);
+                for (int c = 0; c < components; ++c)
+                {
+                    unsigned sum = source[(size_t(y0) * width + x0) * components + c]
+                                 + source[(size_t(y0) * width + x1) * components + c]
+                                 + source[(size_t(y1) * width + x0) * components + c]
+                                 + source[(size_t(y1) * width + x1) * components + c];
+                    result[(size_t(y) * w + x) * components + c] = static_cast<unsigned char>((sum + 2) / 4);
+                }
+            }
+        }
+        return result;
+    }
+
+    std::vector<unsigned char> resize(const unsigned char * source, int width, int height, int components,
+                                      int newWidth, int newHeight)
+    {
+        std::vector<unsigned char> result(size_t(newWidth) * size_t(newHeight) * size_t(components));
+        float scaleX = float(width) / float(newWidth);
+        float scaleY = float(height) / float(newHeight);
+        for (int y = 0; y < newHeight; ++y)
+        {
+            float sy = std::min(std::max((float(y) + 0.5f) * scaleY - 0.5f, 0.0f), float(height - 1));
+            int y0 = int(sy);
+            int y1 = std::min(y0 + 1, height - 1);
+            float fy = sy - float(y0);
+            for (int x = 0; x < newWidth; ++x)
+            {
+                float sx = std::min(std::max((float(x) + 0.5f) * scaleX - 0.5f, 0.0f), float(width - 1));
+                int x0 = int(sx);
+                int x1 = std::min(x0 + 1, width - 1);
+                float fx = sx - float(x0);
+                for (int c = 0; c < components; ++c)
+                {
+                    auto texel = [&](int tx, int ty) {
+                        return float(source[(size_t(ty) * size_t(width) + size_t(tx)) * size_t(components) + size_t(c)]);
+                    };
+                    float top = texel(x0, y0) + (texel(x1, y0) - texel(x0, y0)) * fx;
+                    float bottom = texel(x0, y1) + (texel(x1, y1) - texel(x0, y1)) * fx;
+                    float value = top + (bottom - top) * fy;
+                    result[(size_t(y) * size_t(newWidth) + size_t(x)) * size_t(components) + size_t(c)] =
+                        static_cast<unsigned char>(std::lround(value));
+                }
+            }
+        }
+        return result;
+    }
+}
@@ -0,0 +1,15 @@
+#pragma once
+
+#include <vector>
+
+//! @brief CPU operations on 8 bit images with interleaved channels (rows top to bottom, tightly packed)
+namespace ImageOps
+{
+    // next mip level: average of 2x2 texels (edge texels repeat for odd sizes)
+    std::vector<unsigned char> downsample(std::vector<unsigned char> const & source, int width, int height,
+                                          int components);
+
+    // bilinear resampling to new size (texel centers aligned, edges clamped)
+    std::vector<unsigned char> resize(const unsigned char * source, int width, int height, int components,
+                                      int newWidth, int newHeight);
+}
@@ -0,0 +1,141 @@
+#include "input_recorder.hpp"
+
+#include <cstring>
+#include <fstream>
+#include <iostream>
+
+namespace
+{
+    //! @brief File header, followed by eventCount Event records (native byte order)
+    struct Header
+    {
+        char magic[4];
+        uint32_t version;
+        uint32_t frameCount;
+        float deltaTime;
+        uint32_t eventCount;
+    };
+
+    const char MAGIC[4] = {'L', 'G', 'I', 'R'};
+    const uint32_t VERSION = 1;
+}
+
+static_assert(sizeof(InputRecorder::Event) == 16, "Event record layout is part of the file format");
+
+bool InputRecorder::parseArgument(int argc, char ** argv, int & i)
+{
+    std::string arg = argv[i];
+    if (arg != "--record" && arg != "--replay")
+        return false;
+
+    if (i + 1 >= argc)
+    {
+        std::cerr << "ERROR::INPUT_RECORDER::FILE_NOT_SPECIFIED " << arg << std::endl;
+        return true;
+    }
+    mode = arg == "--record" ? RECORD : REPLAY;
+    path = argv[++i];
+    return true;
+}
+
+bool InputRecorder::load()
+{
+    if (mode != REPLAY)
+        return true;
+
+    std::ifstream file(path, std::ios::binary);
+    Header header{};
+    if (!file.read(reinterpret_cast<char *>(&header), sizeof(header))
+        || std::memcmp(header.magic, MAGIC, sizeof(MAGIC)) != 0
+        || header.version != VERSION)
+    {
+        std::cerr << "ERROR::INPUT_RECORDER::FILE_NOT_SUCCESFULLY_READ " << path << std::endl;
+        return false;
+    }
+
+    // event count of a broken file must not decide the allocation: records have to fit in the rest of the file
+    std::streamoff recordsStart = file.tellg();
+    file.seekg(0, std::ios::end);
+    std::streamoff remaining = file.tellg() - recordsStart;
+    file.seekg(recordsStart);
+    bool complete = uint64_t(header.eventCount) * sizeof(Event) <= uint64_t(remaining);
+    if (complete)
+        events.resize(header.eventCount);
+    if (!complete || !file.read(reinterpret_cast<char *>(events.data()), events.size() * sizeof(Event)))
+    {
+        std::cerr << "ERROR::INPUT_RECORDER::FILE_TRUNCATED " << path << std::endl;
+        events.clear();
+        return false;
+    }
+    frameCount = header.frameCount;
+    deltaTime = header.deltaTime;
+    next = 0;
+    std::cout << "Replay " << path << ": " << frameCount << " frames, " << events.size() << " events" << std::endl;
+    return true;
+}
+
+bool InputRecorder::save() const
+{
+    if (mode != RECORD)
+        return true;
+
+    Header header{};
+    std::memcpy(header.magic, MAGIC, sizeof(MAGIC));
+    header.version = VERSION;
+    header.frameCount = frameCount;
+    header.deltaTime = deltaTime;
+    header.eventCount = uint32_t(events.size());
+
+    std::ofstream file(path, std::ios::binary);
+    file.write(reinterpret_cast<char const *>(&header), sizeof(header));
+    file.write(reinterpret_cast<char const *>(events.data()), events.size() * sizeof(Event));
+    if (!file)
+    {
+        std::cerr << "ERROR::INPUT_RECORDER::FILE_NOT_SUCCESFULLY_WRITTEN " << path << std::endl;
+        return false;
+    }
+    std::cout << "Recorded " << path << ": " << frameCount << " frames, " << events.size() << " events" << std::endl;
+    return true;
+}
+
+void InputRecorder::beginFrame(int currentFrame)
+{
+    frame = uint32_t(currentFrame);
+    if (mode == RECORD)
+        frameCount = frame + 1;
+}
+
+void InputRecorder::move(Camera & camera, Camera::Movement direction, float dt)
+{
+    camera.ProcessKeyboard(direction, dt);
+    push(MOVE, uint8_t(direction), dt, 0.0f);
+}
+
+void InputRecorder::look(Camera & camera, float xoffset, float yoffset)
+{
+    camera.ProcessMouseMovement(xoffset, yoffset);
+    push(LOOK, 0, xoffset, yoffset);
+}
+
+void InputRecorder::zoom(Camera & camera, float yoffset)
+{
+    camera.ProcessMouseScroll(yoffset);
+    push(ZOOM, 0, 0.0f, yoffset);
+}
+
+void InputRecorder::key(int glfwKey)
+{
+    push(KEY, uint8_t(glfwKey - KEY_BASE), 0.0f, 0.0f);
+}
+
+void InputRecorder::hold(int glfwKey, float dt)
+{
+    push(HOLD, uint8_t(glfwKey - KEY_BASE), dt, 0.0f);
+}
+
+void InputRecorder::push(EventType type, uint8_t code, float x, float y)
+{
+    if (mode != RECORD)
+        return;
+    events.push_back(Event{frame, type, code, 0, x, y});
+}
@@ -0,0 +1,105 @@
+#pragma once
+
+#include "camera.hpp"
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+//! @brief Records camera input and key toggles of a lesson to a binary file and replays them.
+//! Events are stamped with frame number, so replay with fixed time step renders the same frames
+//! in every run and frame times of two builds can be compared.
+class InputRecorder
+{
+public:
+    enum Mode
+    {
+        OFF,
+        RECORD,
+        REPLAY,
+    };
+
+    enum EventType : uint8_t
+    {
+        MOVE,  // Camera::ProcessKeyboard: code = direction, x = deltaTime
+        LOOK,  // Camera::ProcessMouseMovement: x, y = offsets
+        ZOOM,  // Camera::ProcessMouseScroll: y = offset
+        KEY,   // scene key press: code = GLFW key - KEY_BASE
+        HOLD,  // scene key held during frame: code = GLFW key - KEY_BASE, x = deltaTime
+    };
+
+    //! @brief File record, 16 bytes
+    struct Event
+    {
+        uint32_t frame;
+        EventType type;
+        uint8_t code;
+        uint16_t _pad0;
+        float x;
+        float y;
+    };
+
+    // consume "--record <file>" or "--replay <file>" at argv[i]
+    bool parseArgument(int argc, char ** argv, int & i);
+
+    // open replay file (no-op in other modes), false if file is missing or broken
+    bool load();
+    // write recording to file (no-op in other modes)
+    bool save() const;
+
+    Mode getMode() const { return mode; }
+    bool isReplaying() const { return mode == REPLAY; }
+    // replay: number of recorded frames and time step they are rendered with
+    int getFrameCount() const { return int(frameCount); }
+    float getDeltaTime() const { return deltaTime; }
+    // record: time step stored for replay
+    void setDeltaTime(float dt) { deltaTime = dt; }
+
+    // call before input of every frame
+    void beginFrame(int frame);
+    // call before events are polled: input from callbacks takes effect in next frame
+    void endFrame() { ++frame; }
+
+    // live input: apply to camera and record
+    void move(Camera & camera, Camera::Movement direction, float dt);
+    void look(Camera & camera, float xoffset, float yoffset);
+    void zoom(Camera & camera, float yoffset);
+    void key(int glfwKey);
+    void hold(int glfwKey, float dt);
+
+    // replay: apply camera events of current frame, call onKey(glfwKey) for key presses
+    // and onHold(glfwKey, dt) for held keys
+    template <typename KeyHandler, typename HoldHandler>
+    void replay(Camera & camera, KeyHandler && onKey, HoldHandler && onHold)
+    {
+        for (; next < events.size() && events[next].frame <= frame; ++next)
+        {
+            Event const & e = events[next];
+            if (e.frame < frame)
+                continue;
+            switch (e.type)
+            {
+                case MOVE: camera.ProcessKeyboard(Camera::Movement(e.code), e.x); break;
+                case LOOK: camera.ProcessMouseMovement(e.x, e.y); break;
+                case ZOOM: camera.ProcessMouseScroll(e.y); break;
+                case KEY: onKey(int(e.code) + KEY_BASE); break;
+                case HOLD: onHold(int(e.code) + KEY_BASE, e.x); break;
+            }
+        }
+    }
+
+private:
+    //! @brief GLFW keys start at 32 (space), so keys up to arrows (262-265) fit in one byte
+    static constexpr int KEY_BASE = 32;
+
+    void push(EventType type, uint8_t code, float x, float y);
+
+    Mode mode{OFF};
+    std::string path;
+
+    std::vector<Event> events;
+    size_t next{0};
+    uint32_t frame{0};
+    uint32_t frameCount{0};
+    float deltaTime{1.0f / 60.0f};
+};
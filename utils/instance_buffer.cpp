@@ -0,0 +1,81 @@
+#include "instance_buffer.hpp"
+
+#include <glm/gtc/type_ptr.hpp>
+
+#include <cmath>
+#include <cstddef>
+
+glm::mat3 normalMatrix(glm::mat4 const & model)
+{
+    glm::mat3 m(model);
+    // similarity transform: columns are orthogonal and have the same length
+    float length2 = glm::dot(m[0], m[0]);
+    float eps = 1e-5f * length2;
+    bool orthogonal = std::abs(glm::dot(m[0], m[1])) <= eps
+                   && std::abs(glm::dot(m[0], m[2])) <= eps
+                   && std::abs(glm::dot(m[1], m[2])) <= eps;
+    bool uniformScale = std::abs(glm::dot(m[1], m[1]) - length2) <= eps
+                     && std::abs(glm::dot(m[2], m[2]) - length2) <= eps;
+    if (orthogonal && uniformScale)
+        return m;
+    return glm::transpose(glm::inverse(m));
+}
+
+void InstanceBuffer::attach()
+{
+    if (ID == 0)
+        glGenBuffers(1, &ID);
+    glBindBuffer(GL_ARRAY_BUFFER, ID);
+    // mat4 attribute is passed as 4 vec4 columns
+    for (GLuint column = 0; column < 4; ++column)
+    {
+        GLuint location = InstanceAttrib::MODEL + column;
+        glVertexAttribPointer(location, 4, GL_FLOAT, GL_FALSE, sizeof(InstanceData),
+            (void*)(offsetof(InstanceData, model) + column * sizeof(glm::vec4)));
+        glEnableVertexAttribArray(location);
+        glVertexAttribDivisor(location, 1);
+    }
+    // mat3 attribute is passed as 3 vec3 columns
+    for (GLuint column = 0; column < 3; ++column)
+    {
+        GLuint location = InstanceAttrib::NORMAL_MATRIX + column;
+        glVertexAttribPointer(location, 3, GL_FLOAT, GL_FALSE, sizeof(InstanceData),
+            (void*)(offsetof(InstanceData, normal) + column * sizeof(glm::vec3)));
+        glEnableVertexAttribArray(location);
+        glVertexAttribDivisor(location, 1);
+    }
+}
+
+void InstanceBuffer::upload(std::vector<InstanceData> const & instances)
+{
+    if (ID == 0)
+        glGenBuffers(1, &ID);
+    glBindBuffer(GL_ARRAY_BUFFER, ID);
+    if (instances.size() > capacity)
+    {
+        capacity = instances.size();
+        glBufferData(GL_ARRAY_BUFFER, capacity * sizeof(InstanceData), instances.data(), GL_STREAM_DRAW);
+    }
+    else
+    {
+        glBufferData(GL_ARRAY_BUFFER, capacity * sizeof(InstanceData), nullptr, GL_STREAM_DRAW);
+        glBufferSubData(GL_ARRAY_BUFFER, 0, instances.size() * sizeof(InstanceData), instances.data());
+    }
+    count = GLsizei(instances.size());
+}
+
+void InstanceBuffer::destroy()
+{
+    glDeleteBuffers(1, &ID);
+    ID = 0;
+    capacity = 0;
+    count = 0;
+}
+
+void InstanceBuffer::setCurrent(InstanceData const & instance)
+{
+    for (GLuint column = 0; column < 4; ++column)
+        glVertexAttrib4fv(InstanceAttrib::MODEL + column, glm::value_ptr(instance.model[column]));
+    for (GLuint column = 0; column < 3; ++column)
+        glVertexAttrib3fv(InstanceAttrib::NORMAL_MATRIX + column, glm::value_ptr(instance.normal[column]));
+}
@@ -0,0 +1,61 @@
+#pragma once
+
+#include <glad/glad.h>
+#include <glm/glm.hpp>
+
+#include <vector>
+
+//! @brief Per-instance vertex attributes of a mesh
+struct InstanceData
+{
+    glm::mat4 model;
+    //! @brief Normal matrix, computed once per instance instead of once per vertex
+    glm::mat3 normal;
+};
+
+namespace InstanceAttrib
+{
+    // first location of "layout (location = 3) in mat4 aModel", takes 4 locations
+    const GLuint MODEL = 3;
+    // first location of "layout (location = 7) in mat3 aNormalMatrix", takes 3 locations
+    const GLuint NORMAL_MATRIX = 7;
+    // "layout (location = 10) in uint aMaterial" of scenes with materials (own buffer, not in InstanceData)
+    const GLuint MATERIAL = 10;
+    // "layout (location = 11) in uvec2 aLightList" of per-object light lists (LightCulling, own buffer)
+    const GLuint LIGHT_LIST = 11;
+}
+
+// transpose(inverse(mat3(model))). For rotation with uniform scale it is mat3(model) up to scale,
+// normals are normalized in fragment shader, so the inverse is skipped.
+glm::mat3 normalMatrix(glm::mat4 const & model);
+
+// instance of model transform with its normal matrix
+inline InstanceData makeInstance(glm::mat4 const & model)
+{
+    return InstanceData{model, normalMatrix(model)};
+}
+
+//! @brief Vertex buffer with per-instance attributes (glVertexAttribDivisor = 1).
+//! Same shader also serves single draws: with instance arrays disabled in VAO,
+//! setCurrent() feeds the attributes as constant values.
+class InstanceBuffer
+{
+public:
+    // describe instance attributes in currently bound VAO (creates GL buffer on first call)
+    void attach();
+    // upload instances, storage is orphaned to avoid waiting for draws of previous frame
+    void upload(std::vector<InstanceData> const & instances);
+    // number of uploaded instances
+    GLsizei size() const { return count; }
+    // free GL buffer, call before context is destroyed
+    void destroy();
+
+    // set constant instance attributes for next non-instanced draw
+    static void setCurrent(InstanceData const & instance);
+
+private:
+    //! @brief Buffer id
+    unsigned int ID{0};
+    size_t capacity{0};
+    GLsizei count{0};
+};
@@ -0,0 +1,261 @@
+#include "lesson_runner.hpp"
+
+#include "asset_pack.hpp"
+#include "input_recorder.hpp"
+#include "render_loop.hpp"
+#include "shader_library.hpp"
+#include "shader_watcher.hpp"
+#include "texture_loader.hpp"
+
+#include <chrono>
+#include <iostream>
+#include <string>
+#include <vector>
+
+namespace
+{
+    // settings
+    const unsigned int SCR_WIDTH = 800;
+    const unsigned int SCR_HEIGHT = 600;
+
+    // GLFW callbacks have no user pointer here: state of the running lesson
+    Scene * sScene = nullptr;
+    InputRecorder * sRecorder = nullptr;
+    std::vector<int> sHeldKeys;
+
+    float lastX = SCR_WIDTH / 2.0;
+    float lastY = SCR_HEIGHT / 2.0;
+    bool firstMouse = true;
+
+    // Key press: camera mode here, other keys by scene. Same path in live and replay mode.
+    // Returns true if key is used (and should be recorded)
+    bool applyKey(int key)
+    {
+        Camera & camera = sScene->getCamera();
+        switch (key)
+        {
+            case GLFW_KEY_LEFT_BRACKET:
+                if (camera.mode != Camera::FLY)
+                {
+                    camera.mode = Camera::FLY;
+                    std::cout << "FLY camera mode activated" << std::endl;
+                }
+                return true;
+            case GLFW_KEY_RIGHT_BRACKET:
+                if (camera.mode != Camera::FPS)
+                {
+                    camera.mode = Camera::FPS;
+                    std::cout << "FPS camera mode activated" << std::endl;
+                }
+                return true;
+        }
+        return sScene->onKeyPress(key);
+    }
+
+    // Process all input
+    // Keyboard
+    void processInput(GLFWwindow * window, float deltaTime)
+    {
+        if (glfwGetKey(window, GLFW_KEY_ESCAPE) == GLFW_PRESS)
+        {
+            std::cout << "ESC button pressed" << std::endl;
+            glfwSetWindowShouldClose(window, true);
+        }
+        // MY: Change polygone mode
+        if (glfwGetKey(window, GLFW_KEY_X) == GLFW_PRESS) { glPolygonMode(GL_FRONT_AND_BACK, GL_LINE); }
+        if (glfwGetKey(window, GLFW_KEY_X) == GLFW_RELEASE) { glPolygonMode(GL_FRONT_AND_BACK, GL_FILL); }
+        // ==========================
+        // scene keys
+        for (int key : sHeldKeys)
+        {
+            if (glfwGetKey(window, key) == GLFW_PRESS)
+            {
+                sRecorder->hold(key, deltaTime);
+                sScene->onKeyHeld(key, deltaTime);
+            }
+        }
+        // ===========================
+        // move camera
+        Camera & camera = sScene->getCamera();
+        if (glfwGetKey(window, GLFW_KEY_W) == GLFW_PRESS) { sRecorder->move(camera, Camera::FORWARD, deltaTime); }
+        if (glfwGetKey(window, GLFW_KEY_S) == GLFW_PRESS) { sRecorder->move(camera, Camera::BACKWARD, deltaTime); }
+        if (glfwGetKey(window, GLFW_KEY_A) == GLFW_PRESS) { sRecorder->move(camera, Camera::LEFT, deltaTime); }
+        if (glfwGetKey(window, GLFW_KEY_D) == GLFW_PRESS) { sRecorder->move(camera, Camera::RIGHT, deltaTime); }
+    }
+
+    // Key press (once per press, not every frame)
+    void key_callback(GLFWwindow * window, int key, int scancode, int action, int mods)
+    {
+        if (action == GLFW_PRESS && applyKey(key))
+            sRecorder->key(key);
+    }
+
+    // Mouse
+    void mouse_callback(GLFWwindow * window, double xposIn, double yposIn)
+    {
+        auto xpos = float(xposIn);
+        auto ypos = float(yposIn);
+
+        if (firstMouse)
+        {
+            firstMouse = false;
+            lastX = xpos;
+            lastY = ypos;
+        }
+
+        float xoffset = xpos - lastX;
+        float yoffset = lastY - ypos; // reversed since y-coordinates go from bottom to top
+
+        lastX = xpos;
+        lastY = ypos;
+
+        sRecorder->look(sScene->getCamera(), xoffset, yoffset);
+    }
+
+    // Scroll
+    void scroll_callback(GLFWwindow * window, double xoffset, double yoffset)
+    {
+        sRecorder->zoom(sScene->getCamera(), float(yoffset));
+    }
+
+    // react on window size changed
+    void framebuffer_size_callback(GLFWwindow * window, int w, int h)
+    {
+        glViewport(0, 0, w, h);
+        if (w > 0 && h > 0)
+            sScene->setViewport(w, h);
+    }
+}
+
+int runLesson(Scene & scene, int argc, char ** argv)
+{
+    // command line: [--headless [frames]] [--profile [file]] [--record|--replay file] [--watch-shaders] [scene options]
+    RenderLoop renderLoop;
+    InputRecorder inputRecorder;
+    ShaderWatcher & shaderWatcher = ShaderWatcher::active();
+    // a mistyped option would silently run (and time) other settings than asked for
+    bool unknownArguments = false;
+    for (int i = 1; i < argc; ++i)
+    {
+        if (!renderLoop.parseArgument(argc, argv, i)
+            && !inputRecorder.parseArgument(argc, argv, i)
+            && !shaderWatcher.parseArgument(argc, argv, i)
+            && !scene.parseArgument(argc, argv, i))
+        {
+            std::cerr << "Unknown argument: " << argv[i] << std::endl;
+            unknownArguments = true;
+        }
+    }
+    if (unknownArguments)
+    {
+        std::cerr << "ERROR::LESSON::UNKNOWN_ARGUMENTS" << std::endl;
+        return -1;
+    }
+    sScene = &scene;
+    sRecorder = &inputRecorder;
+    sHeldKeys = scene.heldKeys();
+
+    // replay renders recorded frames with fixed time step, with or without window
+    if (!inputRecorder.load())
+        return -1;
+    if (inputRecorder.isReplaying())
+        renderLoop.setFixedStep(inputRecorder.getFrameCount(), inputRecorder.getDeltaTime());
+
+    // 0. Initialization. Create window (or headless context), init GLAD.
+    if (!renderLoop.create(SCR_WIDTH, SCR_HEIGHT, "LearnOpenGL, Textures"))
+        return -1;
+    GLFWwindow * window = renderLoop.getWindow();
+    if (window)
+    {
+        glfwSetFramebufferSizeCallback(window, framebuffer_size_callback);
+        glfwSetKeyCallback(window, key_callback);
+        glfwSetCursorPosCallback(window, mouse_callback);
+        glfwSetScrollCallback(window, scroll_callback);
+        // tell GLFW to capture our mouse
+        glfwSetInputMode(window, GLFW_CURSOR, GLFW_CURSOR_DISABLED);
+    }
+
+    // profiling zones (--profile), scene adds its own
+    Profiler & profiler = renderLoop.getProfiler();
+    int inputZone = profiler.zone("input");
+    int texturesZone = profiler.zone("texture upload");
+
+    // 1. Prepare data: shaders, buffers of the scene; textures are decoded in background
+    auto prepareStart = std::chrono::steady_clock::now();
+    // shaders and textures come from the asset pack of the build if there is one
+    AssetPack & assetPack = AssetPack::mounted();
+    if (assetPack.open(AssetPack::FILE_DEFAULT))
+        std::cout << "Asset pack: " << AssetPack::FILE_DEFAULT << " (" << assetPack.entryCount() << " files)" << std::endl;
+    TextureLoader textureLoader;
+    textureLoader.create();
+    // programs of the scene are watched from their first build
+    shaderWatcher.start();
+    scene.setViewport(SCR_WIDTH, SCR_HEIGHT);
+    if (!scene.create(profiler, textureLoader))
+    {
+        shaderWatcher.stop();
+        textureLoader.destroy();
+        renderLoop.destroy();
+        return -1;
+    }
+
+    double prepareMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - prepareStart).count();
+    // warm start loads programs from the binary cache instead of compiling them
+    std::cout << "Programs: " << ShaderLibrary::submittedTotal() << " built (" << ShaderLibrary::cachedTotal()
+              << " from binary cache)" << std::endl;
+    std::cout << "End of preparation (" << prepareMs << " ms). Start main loop" << std::endl;
+
+    // RENDER LOOP
+    while (renderLoop.nextFrame())
+    {
+        // per-frame time logic
+        float deltaTime = renderLoop.getDeltaTime();
+        scene.setTime(renderLoop.getTime(), deltaTime);
+
+        // input (none in headless mode), recorded input in replay mode
+        {
+            ProfileZone zone(profiler, inputZone);
+            inputRecorder.beginFrame(renderLoop.getFrame());
+            if (inputRecorder.isReplaying())
+            {
+                inputRecorder.replay(scene.getCamera(), applyKey,
+                    [&scene](int key, float dt) { scene.onKeyHeld(key, dt); });
+            }
+            else if (window)
+            {
+                processInput(window, deltaTime);
+            }
+        }
+
+        // decoded textures replace placeholders, a few per frame
+        {
+            ProfileZone zone(profiler, texturesZone);
+            textureLoader.update();
+        }
+        // edited shader files: rebuilt programs replace the old ones
+        shaderWatcher.update();
+
+        scene.render();
+
+        // swap buffers and poll events (or finish headless frame)
+        inputRecorder.endFrame();
+        renderLoop.endFrame();
+    }
+
+    // texture storage in profiling report
+    for (TextureHandle::Info const & info : textureLoader.memory())
+        profiler.memory(info.describe(), info.bytes);
+
+    // de-allocate all resources once they've outlived their purpose
+    textureLoader.destroy();
+    shaderWatcher.stop();
+    scene.destroy();
+    assetPack.close();
+    inputRecorder.save();
+
+    // terminate, clearing all previously allocated GLFW (or headless) resources
+    renderLoop.destroy();
+    sScene = nullptr;
+    sRecorder = nullptr;
+    return 0;
+}
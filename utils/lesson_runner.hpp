@@ -0,0 +1,8 @@
+#pragma once
+
+#include "scene.hpp"
+
+//! @brief Lesson executable: window (or "--headless"), camera and key input with
+//! "--record"/"--replay", "--profile", lesson options of the scene; runs scene until window is closed.
+//! Returns exit code of main().
+int runLesson(Scene & scene, int argc, char ** argv);
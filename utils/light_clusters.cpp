@@ -0,0 +1,312 @@
+#include "light_clusters.hpp"
+
+#include "texture_buffer.hpp"
+
+#include <algorithm>
+#include <cmath>
+
+#if defined(__SSE2__) || defined(_M_X64)
+#define LIGHT_CLUSTERS_SSE2
+#include <emmintrin.h>
+#endif
+
+namespace
+{
+    const unsigned int TILES = LightClusters::TILES_X * LightClusters::TILES_Y;
+
+    // tile of normalized device coordinate, clamped to the screen
+    int tileOf(float ndc, unsigned int tiles)
+    {
+        int tile = int(std::floor((ndc * 0.5f + 0.5f) * float(tiles)));
+        return std::clamp(tile, 0, int(tiles) - 1);
+    }
+}
+
+void LightClusters::create(unsigned int threads)
+{
+    TextureBuffer::create(lightBuffer, lightTexture, GL_RGBA32F);
+    TextureBuffer::create(gridBuffer, gridTexture, GL_RG32UI);
+    TextureBuffer::create(indexBuffer, indexTexture, GL_R32UI);
+    grid.assign(2 * CLUSTERS, 0);
+
+    if (threads == 0)
+        threads = std::max(std::thread::hardware_concurrency(), 1u) - 1;
+    stopping = false;
+    for (unsigned int i = 0; i < threads; ++i)
+        workers.emplace_back(&LightClusters::workerLoop, this);
+}
+
+float LightClusters::sliceDepth(unsigned int slice) const
+{
+    return std::exp((float(slice) - depthBias) / depthScale);
+}
+
+void LightClusters::transform(View const & view, std::vector<Light> const & lights)
+{
+    size_t count = lights.size();
+    size_t padded = (count + 3) & ~size_t(3);
+    viewX.resize(padded);
+    viewY.resize(padded);
+    viewDepth.resize(padded);
+    radius.resize(padded);
+    for (Slice & slice : slices)
+        slice.candidates.clear();
+
+    // side planes of the frustum through the eye: outside if dot(center, plane normal) > radius
+    float cosX = 1.0f / std::sqrt(1.0f + tanHalfX * tanHalfX);
+    float sinX = tanHalfX * cosX;
+    float cosY = 1.0f / std::sqrt(1.0f + tanHalfY * tanHalfY);
+    float sinY = tanHalfY * cosY;
+    glm::mat4 const & m = view.view;
+
+    for (size_t i = 0; i < padded; i += 4)
+    {
+        // lanes past the last light are invisible
+        Light const * l[4];
+        for (size_t j = 0; j < 4; ++j)
+            l[j] = &lights[std::min(i + j, count - 1)];
+        unsigned int visible = 0;
+
+#ifdef LIGHT_CLUSTERS_SSE2
+        __m128 px = _mm_set_ps(l[3]->position.x, l[2]->position.x, l[1]->position.x, l[0]->position.x);
+        __m128 py = _mm_set_ps(l[3]->position.y, l[2]->position.y, l[1]->position.y, l[0]->position.y);
+        __m128 pz = _mm_set_ps(l[3]->position.z, l[2]->position.z, l[1]->position.z, l[0]->position.z);
+        __m128 r = _mm_set_ps(l[3]->radius, l[2]->radius, l[1]->radius, l[0]->radius);
+        // row of column-major view matrix times (p, 1)
+        auto row = [&](int k) {
+            return _mm_add_ps(_mm_add_ps(_mm_mul_ps(_mm_set1_ps(m[0][k]), px), _mm_mul_ps(_mm_set1_ps(m[1][k]), py)),
+                              _mm_add_ps(_mm_mul_ps(_mm_set1_ps(m[2][k]), pz), _mm_set1_ps(m[3][k])));
+        };
+        __m128 vx = row(0);
+        __m128 vy = row(1);
+        __m128 depth = _mm_sub_ps(_mm_setzero_ps(), row(2));
+
+        __m128 inside = _mm_and_ps(_mm_cmpgt_ps(_mm_add_ps(depth, r), _mm_set1_ps(near)),
+                                   _mm_cmplt_ps(_mm_sub_ps(depth, r), _mm_set1_ps(far)));
+        __m128 depthX = _mm_mul_ps(depth, _mm_set1_ps(sinX));
+        __m128 depthY = _mm_mul_ps(depth, _mm_set1_ps(sinY));
+        __m128 x = _mm_mul_ps(vx, _mm_set1_ps(cosX));
+        __m128 y = _mm_mul_ps(vy, _mm_set1_ps(cosY));
+        inside = _mm_and_ps(inside, _mm_cmple_ps(_mm_sub_ps(x, depthX), r));
+        inside = _mm_and_ps(inside, _mm_cmple_ps(_mm_sub_ps(_mm_setzero_ps(), _mm_add_ps(x, depthX)), r));
+        inside = _mm_and_ps(inside, _mm_cmple_ps(_mm_sub_ps(y, depthY), r));
+        inside = _mm_and_ps(inside, _mm_cmple_ps(_mm_sub_ps(_mm_setzero_ps(), _mm_add_ps(y, depthY)), r));
+        visible = unsigned(_mm_movemask_ps(inside));
+
+        _mm_storeu_ps(&viewX[i], vx);
+        _mm_storeu_ps(&viewY[i], vy);
+        _mm_storeu_ps(&viewDepth[i], depth);
+        _mm_storeu_ps(&radius[i], r);
+#else
+        for (size_t j = 0; j < 4; ++j)
+        {
+            glm::vec4 v = m * glm::vec4(l[j]->position, 1.0f);
+            float r = l[j]->radius;
+            float depth = -v.z;
+            bool inside = depth + r > near && depth - r < far
+                       && v.x * cosX - depth * sinX <= r && -v.x * cosX - depth * sinX <= r
+                       && v.y * cosY - depth * sinY <= r && -v.y * cosY - depth * sinY <= r;
+            visible |= inside ? 1u << j : 0u;
+            viewX[i + j] = v.x;
+            viewY[i + j] = v.y;
+            viewDepth[i + j] = depth;
+            radius[i + j] = r;
+        }
+#endif
+
+        // depth slices of visible lights
+        for (size_t j = 0; j < 4 && i + j < count; ++j)
+        {
+            if (!(visible & (1u << j)))
+                continue;
+            size_t k = i + j;
+            float front = std::max(viewDepth[k] - radius[k], near);
+            float back = std::min(viewDepth[k] + radius[k], far);
+            int first = std::clamp(int(std::floor(std::log(front) * depthScale + depthBias)), 0, int(SLICES) - 1);
+            int last = std::clamp(int(std::floor(std::log(back) * depthScale + depthBias)), 0, int(SLICES) - 1);
+            for (int s = first; s <= last; ++s)
+                slices[s].candidates.push_back(uint32_t(k));
+        }
+    }
+}
+
+void LightClusters::assignSlice(unsigned int s)
+{
+    Slice & slice = slices[s];
+    float sliceNear = sliceDepth(s);
+    float sliceFar = sliceDepth(s + 1);
+
+    // 1. tile rectangle of every candidate within the depth range of the slice
+    slice.rects.resize(slice.candidates.size());
+    slice.counts.fill(0);
+    size_t kept = 0;
+    for (uint32_t light : slice.candidates)
+    {
+        float r = radius[light];
+        float front = std::max(viewDepth[light] - r, sliceNear);
+        float back = std::min(viewDepth[light] + r, sliceFar);
+        if (front > back)
+            continue;
+        // x / depth is smallest at the front for negative x, at the back for positive x
+        float low = viewX[light] - r;
+        float high = viewX[light] + r;
+        float left = low / ((low < 0.0f ? front : back) * tanHalfX);
+        float right = high / ((high > 0.0f ? front : back) * tanHalfX);
+        low = viewY[light] - r;
+        high = viewY[light] + r;
+        float bottom = low / ((low < 0.0f ? front : back) * tanHalfY);
+        float top = high / ((high > 0.0f ? front : back) * tanHalfY);
+        if (right < -1.0f || left > 1.0f || top < -1.0f || bottom > 1.0f)
+            continue;
+
+        std::array<uint8_t, 4> rect = {uint8_t(tileOf(left, TILES_X)), uint8_t(tileOf(right, TILES_X)),
+                                       uint8_t(tileOf(bottom, TILES_Y)), uint8_t(tileOf(top, TILES_Y))};
+        for (unsigned int y = rect[2]; y <= rect[3]; ++y)
+            for (unsigned int x = rect[0]; x <= rect[1]; ++x)
+                ++slice.counts[y * TILES_X + x];
+        slice.candidates[kept] = light;
+        slice.rects[kept++] = rect;
+    }
+
+    // 2. lists of the tiles, back to back
+    uint32_t total = 0;
+    for (unsigned int t = 0; t < TILES; ++t)
+    {
+        slice.offsets[t] = total;
+        total += slice.counts[t];
+    }
+    slice.indices.resize(total);
+    std::array<uint32_t, TILES> cursor = slice.offsets;
+    for (size_t i = 0; i < kept; ++i)
+    {
+        std::array<uint8_t, 4> const & rect = slice.rects[i];
+        for (unsigned int y = rect[2]; y <= rect[3]; ++y)
+            for (unsigned int x = rect[0]; x <= rect[1]; ++x)
+                slice.indices[cursor[y * TILES_X + x]++] = slice.candidates[i];
+    }
+}
+
+void LightClusters::assignSlices()
+{
+    for (unsigned int s = nextSlice++; s < SLICES; s = nextSlice++)
+        assignSlice(s);
+}
+
+void LightClusters::update(View const & view, std::vector<Light> const & lights)
+{
+    tanHalfY = std::tan(0.5f * view.fovY);
+    tanHalfX = tanHalfY * view.aspect;
+    near = view.near;
+    far = view.far;
+    depthScale = float(SLICES) / std::log(far / near);
+    depthBias = -std::log(near) * depthScale;
+    width = std::max(view.width, 1);
+    height = std::max(view.height, 1);
+
+    if (lights.empty())
+    {
+        for (Slice & slice : slices)
+            slice.candidates.clear();
+    }
+    else
+    {
+        transform(view, lights);
+    }
+
+    // slices in parallel: workers and this thread take them one by one
+    nextSlice = 0;
+    if (!workers.empty())
+    {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            finished = 0;
+            ++generation;
+        }
+        jobStarted.notify_all();
+    }
+    assignSlices();
+    if (!workers.empty())
+    {
+        std::unique_lock<std::mutex> lock(mutex);
+        jobFinished.wait(lock, [this] { return finished == workers.size(); });
+    }
+
+    // froxel index = (slice * TILES_Y + y) * TILES_X + x
+    indices.clear();
+    maxCount = 0;
+    for (unsigned int s = 0; s < SLICES; ++s)
+    {
+        Slice const & slice = slices[s];
+        auto base = uint32_t(indices.size());
+        for (unsigned int t = 0; t < TILES; ++t)
+        {
+            grid[2 * (s * TILES + t)] = base + slice.offsets[t];
+            grid[2 * (s * TILES + t) + 1] = slice.counts[t];
+            maxCount = std::max(maxCount, slice.counts[t]);
+        }
+        indices.insert(indices.end(), slice.indices.begin(), slice.indices.end());
+    }
+
+    TextureBuffer::upload(GL_TEXTURE_BUFFER, lightBuffer, lights.size() * sizeof(Light), lights.data());
+    TextureBuffer::upload(GL_TEXTURE_BUFFER, gridBuffer, grid.size() * sizeof(uint32_t), grid.data());
+    TextureBuffer::upload(GL_TEXTURE_BUFFER, indexBuffer, indices.size() * sizeof(uint32_t), indices.data());
+}
+
+void LightClusters::bind(Shader const & shader, GLuint firstUnit) const
+{
+    unsigned int const textures[] = {lightTexture, gridTexture, indexTexture};
+    char const * const names[] = {"clusterLights", "clusterGrid", "clusterIndices"};
+    for (GLuint i = 0; i < 3; ++i)
+    {
+        glActiveTexture(GL_TEXTURE0 + firstUnit + i);
+        glBindTexture(GL_TEXTURE_BUFFER, textures[i]);
+        shader.setInt(names[i], int(firstUnit + i));
+    }
+    shader.setVec2("clusterScreen", float(TILES_X) / float(width), float(TILES_Y) / float(height));
+    shader.setVec2("clusterDepth", depthScale, depthBias);
+}
+
+void LightClusters::workerLoop()
+{
+    unsigned long seen = 0;
+    for (;;)
+    {
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            jobStarted.wait(lock, [this, seen] { return stopping || generation != seen; });
+            if (stopping)
+                return;
+            seen = generation;
+        }
+        assignSlices();
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            ++finished;
+        }
+        jobFinished.notify_one();
+    }
+}
+
+void LightClusters::stopWorkers()
+{
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stopping = true;
+    }
+    jobStarted.notify_all();
+    for (std::thread & worker : workers)
+        worker.join();
+    workers.clear();
+}
+
+void LightClusters::destroy()
+{
+    stopWorkers();
+    glDeleteTextures(1, &lightTexture);
+    glDeleteTextures(1, &gridTexture);
+    glDeleteTextures(1, &indexTexture);
+    glDeleteBuffers(1, &lightBuffer);
+    glDeleteBuffers(1, &gridBuffer);
+    glDeleteBuffers(1, &indexBuffer);
+    lightTexture = gridTexture = indexTexture = lightBuffer = gridBuffer = indexBuffer = 0;
+}
@@ -0,0 +1,141 @@
+#pragma once
+
+#include "shader.hpp"
+
+#include <glad/glad.h>
+#include <glm/glm.hpp>
+
+#include <array>
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+//! @brief Clustered forward shading: the view frustum is split into froxels (TILES_X x TILES_Y screen tiles times
+//! SLICES exponential depth slices) and every frame point lights are assigned on the CPU to the froxels their sphere
+//! touches. Fragment shader finds its froxel from gl_FragCoord and view depth and loops over its lights only,
+//! so per-fragment cost depends on the lights around the fragment, not on the total count.
+//! Assignment: view transform and frustum culling of 4 lights at once (SSE2), then depth slices in parallel
+//! (worker threads and the calling thread). Results are in three texture buffers:
+//! lights (2 RGBA32F texels each), grid (RG32UI offset and count per froxel) and light indices (R32UI).
+class LightClusters
+{
+public:
+    // must match CLUSTER_TILES_X, CLUSTER_TILES_Y and CLUSTER_SLICES of the shader
+    static constexpr unsigned int TILES_X = 16;
+    static constexpr unsigned int TILES_Y = 9;
+    static constexpr unsigned int SLICES = 24;
+    static constexpr unsigned int CLUSTERS = TILES_X * TILES_Y * SLICES;
+
+    //! @brief Point light as stored in the light buffer: texel 0 position and radius, texel 1 color
+    struct Light
+    {
+        glm::vec3 position;
+        //! @brief Distance where the light fades to zero (froxels beyond it do not list the light)
+        float radius;
+        glm::vec3 color;
+        float _pad0;
+    };
+    static_assert(sizeof(Light) == 32, "two RGBA32F texels per light");
+
+    //! @brief Camera of the frame (symmetric perspective projection)
+    struct View
+    {
+        glm::mat4 view;
+        //! @brief Vertical field of view, radians
+        float fovY;
+        float aspect;
+        float near;
+        float far;
+        //! @brief Viewport in pixels (screen tiles)
+        int width;
+        int height;
+    };
+
+    LightClusters() = default;
+    LightClusters(LightClusters const &) = delete;
+    LightClusters & operator=(LightClusters const &) = delete;
+    ~LightClusters() { stopWorkers(); }
+
+    // GL thread: texture buffers and worker threads (0 - one less than hardware threads, none on one core)
+    void create(unsigned int threads = 0);
+    // GL thread, once per frame: assign lights to froxels of the view and upload lights, grid and indices
+    void update(View const & view, std::vector<Light> const & lights);
+    // GL thread: bind the buffers to texture units firstUnit..firstUnit+2 and set cluster uniforms of the program
+    void bind(Shader const & shader, GLuint firstUnit) const;
+    // free GL objects and stop threads, call before context is destroyed
+    void destroy();
+
+    // light references of all froxels and the longest froxel list of the last update
+    size_t references() const { return indices.size(); }
+    uint32_t maxPerCluster() const { return maxCount; }
+    // worker threads (the calling thread works too)
+    size_t threadCount() const { return workers.size(); }
+
+private:
+    //! @brief Froxel lists of one depth slice, filled by one thread
+    struct Slice
+    {
+        //! @brief Lights that overlap the slice depth range (candidates for its tiles)
+        std::vector<uint32_t> candidates;
+        //! @brief Tile rectangle of each candidate: x0, x1, y0, y1 (inclusive)
+        std::vector<std::array<uint8_t, 4>> rects;
+        std::array<uint32_t, TILES_X * TILES_Y> counts;
+        std::array<uint32_t, TILES_X * TILES_Y> offsets;
+        std::vector<uint32_t> indices;
+    };
+
+    // SSE2: view space centers and visibility of all lights, then candidates of every slice
+    void transform(View const & view, std::vector<Light> const & lights);
+    // lists of all tiles of one slice
+    void assignSlice(unsigned int slice);
+    // take slices until none is left (workers and calling thread)
+    void assignSlices();
+    void workerLoop();
+    void stopWorkers();
+    // depth of the near side of a slice
+    float sliceDepth(unsigned int slice) const;
+
+    //! @brief View space of the lights (x, y, depth = -z) and radius, structure of arrays padded to 4
+    std::vector<float> viewX;
+    std::vector<float> viewY;
+    std::vector<float> viewDepth;
+    std::vector<float> radius;
+
+    std::array<Slice, SLICES> slices;
+    std::atomic<unsigned int> nextSlice{0};
+    //! @brief Tile of view space point: ndc = x / (depth * tan(fov / 2)), per axis
+    float tanHalfX{1.0f};
+    float tanHalfY{1.0f};
+    float near{0.1f};
+    float far{100.0f};
+    //! @brief slice = log(depth) * depthScale + depthBias
+    float depthScale{1.0f};
+    float depthBias{0.0f};
+    int width{1};
+    int height{1};
+
+    //! @brief Upload data: offset and count per froxel, light indices of all froxels
+    std::vector<uint32_t> grid;
+    std::vector<uint32_t> indices;
+    uint32_t maxCount{0};
+
+    // buffers and their texture views
+    unsigned int lightBuffer{0};
+    unsigned int gridBuffer{0};
+    unsigned int indexBuffer{0};
+    unsigned int lightTexture{0};
+    unsigned int gridTexture{0};
+    unsigned int indexTexture{0};
+
+    std::vector<std::thread> workers;
+    std::mutex mutex;
+    std::condition_variable jobStarted;
+    std::condition_variable jobFinished;
+    //! @brief Incremented for every update, workers start when it changes
+    unsigned long generation{0};
+    size_t finished{0};
+    bool stopping{false};
+};
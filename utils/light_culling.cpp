@@ -0,0 +1,194 @@
+#include "light_culling.hpp"
+
+#include "instance_buffer.hpp"
+#include "texture_buffer.hpp"
+
+#include <algorithm>
+#include <cfloat>
+#include <cmath>
+#include <numeric>
+
+#if defined(__SSE2__) || defined(_M_X64)
+#define LIGHT_CULLING_SSE2
+#include <emmintrin.h>
+#endif
+
+namespace
+{
+    // columns of the light grid per axis at most
+    const int MAX_COLUMNS = 256;
+}
+
+float LightCulling::effectiveRadius(float constant, float linear, float quadratic, float intensity, float threshold)
+{
+    // intensity / threshold = constant + linear * d + quadratic * d^2
+    float reach = intensity / threshold - constant;
+    if (reach <= 0.0f)
+        return 0.0f;
+    if (quadratic <= 0.0f)
+        return linear > 0.0f ? std::min(reach / linear, MAX_RADIUS) : MAX_RADIUS;
+    return std::min((-linear + std::sqrt(linear * linear + 4.0f * quadratic * reach)) / (2.0f * quadratic), MAX_RADIUS);
+}
+
+void LightCulling::create()
+{
+    TextureBuffer::create(lightBuffer, lightTexture, GL_RGBA32F);
+    TextureBuffer::create(indexBuffer, indexTexture, GL_R32UI);
+    glGenBuffers(1, &listBuffer);
+}
+
+void LightCulling::attach()
+{
+    glBindBuffer(GL_ARRAY_BUFFER, listBuffer);
+    glVertexAttribIPointer(InstanceAttrib::LIGHT_LIST, 2, GL_UNSIGNED_INT, sizeof(glm::uvec2), (void*)0);
+    glEnableVertexAttribArray(InstanceAttrib::LIGHT_LIST);
+    glVertexAttribDivisor(InstanceAttrib::LIGHT_LIST, 1);
+}
+
+void LightCulling::binLights(std::vector<LightClusters::Light> const & lights)
+{
+    // radius of a light as the grid uses it: finite (an infinite or NaN one would make the columns NaN)
+    auto radiusOf = [](LightClusters::Light const & light) { return std::min(LightCulling::MAX_RADIUS, light.radius); };
+
+    size_t count = lights.size();
+    glm::vec2 low(FLT_MAX);
+    glm::vec2 high(-FLT_MAX);
+    maxRadius = 0.0f;
+    for (LightClusters::Light const & light : lights)
+    {
+        low = glm::min(low, glm::vec2(light.position.x, light.position.z));
+        high = glm::max(high, glm::vec2(light.position.x, light.position.z));
+        maxRadius = std::max(maxRadius, radiusOf(light));
+    }
+
+    // a box widened by the largest radius touches 2-3 columns per axis, at most MAX_COLUMNS per axis
+    gridLow = count > 0 ? low : glm::vec2(0.0f);
+    glm::vec2 extent = count > 0 ? high - low : glm::vec2(0.0f);
+    columnSize = std::max({2.0f * maxRadius, extent.x / float(MAX_COLUMNS), extent.y / float(MAX_COLUMNS), 1e-3f});
+    columnsX = int(extent.x / columnSize) + 1;
+    columnsZ = int(extent.y / columnSize) + 1;
+
+    // counting sort by column
+    columnStart.assign(size_t(columnsX * columnsZ) + 1, 0);
+    lightColumn.resize(count);
+    for (size_t i = 0; i < count; ++i)
+    {
+        int x = std::min(int((lights[i].position.x - gridLow.x) / columnSize), columnsX - 1);
+        int z = std::min(int((lights[i].position.z - gridLow.y) / columnSize), columnsZ - 1);
+        lightColumn[i] = uint32_t(z * columnsX + x);
+        ++columnStart[lightColumn[i] + 1];
+    }
+    std::partial_sum(columnStart.begin(), columnStart.end(), columnStart.begin());
+
+    // lanes past the last light are never inside (far away, zero radius)
+    order.resize(count);
+    sortedX.assign(count + 3, FLT_MAX);
+    sortedY.assign(count + 3, 0.0f);
+    sortedZ.assign(count + 3, 0.0f);
+    sortedRadius.assign(count + 3, 0.0f);
+    for (size_t i = 0; i < count; ++i)
+    {
+        uint32_t slot = columnStart[lightColumn[i]]++;
+        order[slot] = uint32_t(i);
+    }
+    // columnStart was advanced to the end of each column: shift back
+    std::copy_backward(columnStart.begin(), columnStart.end() - 1, columnStart.end());
+    columnStart[0] = 0;
+    for (size_t i = 0; i < count; ++i)
+    {
+        LightClusters::Light const & light = lights[order[i]];
+        sortedX[i] = light.position.x;
+        sortedY[i] = light.position.y;
+        sortedZ[i] = light.position.z;
+        sortedRadius[i] = radiusOf(light);
+    }
+}
+
+void LightCulling::cullBox(Box const & box)
+{
+    // columns of the box widened by the largest radius: each row of them is one range of sorted lights
+    auto column = [this](float position, float low, int columns) {
+        return std::clamp(int(std::floor((position - low) / columnSize)), 0, columns - 1);
+    };
+    int x0 = column(box.low.x - maxRadius, gridLow.x, columnsX);
+    int x1 = column(box.high.x + maxRadius, gridLow.x, columnsX);
+    int z0 = column(box.low.z - maxRadius, gridLow.y, columnsZ);
+    int z1 = column(box.high.z + maxRadius, gridLow.y, columnsZ);
+
+    for (int z = z0; z <= z1; ++z)
+    {
+        size_t first = columnStart[size_t(z * columnsX + x0)];
+        size_t last = columnStart[size_t(z * columnsX + x1 + 1)];
+        for (size_t i = first; i < last; i += 4)
+        {
+            unsigned int touching = 0;
+#ifdef LIGHT_CULLING_SSE2
+            // squared distance of the center to the box: per axis zero inside the slab
+            auto axis = [](__m128 center, float low, float high) {
+                __m128 d = _mm_max_ps(_mm_sub_ps(_mm_set1_ps(low), center), _mm_sub_ps(center, _mm_set1_ps(high)));
+                d = _mm_max_ps(d, _mm_setzero_ps());
+                return _mm_mul_ps(d, d);
+            };
+            __m128 distance2 = _mm_add_ps(_mm_add_ps(axis(_mm_loadu_ps(&sortedX[i]), box.low.x, box.high.x),
+                                                     axis(_mm_loadu_ps(&sortedY[i]), box.low.y, box.high.y)),
+                                          axis(_mm_loadu_ps(&sortedZ[i]), box.low.z, box.high.z));
+            __m128 r = _mm_loadu_ps(&sortedRadius[i]);
+            touching = unsigned(_mm_movemask_ps(_mm_cmple_ps(distance2, _mm_mul_ps(r, r))));
+#else
+            for (size_t j = 0; j < 4; ++j)
+            {
+                glm::vec3 center(sortedX[i + j], sortedY[i + j], sortedZ[i + j]);
+                glm::vec3 d = glm::max(glm::max(box.low - center, center - box.high), glm::vec3(0.0f));
+                touching |= glm::dot(d, d) <= sortedRadius[i + j] * sortedRadius[i + j] ? 1u << j : 0u;
+            }
+#endif
+            for (size_t j = 0; j < 4 && i + j < last; ++j)
+            {
+                if (touching & (1u << j))
+                    indices.push_back(order[i + j]);
+            }
+        }
+    }
+}
+
+void LightCulling::update(std::vector<LightClusters::Light> const & lights, std::vector<Box> const & boxes)
+{
+    binLights(lights);
+
+    objectLists.resize(boxes.size());
+    indices.clear();
+    maxCount = 0;
+    for (size_t b = 0; b < boxes.size(); ++b)
+    {
+        auto offset = uint32_t(indices.size());
+        cullBox(boxes[b]);
+        objectLists[b] = glm::uvec2(offset, uint32_t(indices.size()) - offset);
+        maxCount = std::max(maxCount, objectLists[b].y);
+    }
+
+    TextureBuffer::upload(GL_TEXTURE_BUFFER, lightBuffer, lights.size() * sizeof(LightClusters::Light), lights.data());
+    TextureBuffer::upload(GL_TEXTURE_BUFFER, indexBuffer, indices.size() * sizeof(uint32_t), indices.data());
+    TextureBuffer::upload(GL_ARRAY_BUFFER, listBuffer, objectLists.size() * sizeof(glm::uvec2), objectLists.data());
+}
+
+void LightCulling::bind(Shader const & shader, GLuint firstUnit) const
+{
+    unsigned int const textures[] = {lightTexture, indexTexture};
+    char const * const names[] = {"culledLights", "culledIndices"};
+    for (GLuint i = 0; i < 2; ++i)
+    {
+        glActiveTexture(GL_TEXTURE0 + firstUnit + i);
+        glBindTexture(GL_TEXTURE_BUFFER, textures[i]);
+        shader.setInt(names[i], int(firstUnit + i));
+    }
+}
+
+void LightCulling::destroy()
+{
+    glDeleteTextures(1, &lightTexture);
+    glDeleteTextures(1, &indexTexture);
+    glDeleteBuffers(1, &lightBuffer);
+    glDeleteBuffers(1, &indexBuffer);
+    glDeleteBuffers(1, &listBuffer);
+    lightTexture = indexTexture = lightBuffer = indexBuffer = listBuffer = 0;
+}
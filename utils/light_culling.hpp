@@ -0,0 +1,89 @@
+#pragma once
+
+#include "light_clusters.hpp"
+#include "shader.hpp"
+
+#include <glad/glad.h>
+#include <glm/glm.hpp>
+
+#include <cstdint>
+#include <vector>
+
+//! @brief Per-object light lists: every point light has an effective radius (where its attenuated luminance falls
+//! below a threshold) and every frame each object gets the lights whose sphere touches its bounding box, so an object
+//! is shaded with the lights around it only. Lights are binned into a grid of x/z columns (counting sort, a row of
+//! columns is one range of the sorted lights), an object tests the lights of the columns its box touches, 4 spheres
+//! at once (SSE2). Results: lights (2 RGBA32F texels each, same as LightClusters) and light indices (R32UI) in texture
+//! buffers, offset and count of each object in a per-instance attribute.
+class LightCulling
+{
+public:
+    //! @brief Axis aligned bounding box of an object, world space
+    struct Box
+    {
+        glm::vec3 low;
+        glm::vec3 high;
+    };
+
+    //! @brief Radius of lights that never fall to the threshold (no falloff): they reach every box within it
+    static constexpr float MAX_RADIUS = 1.0e6f;
+
+    // distance where intensity / (constant + linear * d + quadratic * d^2) falls to threshold (0 if it never exceeds it,
+    // at most MAX_RADIUS)
+    static float effectiveRadius(float constant, float linear, float quadratic, float intensity, float threshold);
+
+    LightCulling() = default;
+    LightCulling(LightCulling const &) = delete;
+    LightCulling & operator=(LightCulling const &) = delete;
+
+    // GL thread: texture buffers and the list buffer
+    void create();
+    // GL thread: bind list buffer as per-instance "layout (location = 11) in uvec2 aLightList" of the VAO in use
+    void attach();
+    // GL thread, once per frame: lights touching each box, lights, indices and lists are uploaded
+    void update(std::vector<LightClusters::Light> const & lights, std::vector<Box> const & boxes);
+    // GL thread: bind the buffers to texture units firstUnit and firstUnit+1 and set sampler uniforms of the program
+    void bind(Shader const & shader, GLuint firstUnit) const;
+    // free GL objects, call before context is destroyed
+    void destroy();
+
+    // offset in light indices and light count of each box of the last update (attribute value of single draws)
+    std::vector<glm::uvec2> const & lists() const { return objectLists; }
+    // light references of all boxes and the longest list of the last update
+    size_t references() const { return indices.size(); }
+    uint32_t maxPerObject() const { return maxCount; }
+
+private:
+    // lights sorted by grid column into structure of arrays (padded to 4 past the last light)
+    void binLights(std::vector<LightClusters::Light> const & lights);
+    // append lights touching the box to indices
+    void cullBox(Box const & box);
+
+    //! @brief Light index and sphere of sorted lights
+    std::vector<uint32_t> order;
+    std::vector<float> sortedX;
+    std::vector<float> sortedY;
+    std::vector<float> sortedZ;
+    std::vector<float> sortedRadius;
+    float maxRadius{0.0f};
+
+    //! @brief Column grid: first sorted light of each column (column = z * columnsX + x) and one past the last,
+    //! column of each light
+    std::vector<uint32_t> columnStart;
+    std::vector<uint32_t> lightColumn;
+    int columnsX{1};
+    int columnsZ{1};
+    glm::vec2 gridLow{0.0f};
+    float columnSize{1.0f};
+
+    std::vector<glm::uvec2> objectLists;
+    std::vector<uint32_t> indices;
+    uint32_t maxCount{0};
+
+    // buffers and their texture views, per-instance list buffer
+    unsigned int lightBuffer{0};
+    unsigned int indexBuffer{0};
+    unsigned int lightTexture{0};
+    unsigned int indexTexture{0};
+    unsigned int listBuffer{0};
+};
@@ -0,0 +1,93 @@
+#include "mapped_file.hpp"
+
+#include <fstream>
+#include <utility>
+
+#if defined(__unix__) || defined(__APPLE__)
+#define MAPPED_FILE_MMAP
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+MappedFile::MappedFile(MappedFile && other) noexcept
+{
+    *this = std::move(other);
+}
+
+MappedFile & MappedFile::operator=(MappedFile && other) noexcept
+{
+    if (this != &other)
+    {
+        close();
+        data = other.data;
+        size = other.size;
+        buffer = std::move(other.buffer);
+        if (!buffer.empty())
+            data = buffer.data();
+        other.data = nullptr;
+        other.size = 0;
+    }
+    return *this;
+}
+
+bool MappedFile::open(std::string const & path)
+{
+    close();
+#ifdef MAPPED_FILE_MMAP
+    int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0)
+        return false;
+    struct stat info;
+    if (fstat(fd, &info) != 0 || info.st_size <= 0)
+    {
+        ::close(fd);
+        return false;
+    }
+    void * mapping = mmap(nullptr, size_t(info.st_size), PROT_READ, MAP_PRIVATE, fd, 0);
+    // mapping stays valid after file descriptor is closed
+    ::close(fd);
+    if (mapping == MAP_FAILED)
+        return false;
+    data = static_cast<const unsigned char *>(mapping);
+    size = size_t(info.st_size);
+    return true;
+#else
+    std::ifstream file(path, std::ios::binary | std::ios::ate);
+    if (!file)
+        return false;
+    std::streamsize length = file.tellg();
+    if (length <= 0)
+        return false;
+    buffer.resize(size_t(length));
+    file.seekg(0);
+    if (!file.read(reinterpret_cast<char *>(buffer.data()), length))
+    {
+        buffer.clear();
+        return false;
+    }
+    data = buffer.data();
+    size = buffer.size();
+    return true;
+#endif
+}
+
+void MappedFile::prefetch() const
+{
+#ifdef MAPPED_FILE_MMAP
+    if (data)
+        madvise(const_cast<unsigned char *>(data), size, MADV_WILLNEED);
+#endif
+}
+
+void MappedFile::close()
+{
+#ifdef MAPPED_FILE_MMAP
+    if (data && buffer.empty())
+        munmap(const_cast<unsigned char *>(data), size);
+#endif
+    buffer.clear();
+    data = nullptr;
+    size = 0;
+}
@@ -0,0 +1,34 @@
+#pragma once
+
+#include <cstddef>
+#include <string>
+#include <vector>
+
+//! @brief Read-only memory mapping of a whole file (POSIX mmap; plain read on other systems).
+//! Move-only, unmapped on destruction.
+class MappedFile
+{
+public:
+    MappedFile() = default;
+    MappedFile(MappedFile && other) noexcept;
+    MappedFile & operator=(MappedFile && other) noexcept;
+    MappedFile(MappedFile const &) = delete;
+    MappedFile & operator=(MappedFile const &) = delete;
+    ~MappedFile() { close(); }
+
+    // map file, false if it does not exist or cannot be mapped
+    bool open(std::string const & path);
+    void close();
+    // ask OS to read pages in background before they are touched
+    void prefetch() const;
+
+    bool isOpen() const { return data != nullptr; }
+    const unsigned char * getData() const { return data; }
+    size_t getSize() const { return size; }
+
+private:
+    const unsigned char * data{nullptr};
+    size_t size{0};
+    //! @brief File content when mmap is not available
+    std::vector<unsigned char> buffer;
+};
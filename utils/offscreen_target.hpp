@@ -0,0 +1,27 @@
+#pragma once
+
+#include <glad/glad.h>
+
+//! @brief Framebuffer object with color and depth renderbuffers.
+//! Render target of headless runs, where no default framebuffer exists.
+class OffscreenTarget
+{
+public:
+    // create buffers of given size (false if framebuffer is incomplete)
+    bool create(int width, int height);
+    // bind as draw and read framebuffer and set viewport to its size
+    void bind() const;
+    // free GL objects, call before context is destroyed
+    void destroy();
+
+    int getWidth() const { return width; }
+    int getHeight() const { return height; }
+
+private:
+    //! @brief Framebuffer id
+    unsigned int ID{0};
+    unsigned int colorBuffer{0};
+    unsigned int depthBuffer{0};
+    int width{0};
+    int height{0};
+};
@@ -0,0 +1,275 @@
+#include "profiler.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <fstream>
+#include <iostream>
+
+int Profiler::zone(std::string const & name, bool gpu)
+{
+    for (size_t i = 0; i < zones.size(); ++i)
+    {
+        if (zones[i].name == name)
+            return int(i);
+    }
+    Zone z;
+    z.name = name;
+    z.gpu = gpu;
+    z.queryFrame.fill(-1);
+    zones.push_back(std::move(z));
+    return int(zones.size() - 1);
+}
+
+void Profiler::enable(std::string reportPath)
+{
+    enabled = true;
+    path = std::move(reportPath);
+}
+
+void Profiler::memory(std::string const & name, size_t bytes)
+{
+    if (enabled)
+        resources.push_back(Memory{name, bytes});
+}
+
+size_t Profiler::memoryTotal() const
+{
+    size_t total = 0;
+    for (Memory const & m : resources)
+        total += m.bytes;
+    return total;
+}
+
+void Profiler::beginFrame()
+{
+    if (!enabled)
+        return;
+    ++frame;
+    collectQueries(false);
+    frameStart = clock::now();
+}
+
+void Profiler::endFrame()
+{
+    if (!enabled)
+        return;
+    frameMs.push_back(std::chrono::duration<float, std::milli>(clock::now() - frameStart).count());
+}
+
+void Profiler::beginZone(int id)
+{
+    if (!enabled)
+        return;
+    Zone & z = zones[id];
+    if (z.gpu)
+    {
+        if (z.queries[0] == 0)
+            glGenQueries(GLsizei(QUERY_LATENCY), z.queries.data());
+        size_t slot = size_t(frame) % QUERY_LATENCY;
+        // result of QUERY_LATENCY frames ago is still not ready: drop it instead of waiting
+        if (z.queryFrame[slot] >= 0)
+            ++droppedQueries;
+        glBeginQuery(GL_TIME_ELAPSED, z.queries[slot]);
+        z.queryFrame[slot] = frame;
+    }
+    z.start = clock::now();
+}
+
+void Profiler::endZone(int id)
+{
+    if (!enabled)
+        return;
+    Zone & z = zones[id];
+    z.cpuMs.push_back(std::chrono::duration<float, std::milli>(clock::now() - z.start).count());
+    if (z.gpu)
+        glEndQuery(GL_TIME_ELAPSED);
+}
+
+void Profiler::collectQueries(bool wait)
+{
+    for (Zone & z : zones)
+    {
+        if (!z.gpu)
+            continue;
+        for (size_t slot = 0; slot < QUERY_LATENCY; ++slot)
+        {
+            if (z.queryFrame[slot] < 0)
+                continue;
+            GLint available = GL_FALSE;
+            if (!wait)
+                glGetQueryObjectiv(z.queries[slot], GL_QUERY_RESULT_AVAILABLE, &available);
+            if (wait || available)
+            {
+                GLuint64 ns = 0;
+                glGetQueryObjectui64v(z.queries[slot], GL_QUERY_RESULT, &ns);
+                z.gpuMs.push_back(float(double(ns) * 1e-6));
+                z.queryFrame[slot] = -1;
+            }
+        }
+    }
+}
+
+Profiler::Stats Profiler::computeStats(std::vector<float> samples)
+{
+    Stats stats;
+    stats.count = samples.size();
+    if (samples.empty())
+        return stats;
+
+    std::sort(samples.begin(), samples.end());
+    double sum = 0.0;
+    for (float v : samples)
+        sum += v;
+    // nearest-rank percentile
+    auto percentile = [&samples](double p) {
+        size_t rank = size_t(std::ceil(p * double(samples.size())));
+        return samples[std::min(std::max(rank, size_t(1)), samples.size()) - 1];
+    };
+    stats.mean = float(sum / double(samples.size()));
+    stats.p50 = percentile(0.50);
+    stats.p95 = percentile(0.95);
+    stats.p99 = percentile(0.99);
+    stats.max = samples.back();
+    return stats;
+}
+
+std::vector<Profiler::ZoneStats> Profiler::summary()
+{
+    collectQueries(true);
+
+    std::vector<ZoneStats> result;
+    result.push_back(ZoneStats{"frame", "cpu", computeStats(frameMs)});
+    for (Zone const & z : zones)
+    {
+        result.push_back(ZoneStats{z.name, "cpu", computeStats(z.cpuMs)});
+        if (z.gpu)
+            result.push_back(ZoneStats{z.name, "gpu", computeStats(z.gpuMs)});
+    }
+    return result;
+}
+
+void Profiler::report()
+{
+    if (!enabled)
+        return;
+    std::vector<ZoneStats> stats = summary();
+
+    std::printf("%-16s %-4s %8s %9s %9s %9s %9s %9s\n", "zone", "", "samples", "mean ms", "p50", "p95", "p99", "max");
+    for (ZoneStats const & z : stats)
+    {
+        Stats const & s = z.stats;
+        if (s.count > 0)
+            std::printf("%-16s %-4s %8zu %9.3f %9.3f %9.3f %9.3f %9.3f\n", z.name.c_str(), z.side.c_str(), s.count, s.mean, s.p50, s.p95, s.p99, s.max);
+    }
+    if (!resources.empty())
+    {
+        std::printf("%-64s %10s\n", "GPU memory", "KiB");
+        for (Memory const & m : resources)
+            std::printf("%-64s %10.1f\n", m.name.c_str(), double(m.bytes) / 1024.0);
+        std::printf("%-64s %10.1f\n", "total", double(memoryTotal()) / 1024.0);
+    }
+    if (droppedQueries > 0)
+        std::printf("%zu GPU samples dropped (not ready after %zu frames)\n", droppedQueries, QUERY_LATENCY);
+
+    if (path.size() > 4 && path.compare(path.size() - 4, 4, ".csv") == 0)
+        writeCsv(path, stats);
+    else if (!path.empty())
+        writeJson(path, stats);
+
+    reset();
+    enabled = false;
+}
+
+void Profiler::reset()
+{
+    for (Zone & z : zones)
+    {
+        if (z.queries[0] != 0)
+            glDeleteQueries(GLsizei(QUERY_LATENCY), z.queries.data());
+        z.queries.fill(0);
+        z.queryFrame.fill(-1);
+        z.cpuMs.clear();
+        z.gpuMs.clear();
+    }
+    frameMs.clear();
+    resources.clear();
+    frame = -1;
+    droppedQueries = 0;
+}
+
+std::string Profiler::jsonEscape(std::string const & text)
+{
+    std::string escaped;
+    escaped.reserve(text.size());
+    for (char c : text)
+    {
+        switch (c)
+        {
+            case '"':  escaped += "\\\""; break;
+            case '\\': escaped += "\\\\"; break;
+            case '\n': escaped += "\\n"; break;
+            case '\r': escaped += "\\r"; break;
+            case '\t': escaped += "\\t"; break;
+            default:
+                if (static_cast<unsigned char>(c) < 0x20)
+                {
+                    char code[8];
+                    std::snprintf(code, sizeof(code), "\\u%04x", unsigned(static_cast<unsigned char>(c)));
+                    escaped += code;
+                }
+                else
+                {
+                    escaped += c;
+                }
+        }
+    }
+    return escaped;
+}
+
+bool Profiler::writeJson(std::string const & filePath, std::vector<ZoneStats> const & stats) const
+{
+    std::ofstream file(filePath);
+    file << "{\n  \"frames\": " << frameMs.size() << ",\n  \"droppedGpuSamples\": " << droppedQueries << ",\n";
+    file << "  \"unit\": \"ms\",\n  \"zones\": [";
+    for (size_t i = 0; i < stats.size(); ++i)
+    {
+        Stats const & s = stats[i].stats;
+        file << (i == 0 ? "\n" : ",\n") << "    {\"name\": \"" << jsonEscape(stats[i].name) << "\", \"side\": \"" << stats[i].side
+             << "\", \"samples\": " << s.count << ", \"mean\": " << s.mean << ", \"p50\": " << s.p50
+             << ", \"p95\": " << s.p95 << ", \"p99\": " << s.p99 << ", \"max\": " << s.max << "}";
+    }
+    file << "\n  ],\n  \"memoryBytes\": " << memoryTotal() << ",\n  \"memory\": [";
+    for (size_t i = 0; i < resources.size(); ++i)
+    {
+        file << (i == 0 ? "\n" : ",\n") << "    {\"name\": \"" << jsonEscape(resources[i].name) << "\", \"bytes\": "
+             << resources[i].bytes << "}";
+    }
+    file << "\n  ]\n}\n";
+
+    if (!file)
+    {
+        std::cerr << "ERROR::PROFILER::FILE_NOT_SUCCESFULLY_WRITTEN " << filePath << std::endl;
+        return false;
+    }
+    return true;
+}
+
+bool Profiler::writeCsv(std::string const & filePath, std::vector<ZoneStats> const & stats) const
+{
+    std::ofstream file(filePath);
+    file << "zone,side,samples,mean_ms,p50_ms,p95_ms,p99_ms,max_ms\n";
+    for (ZoneStats const & z : stats)
+    {
+        Stats const & s = z.stats;
+        file << z.name << ',' << z.side << ',' << s.count << ',' << s.mean << ',' << s.p50 << ','
+             << s.p95 << ',' << s.p99 << ',' << s.max << '\n';
+    }
+
+    if (!file)
+    {
+        std::cerr << "ERROR::PROFILER::FILE_NOT_SUCCESFULLY_WRITTEN " << filePath << std::endl;
+        return false;
+    }
+    return true;
+}
@@ -0,0 +1,117 @@
+#pragma once
+
+#include <glad/glad.h>
+
+#include <array>
+#include <chrono>
+#include <string>
+#include <vector>
+
+//! @brief Per-frame CPU/GPU timing of named zones with p50/p95/p99 report, GPU memory of named resources.
+//! GPU side uses a ring of GL_TIME_ELAPSED queries that are read QUERY_LATENCY frames later,
+//! so profiling never waits for the GPU. GPU zones must not nest (one timer query at a time).
+class Profiler
+{
+public:
+    //! @brief Frames between issuing a timer query and reading its result
+    static constexpr size_t QUERY_LATENCY = 4;
+
+    // register named zone once, returns its id
+    int zone(std::string const & name, bool gpu = false);
+
+    bool isEnabled() const { return enabled; }
+    // disabled profiler ignores all zone calls
+    void enable(std::string reportPath = {});
+
+    // frame bounds: collect ready GPU results of old frames and store CPU frame time
+    void beginFrame();
+    void endFrame();
+
+    void beginZone(int id);
+    void endZone(int id);
+
+    // GPU memory of named resource (e.g. texture), listed in the report
+    void memory(std::string const & name, size_t bytes);
+
+    struct Stats
+    {
+        size_t count{0};
+        float mean{0.0f};
+        float p50{0.0f};
+        float p95{0.0f};
+        float p99{0.0f};
+        float max{0.0f};
+    };
+
+    struct ZoneStats
+    {
+        std::string name;
+        //! @brief "cpu" or "gpu"
+        std::string side;
+        Stats stats;
+    };
+
+    struct Memory
+    {
+        std::string name;
+        size_t bytes;
+    };
+
+    // wait for pending GPU results and summarize frame time and all zones (milliseconds)
+    std::vector<ZoneStats> summary();
+    // print stats to stdout and write report file (.json or .csv) if requested, free GL queries
+    void report();
+    // free GL queries and drop all samples and memory entries, zones stay registered
+    void reset();
+
+    // text as content of a JSON string: quotes, backslashes and control characters escaped (report writers)
+    static std::string jsonEscape(std::string const & text);
+
+private:
+    using clock = std::chrono::steady_clock;
+
+    struct Zone
+    {
+        std::string name;
+        bool gpu{false};
+        clock::time_point start;
+        //! @brief Milliseconds of every measured frame
+        std::vector<float> cpuMs;
+        std::vector<float> gpuMs;
+        //! @brief Timer query per ring slot, frame it was issued in (-1 - free)
+        std::array<GLuint, QUERY_LATENCY> queries{};
+        std::array<long, QUERY_LATENCY> queryFrame{};
+    };
+
+    static Stats computeStats(std::vector<float> samples);
+    void collectQueries(bool wait);
+    bool writeJson(std::string const & path, std::vector<ZoneStats> const & stats) const;
+    size_t memoryTotal() const;
+    bool writeCsv(std::string const & path, std::vector<ZoneStats> const & stats) const;
+
+    bool enabled{false};
+    std::string path;
+
+    std::vector<Zone> zones;
+    long frame{-1};
+    clock::time_point frameStart;
+    std::vector<float> frameMs;
+    std::vector<Memory> resources;
+    //! @brief GPU results not ready after QUERY_LATENCY frames (sample dropped, no stall)
+    size_t droppedQueries{0};
+};
+
+//! @brief RAII zone marker: measures scope it lives in
+class ProfileZone
+{
+public:
+    ProfileZone(Profiler & profiler, int id) : profiler(profiler), id(id) { profiler.beginZone(id); }
+    ~ProfileZone() { profiler.endZone(id); }
+
+    ProfileZone(ProfileZone const &) = delete;
+    ProfileZone & operator=(ProfileZone const &) = delete;
+
+private:
+    Profiler & profiler;
+    int id;
+};
@@ -0,0 +1,125 @@
+#include "program_cache.hpp"
+
+#include "asset_cache.hpp"
+#include "mapped_file.hpp"
+
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+
+namespace
+{
+    // entry file: header + binary as returned by glGetProgramBinary
+    struct Header
+    {
+        char magic[4];
+        uint32_t version;
+        uint32_t binaryFormat;
+        uint32_t size;
+    };
+    const char MAGIC[4] = {'L', 'G', 'P', 'B'};
+    const uint32_t VERSION = 1;
+
+    std::string sDirectory = AssetCache::DIRECTORY_DEFAULT;
+
+    std::string_view glString(GLenum name)
+    {
+        auto value = reinterpret_cast<const char *>(glGetString(name));
+        return value ? std::string_view(value) : std::string_view();
+    }
+}
+
+namespace ProgramCache
+{
+    void setDirectory(std::string const & directory)
+    {
+        sDirectory = directory;
+    }
+
+    bool isEnabled()
+    {
+        if (sDirectory.empty() || !GLAD_GL_ARB_get_program_binary)
+            return false;
+        // extension without any binary format: nothing can be retrieved
+        GLint formats = 0;
+        glGetIntegerv(GL_NUM_PROGRAM_BINARY_FORMATS, &formats);
+        return formats > 0;
+    }
+
+    std::string driverId()
+    {
+        if (!isEnabled())
+            return std::string();
+        std::string id(glString(GL_VENDOR));
+        id.append("\n").append(glString(GL_RENDERER)).append("\n").append(glString(GL_VERSION));
+        return id;
+    }
+
+    std::string keyFor(std::vector<std::string_view> const & sources, std::string_view defines, std::string const & driver)
+    {
+        if (driver.empty())
+            return std::string();
+        std::vector<std::string_view> parts = sources;
+        parts.push_back(defines);
+        parts.push_back(driver);
+        return AssetCache::keyOf(parts);
+    }
+
+    bool load(GLuint program, std::string const & key)
+    {
+        if (key.empty())
+            return false;
+        MappedFile file;
+        if (!file.open(AssetCache::pathFor(sDirectory, key, EXTENSION)))
+            return false;
+
+        Header header;
+        if (file.getSize() < sizeof(header))
+            return false;
+        std::memcpy(&header, file.getData(), sizeof(header));
+        if (std::memcmp(header.magic, MAGIC, sizeof(MAGIC)) != 0 || header.version != VERSION
+            || header.size != file.getSize() - sizeof(header))
+        {
+            return false;
+        }
+
+        glProgramBinary(program, header.binaryFormat, file.getData() + sizeof(header), GLsizei(header.size));
+        // driver update with the same version string, other build of the driver: binary is not accepted
+        GLint success = 0;
+        glGetProgramiv(program, GL_LINK_STATUS, &success);
+        return success != 0;
+    }
+
+    void prepare(GLuint program, std::string const & key)
+    {
+        if (!key.empty())
+            glProgramParameteri(program, GL_PROGRAM_BINARY_RETRIEVABLE_HINT, GL_TRUE);
+    }
+
+    bool store(GLuint program, std::string const & key)
+    {
+        if (key.empty())
+            return false;
+        GLint length = 0;
+        glGetProgramiv(program, GL_PROGRAM_BINARY_LENGTH, &length);
+        if (length <= 0)
+            return false;
+
+        std::vector<char> binary(static_cast<size_t>(length));
+        Header header;
+        std::memcpy(header.magic, MAGIC, sizeof(MAGIC));
+        header.version = VERSION;
+        GLenum binaryFormat = 0;
+        glGetProgramBinary(program, length, &length, &binaryFormat, binary.data());
+        header.binaryFormat = binaryFormat;
+        header.size = uint32_t(length);
+
+        return AssetCache::store(AssetCache::pathFor(sDirectory, key, EXTENSION), [&](std::string const & path) {
+            std::ofstream file(path, std::ios::binary);
+            file.write(reinterpret_cast<const char *>(&header), sizeof(header));
+            file.write(binary.data(), length);
+            return bool(file);
+        });
+    }
+}
@@ -0,0 +1,33 @@
+#pragma once
+
+#include <glad/glad.h>
+
+#include <string>
+#include <string_view>
+#include <vector>
+
+//! @brief Linked program binaries (ARB_get_program_binary) in AssetCache: warm start loads the program
+//! with glProgramBinary instead of compiling GLSL.
+//! Key is a hash of the sources as passed to the compiler, their defines and the vendor/renderer/version strings
+//! of the driver: any change of them misses the entry. Driver may still reject a binary
+//! (load() fails, the caller compiles from source and stores a new one).
+namespace ProgramCache
+{
+    static const char * const EXTENSION = ".glbin";
+
+    // folder of binaries, empty disables the cache (default AssetCache::DIRECTORY_DEFAULT)
+    void setDirectory(std::string const & directory);
+    // GL thread: driver can return program binaries and cache is enabled
+    bool isEnabled();
+    // GL thread: vendor/renderer/version strings of the driver, empty if the cache is not enabled
+    std::string driverId();
+    // any thread: key of program, empty without driver id
+    std::string keyFor(std::vector<std::string_view> const & sources, std::string_view defines, std::string const & driver);
+
+    // GL thread: load binary of the key into program, false if there is no entry or driver rejects it
+    bool load(GLuint program, std::string const & key);
+    // GL thread: call before glLinkProgram of a program that is stored
+    void prepare(GLuint program, std::string const & key);
+    // GL thread: write binary of linked program
+    bool store(GLuint program, std::string const & key);
+}
@@ -0,0 +1,156 @@
+#include "render_loop.hpp"
+
+#include <cctype>
+#include <cstdlib>
+#include <iostream>
+#include <string>
+
+bool RenderLoop::parseArgument(int argc, char ** argv, int & i)
+{
+    std::string arg = argv[i];
+    if (arg == "--profile")
+    {
+        std::string reportPath;
+        if (i + 1 < argc && argv[i + 1][0] != '-')
+            reportPath = argv[++i];
+        profiler.enable(reportPath);
+        return true;
+    }
+    if (arg != "--headless")
+        return false;
+
+    headless = true;
+    fixedDeltaTime = HEADLESS_DELTA_TIME;
+    if (i + 1 < argc && std::isdigit(static_cast<unsigned char>(argv[i + 1][0])))
+        frameLimit = std::atoi(argv[++i]);
+    return true;
+}
+
+void RenderLoop::setFixedStep(int frames, float dt)
+{
+    frameLimit = frames;
+    fixedDeltaTime = dt;
+}
+
+void RenderLoop::parseArguments(int argc, char ** argv)
+{
+    for (int i = 1; i < argc; ++i)
+    {
+        if (!parseArgument(argc, argv, i))
+            std::cerr << "Unknown argument: " << argv[i] << std::endl;
+    }
+}
+
+bool RenderLoop::create(int width, int height, const char * title)
+{
+    presentZone = profiler.zone("present");
+    if (headless)
+    {
+        // no window system at all: EGL context + framebuffer object
+        if (!headlessContext.create())
+            return false;
+        if (!offscreen.create(width, height))
+        {
+            headlessContext.destroy();
+            return false;
+        }
+        return true;
+    }
+
+    glfwInit();
+    glfwWindowHint(GLFW_CONTEXT_VERSION_MAJOR, 3);
+    glfwWindowHint(GLFW_CONTEXT_VERSION_MINOR, 3);
+    glfwWindowHint(GLFW_OPENGL_PROFILE, GLFW_OPENGL_CORE_PROFILE);
+    glfwWindowHint(GLFW_OPENGL_FORWARD_COMPAT, GL_TRUE);
+    // window create
+    window = glfwCreateWindow(width, height, title, NULL, NULL);
+    if (window == NULL)
+    {
+        std::cerr << "Failed to create GLFW window (try --headless)" << std::endl;
+        glfwTerminate();
+        return false;
+    }
+    glfwMakeContextCurrent(window);
+
+    // glad: load all OpenGL function pointers
+    if (!gladLoadGLLoader((GLADloadproc)glfwGetProcAddress))
+    {
+        std::cerr << "Failed to initialize GLAD" << std::endl;
+        glfwTerminate();
+        window = nullptr;
+        return false;
+    }
+    return true;
+}
+
+bool RenderLoop::nextFrame()
+{
+    if (window && glfwWindowShouldClose(window))
+        return false;
+
+    if (fixedDeltaTime > 0.0f)
+    {
+        if (frame + 1 >= frameLimit)
+            return false;
+        ++frame;
+        // fixed step: animation does not depend on how slow the frames are
+        deltaTime = frame == 0 ? 0.0f : fixedDeltaTime;
+        time = float(frame) * fixedDeltaTime;
+        frameStart = clock::now();
+        profiler.beginFrame();
+        return true;
+    }
+
+    ++frame;
+    float currentTime = float(glfwGetTime());
+    deltaTime = currentTime - time;
+    time = currentTime;
+    profiler.beginFrame();
+    return true;
+}
+
+void RenderLoop::endFrame()
+{
+    if (headless)
+    {
+        {
+            ProfileZone zone(profiler, presentZone);
+            glFinish();
+        }
+        double ms = std::chrono::duration<double, std::milli>(clock::now() - frameStart).count();
+        totalMs += ms;
+        if (ms > maxMs)
+            maxMs = ms;
+    }
+    else
+    {
+        // check and call events and swap the buffer
+        ProfileZone zone(profiler, presentZone);
+        glfwSwapBuffers(window);
+        glfwPollEvents();
+    }
+    profiler.endFrame();
+}
+
+void RenderLoop::destroy()
+{
+    // GL queries of profiler need the context
+    profiler.report();
+
+    if (headless)
+    {
+        int frames = frame + 1;
+        if (frames > 0)
+        {
+            std::cout << "Headless: " << frames << " frames, " << totalMs << " ms, "
+                      << totalMs / frames << " ms/frame (max " << maxMs << " ms)" << std::endl;
+        }
+        offscreen.destroy();
+        headlessContext.destroy();
+        return;
+    }
+
+    // terminate, clearing all previously allocated GLFW resources
+    glfwTerminate();
+    window = nullptr;
+}
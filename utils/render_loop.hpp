@@ -0,0 +1,71 @@
+#pragma once
+
+#include <glad/glad.h>
+#include "GLFW/glfw3.h"
+
+#include "headless_context.hpp"
+#include "offscreen_target.hpp"
+#include "profiler.hpp"
+
+#include <chrono>
+
+//! @brief Main loop driver of a lesson: GLFW window or, with "--headless [frames]",
+//! offscreen rendering for a fixed number of frames with fixed time step.
+//! "--profile [file.json|file.csv]" enables zone timing, reported on destroy().
+class RenderLoop
+{
+public:
+    static constexpr int HEADLESS_FRAMES_DEFAULT = 300;
+    static constexpr float HEADLESS_DELTA_TIME = 1.0f / 60.0f;
+
+    // consume argument at argv[i] (and its value) if it belongs to the loop
+    bool parseArgument(int argc, char ** argv, int & i);
+    // parse whole command line, report unknown arguments
+    void parseArguments(int argc, char ** argv);
+
+    // create window or headless context with framebuffer of the same size, load GL functions
+    bool create(int width, int height, const char * title);
+    bool isHeadless() const { return headless; }
+    // nullptr in headless mode
+    GLFWwindow * getWindow() const { return window; }
+    // fixed time step for given number of frames also with window (replay); headless frames are overridden
+    void setFixedStep(int frames, float dt);
+
+    // start next frame: false if window should close or all headless frames are drawn
+    bool nextFrame();
+    // seconds since start, advances by HEADLESS_DELTA_TIME per frame in headless mode
+    float getTime() const { return time; }
+    float getDeltaTime() const { return deltaTime; }
+    // number of current frame, starts from 0
+    int getFrame() const { return frame; }
+    // zones of the lesson frame; "present" zone is measured by the loop itself
+    Profiler & getProfiler() { return profiler; }
+    // swap buffers and poll events, or wait for GL work to finish in headless mode
+    void endFrame();
+
+    // print headless frame timing and profiler report, release context
+    void destroy();
+
+private:
+    using clock = std::chrono::steady_clock;
+
+    bool headless{false};
+    //! @brief Fixed step mode: frame count and time step (0 - real time)
+    int frameLimit{HEADLESS_FRAMES_DEFAULT};
+    float fixedDeltaTime{0.0f};
+
+    GLFWwindow * window{nullptr};
+    HeadlessContext headlessContext;
+    OffscreenTarget offscreen;
+
+    Profiler profiler;
+    int presentZone{0};
+
+    int frame{-1};
+    float time{0.0f};
+    float deltaTime{0.0f};
+    //! @brief Headless frame timing: wall time of all frames and of the slowest one
+    clock::time_point frameStart;
+    double totalMs{0.0};
+    double maxMs{0.0};
+};
@@ -0,0 +1,60 @@
+#pragma once
+
+#include "camera.hpp"
+#include "profiler.hpp"
+#include "texture_loader.hpp"
+
+#include <string>
+#include <vector>
+
+//! @brief Scene of a lesson: GL setup and per-frame work behind one interface,
+//! driven by the lesson executable (runLesson) and by lesson_bench.
+//! Keys are GLFW key codes; camera movement and mode keys are handled by the caller.
+class Scene
+{
+public:
+    virtual ~Scene() = default;
+
+    // lesson folder name: subfolder of shaders/textures, name in reports
+    virtual std::string name() const = 0;
+    // lesson specific command line option at argv[i]
+    virtual bool parseArgument(int /*argc*/, char ** /*argv*/, int & /*i*/) { return false; }
+
+    // create GL objects and register profiling zones, false if scene cannot run.
+    // Textures are loaded in background, caller runs textureLoader.update() every frame
+    bool create(Profiler & sceneProfiler, TextureLoader & textureLoader)
+    {
+        profiler = &sceneProfiler;
+        textures = &textureLoader;
+        return init();
+    }
+    // draw one frame into bound framebuffer, uses time of setTime()
+    virtual void render() = 0;
+    // free GL objects, call before context is destroyed
+    virtual void destroy() = 0;
+
+    // keys polled every frame, onKeyHeld() is called while they are pressed
+    virtual std::vector<int> heldKeys() const { return {}; }
+    virtual void onKeyHeld(int /*key*/, float /*dt*/) {}
+    // key press event, false if scene does not use the key
+    virtual bool onKeyPress(int /*key*/) { return false; }
+
+    void setViewport(int w, int h) { width = w; height = h; }
+    void setTime(float t, float dt) { time = t; deltaTime = dt; }
+    Camera & getCamera() { return camera; }
+
+protected:
+    virtual bool init() = 0;
+
+    float aspectRatio() const { return float(width) / float(height); }
+
+    Profiler * profiler{nullptr};
+    TextureLoader * textures{nullptr};
+    Camera camera{glm::vec3(0.0, 0.0, 3.0)};
+
+    int width{800};
+    int height{600};
+    // seconds since start and since previous frame
+    float time{0.0f};
+    float deltaTime{0.0f};
+};
@@ -1,161 +1,464 @@
 #include "shader.hpp"
 
+#include "shader_library.hpp"
+
 #include <glm/gtc/type_ptr.hpp>
 
-#include <fstream>
+#include <algorithm>
+#include <charconv>
 #include <iostream>
-#include <sstream>
 
-std::string readCodeFromFile(const char * path)
+Shader::Shader(const char * vertexPath, const char * fragmentPath)
+{
+    // library of one program: same binary cache, compile and error report as the programs of a scene
+    ShaderLibrary library;
+    library.add(*this, vertexPath, fragmentPath);
+    library.build();
+}
+
+void Shader::use() const
+{
+    glUseProgram(ID);
+}
+
+void Shader::destroy()
 {
-    std::string code;
-    std::ifstream file;
-    try 
+    glDeleteProgram(ID);
+    ID = 0;
+    uniformTable.clear();
+    structArrays.clear();
+}
+
+void Shader::assign(unsigned int programID)
+{
+    ID = programID;
+    uniformTable.clear();
+    structArrays.clear();
+    reflectUniforms();
+}
+
+namespace
+{
+    struct ActiveUniform
+    {
+        std::string name;
+        GLint size{0};
+        GLenum type{0};
+    };
+
+    std::vector<ActiveUniform> activeUniforms(GLuint program)
     {
-        file.open(path);
-        std::stringstream codeStream;
-        codeStream << file.rdbuf();
-        file.close();
+        GLint count = 0, maxLength = 0;
+        glGetProgramiv(program, GL_ACTIVE_UNIFORMS, &count);
+        glGetProgramiv(program, GL_ACTIVE_UNIFORM_MAX_LENGTH, &maxLength);
 
-        code = codeStream.str();
+        std::vector<ActiveUniform> uniforms(static_cast<size_t>(count));
+        std::string name(size_t(maxLength), '\0');
+        for (GLint i = 0; i < count; ++i)
+        {
+            GLsizei length = 0;
+            glGetActiveUniform(program, GLuint(i), maxLength, &length, &uniforms[i].size, &uniforms[i].type, name.data());
+            uniforms[i].name.assign(name.data(), size_t(length));
+        }
+        return uniforms;
     }
-    catch(std::ifstream::failure & e)
+
+    // value of uniform in source program to uniform in current program (same type)
+    void copyUniform(GLuint source, GLint from, GLint to, GLenum type)
     {
-        std::cout << "ERROR::SHADER::FILE_NOT_SUCCESFULLY_READ" << std::endl;
-        return {};
+        GLfloat f[16];
+        GLint i[4];
+        GLuint u[4];
+        switch (type)
+        {
+            case GL_FLOAT:             glGetUniformfv(source, from, f); glUniform1fv(to, 1, f); break;
+            case GL_FLOAT_VEC2:        glGetUniformfv(source, from, f); glUniform2fv(to, 1, f); break;
+            case GL_FLOAT_VEC3:        glGetUniformfv(source, from, f); glUniform3fv(to, 1, f); break;
+            case GL_FLOAT_VEC4:        glGetUniformfv(source, from, f); glUniform4fv(to, 1, f); break;
+            case GL_FLOAT_MAT2:        glGetUniformfv(source, from, f); glUniformMatrix2fv(to, 1, GL_FALSE, f); break;
+            case GL_FLOAT_MAT3:        glGetUniformfv(source, from, f); glUniformMatrix3fv(to, 1, GL_FALSE, f); break;
+            case GL_FLOAT_MAT4:        glGetUniformfv(source, from, f); glUniformMatrix4fv(to, 1, GL_FALSE, f); break;
+            case GL_INT_VEC2:
+            case GL_BOOL_VEC2:         glGetUniformiv(source, from, i); glUniform2iv(to, 1, i); break;
+            case GL_INT_VEC3:
+            case GL_BOOL_VEC3:         glGetUniformiv(source, from, i); glUniform3iv(to, 1, i); break;
+            case GL_INT_VEC4:
+            case GL_BOOL_VEC4:         glGetUniformiv(source, from, i); glUniform4iv(to, 1, i); break;
+            case GL_UNSIGNED_INT:      glGetUniformuiv(source, from, u); glUniform1uiv(to, 1, u); break;
+            case GL_UNSIGNED_INT_VEC2: glGetUniformuiv(source, from, u); glUniform2uiv(to, 1, u); break;
+            case GL_UNSIGNED_INT_VEC3: glGetUniformuiv(source, from, u); glUniform3uiv(to, 1, u); break;
+            case GL_UNSIGNED_INT_VEC4: glGetUniformuiv(source, from, u); glUniform4uiv(to, 1, u); break;
+            // int, bool and sampler units
+            default:                   glGetUniformiv(source, from, i); glUniform1iv(to, 1, i); break;
+        }
     }
-    return code;
 }
 
-void checkShaderCompilation(unsigned int shaderID)
+void Shader::replace(unsigned int programID)
 {
-    // Check if shader compiles right
-    int success;
-    glGetShaderiv(shaderID, GL_COMPILE_STATUS, &success);
-    if (!success)
+    // 1. uniform values: every element of uniforms active in both programs with the same type
+    GLint current = 0;
+    glGetIntegerv(GL_CURRENT_PROGRAM, &current);
+    glUseProgram(programID);
+    std::vector<ActiveUniform> uniforms = activeUniforms(programID);
+    std::string element;
+    for (ActiveUniform const & active : activeUniforms(ID))
     {
-        char infoLog[1024]; 
-        glGetShaderInfoLog(shaderID, sizeof(infoLog), NULL, infoLog);
-        std::cerr << "ERROR::SHADER::VERTEX::COMPILATION_FAILED\n" << infoLog << std::endl;
+        auto it = std::find_if(uniforms.begin(), uniforms.end(),
+            [&active](ActiveUniform const & u) { return u.name == active.name && u.type == active.type; });
+        if (it == uniforms.end())
+            continue;
+
+        // arrays of basic types: "name[0]" is reported with array size
+        bool array = active.size > 1;
+        std::string_view base = active.name;
+        if (array)
+            base.remove_suffix(3);
+        for (GLint e = 0; e < std::min(active.size, it->size); ++e)
+        {
+            element.assign(base);
+            if (array)
+                element += '[' + std::to_string(e) + ']';
+            GLint from = glGetUniformLocation(ID, element.c_str());
+            GLint to = glGetUniformLocation(programID, element.c_str());
+            if (from >= 0 && to >= 0)
+                copyUniform(ID, from, to, active.type);
+        }
     }
+    glUseProgram(GLuint(current) == ID ? programID : GLuint(current));
+
+    // 2. uniform block bindings by block name
+    GLint blocks = 0, maxLength = 0;
+    glGetProgramiv(ID, GL_ACTIVE_UNIFORM_BLOCKS, &blocks);
+    glGetProgramiv(ID, GL_ACTIVE_UNIFORM_BLOCK_MAX_NAME_LENGTH, &maxLength);
+    std::string blockName(size_t(maxLength), '\0');
+    for (GLint b = 0; b < blocks; ++b)
+    {
+        GLsizei length = 0;
+        GLint binding = 0;
+        glGetActiveUniformBlockName(ID, GLuint(b), maxLength, &length, blockName.data());
+        glGetActiveUniformBlockiv(ID, GLuint(b), GL_UNIFORM_BLOCK_BINDING, &binding);
+        GLuint index = glGetUniformBlockIndex(programID, blockName.substr(0, size_t(length)).c_str());
+        if (index != GL_INVALID_INDEX)
+            glUniformBlockBinding(programID, index, GLuint(binding));
+    }
+
+    // 3. swap: names stay in the table, so handles and struct arrays keep their index
+    glDeleteProgram(ID);
+    ID = programID;
+    for (int i = 0; i < uniformTable.size(); ++i)
+        uniformTable.setLocation(i, -1);
+    reflectUniforms();
 }
 
-void checkProgramLink(unsigned int programID)
+void Shader::reflectUniforms()
 {
-    int success = 1;
-    glGetProgramiv(programID, GL_LINK_STATUS, &success);
-    if (!success)
+    GLint count = 0, maxLength = 0;
+    glGetProgramiv(ID, GL_ACTIVE_UNIFORMS, &count);
+    glGetProgramiv(ID, GL_ACTIVE_UNIFORM_MAX_LENGTH, &maxLength);
+
+    std::string name(size_t(maxLength), '\0');
+    std::string element;
+    for (GLint i = 0; i < count; ++i)
     {
-        char logInfo[1024];
-        glGetProgramInfoLog(programID, sizeof(logInfo), NULL, logInfo);
-        std::cerr << "ERROR::SHADER::PROGRAM::LINK_FAILED\n" << logInfo << std::endl;
+        GLsizei length = 0;
+        GLint size = 0;
+        GLenum type = 0;
+        glGetActiveUniform(ID, GLuint(i), maxLength, &length, &size, &type, name.data());
+
+        GLint loc = glGetUniformLocation(ID, name.c_str());
+        // members of uniform blocks have no location
+        if (loc < 0)
+            continue;
+
+        std::string_view activeName(name.data(), size_t(length));
+        uniformTable.insert(activeName, loc);
 
+        // arrays of basic types are reported once as "name[0]": register "name" and every element
+        constexpr std::string_view firstElement = "[0]";
+        if (activeName.size() > firstElement.size() &&
+            activeName.substr(activeName.size() - firstElement.size()) == firstElement)
+        {
+            std::string_view base = activeName.substr(0, activeName.size() - firstElement.size());
+            uniformTable.insert(base, loc);
+            for (GLint e = 1; e < size; ++e)
+            {
+                element.assign(base);
+                element += '[' + std::to_string(e) + ']';
+                uniformTable.insert(element, glGetUniformLocation(ID, element.c_str()));
+            }
+        }
     }
+    reflectStructArrays();
 }
 
-Shader::Shader(const char * vertexPath, const char * fragmentPath)
+namespace
 {
-    // 1. Read files
-    auto vertexCodeStr = readCodeFromFile(vertexPath);
-    auto fragmentCodeStr = readCodeFromFile(fragmentPath);
-    const char * vertexCode = vertexCodeStr.c_str();
-    const char * fragmentCode = fragmentCodeStr.c_str();
+    // "base[element].member" split into parts
+    struct StructArrayName
+    {
+        std::string_view base;
+        size_t element{0};
+        std::string_view member;
+    };
+
+    bool parseStructArrayName(std::string_view name, StructArrayName & out)
+    {
+        size_t open = name.find('[');
+        if (open == std::string_view::npos)
+            return false;
+        size_t close = name.find(']', open);
+        if (close == std::string_view::npos || close + 2 >= name.size() || name[close + 1] != '.')
+            return false;
+
+        auto result = std::from_chars(name.data() + open + 1, name.data() + close, out.element);
+        if (result.ec != std::errc() || result.ptr != name.data() + close)
+            return false;
+
+        out.base = name.substr(0, open);
+        out.member = name.substr(close + 2);
+        return true;
+    }
+}
+
+void Shader::reflectStructArrays()
+{
+    auto findArray = [this](std::string_view base) {
+        return std::find_if(structArrays.begin(), structArrays.end(),
+            [base](UniformStructArrayInfo const & info) { return info.name == base; });
+    };
+
+    // 1. collect members and element count of every array
+    StructArrayName parsed;
+    for (int i = 0; i < uniformTable.size(); ++i)
+    {
+        if (!parseStructArrayName(uniformTable.name(i), parsed))
+            continue;
+
+        auto it = findArray(parsed.base);
+        if (it == structArrays.end())
+        {
+            structArrays.emplace_back();
+            it = std::prev(structArrays.end());
+            it->name = parsed.base;
+        }
+        if (it->member(parsed.member) == UniformTable::npos)
+            it->members.emplace_back(parsed.member);
+        it->count = std::max(it->count, parsed.element + 1);
+    }
 
-    // 2. Compile shaders
-    unsigned int vertexID, fragmentID;
+    // 2. fill handle grid, members inactive in some element keep invalid handle
+    for (auto & info : structArrays)
+        info.handles.assign(info.count * info.members.size(), UniformHandle{});
 
-    vertexID = glCreateShader(GL_VERTEX_SHADER);
-    glShaderSource(vertexID, 1, &vertexCode, NULL);
-    glCompileShader(vertexID);
-    checkShaderCompilation(vertexID);
+    for (int i = 0; i < uniformTable.size(); ++i)
+    {
+        if (!parseStructArrayName(uniformTable.name(i), parsed))
+            continue;
 
-    fragmentID = glCreateShader(GL_FRAGMENT_SHADER);
-    glShaderSource(fragmentID, 1, &fragmentCode, NULL);
-    glCompileShader(fragmentID);
-    checkShaderCompilation(fragmentID);
+        auto it = findArray(parsed.base);
+        size_t member = size_t(it->member(parsed.member));
+        it->handles[parsed.element * it->members.size() + member] = UniformHandle{i};
+    }
+}
 
-    ID = glCreateProgram();
-    glAttachShader(ID, vertexID);
-    glAttachShader(ID, fragmentID);
-    glLinkProgram(ID);
-    checkProgramLink(ID);
+int UniformStructArrayInfo::member(std::string_view memberName) const
+{
+    for (size_t i = 0; i < members.size(); ++i)
+    {
+        if (members[i] == memberName)
+            return int(i);
+    }
+    return UniformTable::npos;
+}
 
-    // delete the shaders as they're linked into out program now and no longer necessary
-    glDeleteShader(vertexID);
-    glDeleteShader(fragmentID);
+UniformStructArray Shader::structArray(std::string_view name) const
+{
+    for (size_t i = 0; i < structArrays.size(); ++i)
+    {
+        if (structArrays[i].name == name)
+            return UniformStructArray(*this, int(i));
+    }
+    return UniformStructArray(*this, UniformTable::npos);
 }
 
-void Shader::use() const
+UniformStructArrayInfo const & Shader::structArrayInfo(int array) const
 {
-    glUseProgram(ID);
+    // arrays are only appended (reload keeps their place), destroy() drops all of them
+    static const UniformStructArrayInfo empty;
+    return array == UniformTable::npos || size_t(array) >= structArrays.size() ? empty : structArrays[size_t(array)];
+}
+
+bool Shader::bindUniformBlock(std::string const & blockName, GLuint bindingPoint) const
+{
+    GLuint blockIndex = glGetUniformBlockIndex(ID, blockName.c_str());
+    if (blockIndex == GL_INVALID_INDEX)
+        return false;
+    glUniformBlockBinding(ID, blockIndex, bindingPoint);
+    return true;
+}
+
+// Array-of-struct element
+UniformStructArrayInfo const & UniformStruct::info() const { return shader->structArrayInfo(array); }
+UniformStructArrayInfo const & UniformStructArray::info() const { return shader->structArrayInfo(array); }
+
+UniformHandle UniformStruct::handle(int member) const
+{
+    UniformStructArrayInfo const & arrayInfo = info();
+    if (member == UniformTable::npos || index >= arrayInfo.count)
+        return UniformHandle{};
+    return arrayInfo.handles[index * arrayInfo.members.size() + size_t(member)];
+}
+
+void UniformStruct::set(int member, bool value) const { shader->setBool(handle(member), value); }
+void UniformStruct::set(int member, int value) const { shader->setInt(handle(member), value); }
+void UniformStruct::set(int member, float value) const { shader->setFloat(handle(member), value); }
+void UniformStruct::set(int member, glm::vec2 const & value) const { shader->setVec2(handle(member), value); }
+void UniformStruct::set(int member, glm::vec3 const & value) const { shader->setVec3(handle(member), value); }
+void UniformStruct::set(int member, glm::vec4 const & value) const { shader->setVec4(handle(member), value); }
+void UniformStruct::set(int member, glm::mat3 const & value) const { shader->setMat3(handle(member), value); }
+void UniformStruct::set(int member, glm::mat4 const & value) const { shader->setMat4(handle(member), value); }
+
+UniformHandle Shader::uniform(std::string_view name) const
+{
+    return UniformHandle{uniformTable.find(name)};
 }
 // Set uniforms
 // Trivial
-void Shader::setBool(std::string const & name, bool value) const
+void Shader::setBool(std::string_view name, bool value) const
+{
+    glUniform1i(location(name), value);
+}
+
+void Shader::setInt(std::string_view name, int value) const
+{
+    glUniform1i(location(name), value);
+}
+
+void Shader::setFloat(std::string_view name, float value) const
+{
+    glUniform1f(location(name), value);
+}
+
+// Vectors
+void Shader::setVec2(std::string_view name, glm::vec2 const & value) const
+{
+    glUniform2fv(location(name), 1, glm::value_ptr(value));
+}
+
+void Shader::setVec3(std::string_view name, glm::vec3 const & value) const
+{
+    glUniform3fv(location(name), 1, glm::value_ptr(value));
+}
+
+void Shader::setVec4(std::string_view name, glm::vec4 const & value) const
+{
+    glUniform4fv(location(name), 1, glm::value_ptr(value));
+}
+
+void Shader::setVec2(std::string_view name, float x, float y) const
+{
+    glUniform2f(location(name), x, y);
+
+}
+void Shader::setVec3(std::string_view name, float x, float y, float z) const
+{
+    glUniform3f(location(name), x, y, z);
+}
+void Shader::setVec4(std::string_view name, float x, float y, float z, float w) const
+{
+    glUniform4f(location(name), x, y, z, w);
+}
+
+// Matrix
+void Shader::setMat2(std::string_view name, glm::mat2 const & value) const
+{
+    glUniformMatrix2fv(location(name), 1, GL_FALSE, glm::value_ptr(value));
+}
+
+void Shader::setMat3(std::string_view name, glm::mat3 const & value) const
+{
+    glUniformMatrix3fv(location(name), 1, GL_FALSE, glm::value_ptr(value));
+}
+
+void Shader::setMat4(std::string_view name, glm::mat4 const & value) const
+{
+    glUniformMatrix4fv(location(name), 1, GL_FALSE, glm::value_ptr(value));
+}
+
+// More flexible variant
+void Shader::setMatrix4Float(std::string_view name, GLsizei count, GLboolean transpose, GLfloat const * value) const
+{
+    glUniformMatrix4fv(location(name), count, transpose, value);
+}
+
+// Set uniforms by pre-resolved handle
+// Trivial
+void Shader::setBool(UniformHandle handle, bool value) const
 {
-    glUniform1i(glGetUniformLocation(ID, name.c_str()), value);
+    glUniform1i(location(handle), value);
 }
 
-void Shader::setInt(std::string const & name, int value) const
+void Shader::setInt(UniformHandle handle, int value) const
 {
-    glUniform1i(glGetUniformLocation(ID, name.c_str()), value);
+    glUniform1i(location(handle), value);
 }
 
-void Shader::setFloat(std::string const & name, float value) const
+void Shader::setFloat(UniformHandle handle, float value) const
 {
-    glUniform1f(glGetUniformLocation(ID, name.c_str()), value);
+    glUniform1f(location(handle), value);
 }
 
 // Vectors
-void Shader::setVec2(std::string const & name, glm::vec2 const & value) const
+void Shader::setVec2(UniformHandle handle, glm::vec2 const & value) const
 {
-    glUniform2fv(glGetUniformLocation(ID, name.c_str()), 1, glm::value_ptr(value));
+    glUniform2fv(location(handle), 1, glm::value_ptr(value));
 }
 
-void Shader::setVec3(std::string const & name, glm::vec3 const & value) const
+void Shader::setVec3(UniformHandle handle, glm::vec3 const & value) const
 {
-    glUniform3fv(glGetUniformLocation(ID, name.c_str()), 1, glm::value_ptr(value));
+    glUniform3fv(location(handle), 1, glm::value_ptr(value));
 }
 
-void Shader::setVec4(std::string const & name, glm::vec4 const & value) const
+void Shader::setVec4(UniformHandle handle, glm::vec4 const & value) const
 {
-    glUniform4fv(glGetUniformLocation(ID, name.c_str()), 1, glm::value_ptr(value));
+    glUniform4fv(location(handle), 1, glm::value_ptr(value));
 }
 
-void Shader::setVec2(std::string const & name, float x, float y) const
+void Shader::setVec2(UniformHandle handle, float x, float y) const
 {
-    glUniform2f(glGetUniformLocation(ID, name.c_str()), x, y);
+    glUniform2f(location(handle), x, y);
 
 }
-void Shader::setVec3(std::string const & name, float x, float y, float z) const
+void Shader::setVec3(UniformHandle handle, float x, float y, float z) const
 {
-    glUniform3f(glGetUniformLocation(ID, name.c_str()), x, y, z);
+    glUniform3f(location(handle), x, y, z);
 }
-void Shader::setVec4(std::string const & name, float x, float y, float z, float w) const
+void Shader::setVec4(UniformHandle handle, float x, float y, float z, float w) const
 {
-    glUniform4f(glGetUniformLocation(ID, name.c_str()), x, y, z, w);
+    glUniform4f(location(handle), x, y, z, w);
 }
 
 // Matrix
-void Shader::setMat2(std::string const & name, glm::mat2 const & value) const
+void Shader::setMat2(UniformHandle handle, glm::mat2 const & value) const
 {
-    glUniformMatrix2fv(glGetUniformLocation(ID, name.c_str()), 1, GL_FALSE, glm::value_ptr(value));
+    glUniformMatrix2fv(location(handle), 1, GL_FALSE, glm::value_ptr(value));
 }
 
-void Shader::setMat3(std::string const & name, glm::mat3 const & value) const
+void Shader::setMat3(UniformHandle handle, glm::mat3 const & value) const
 {
-    glUniformMatrix3fv(glGetUniformLocation(ID, name.c_str()), 1, GL_FALSE, glm::value_ptr(value));
+    glUniformMatrix3fv(location(handle), 1, GL_FALSE, glm::value_ptr(value));
 }
 
-void Shader::setMat4(std::string const & name, glm::mat4 const & value) const
+void Shader::setMat4(UniformHandle handle, glm::mat4 const & value) const
 {
-    glUniformMatrix4fv(glGetUniformLocation(ID, name.c_str()), 1, GL_FALSE, glm::value_ptr(value));
+    glUniformMatrix4fv(location(handle), 1, GL_FALSE, glm::value_ptr(value));
 }
 
 // More flexible variant
-void Shader::setMatrix4Float(std::string const & name, GLsizei count, GLboolean transpose, GLfloat const * value) const
+void Shader::setMatrix4Float(UniformHandle handle, GLsizei count, GLboolean transpose, GLfloat const * value) const
 {
-    glUniformMatrix4fv(glGetUniformLocation(ID, name.c_str()), count, transpose, value);
+    glUniformMatrix4fv(location(handle), count, transpose, value);
 }
 
 unsigned int Shader::getID() const 
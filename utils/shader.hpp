@@ -3,37 +3,180 @@
 #include <glad/glad.h>
 #include <glm/glm.hpp>
 
+#include "uniform_table.hpp"
+
 #include <string>
+#include <string_view>
+#include <vector>
+
+//! @brief Pre-resolved reference to a shader uniform.
+//! Get it once with Shader::uniform() and use it in hot loops instead of a name.
+struct UniformHandle
+{
+    int index{UniformTable::npos};
+
+    bool isValid() const { return index != UniformTable::npos; }
+};
+
+class Shader;
+
+//! @brief Reflection of an array-of-struct uniform, e.g. "pointLights[NR_POINT_LIGHTS]".
+//! Names of all "name[i].member" uniforms are resolved once after link.
+struct UniformStructArrayInfo
+{
+    std::string name;
+    std::vector<std::string> members;
+    //! @brief handles[element * members.size() + member]
+    std::vector<UniformHandle> handles;
+    size_t count{0};
+
+    // index of struct member (npos if member is not active in any element)
+    int member(std::string_view memberName) const;
+};
+
+//! @brief One element of an array-of-struct uniform, e.g. "pointLights[2]".
+//! Cheap value type: keeps the index of the array in its Shader (like UniformHandle), so it stays valid when the
+//! program is replaced (hot reload). Member lookup is a scan over names resolved at link time.
+class UniformStruct
+{
+public:
+    UniformStruct(Shader const & shader, int array, size_t index)
+        : shader(&shader), array(array), index(index) {}
+
+    UniformHandle handle(int member) const;
+    UniformHandle handle(std::string_view member) const { return handle(info().member(member)); }
+
+    template <typename T>
+    void set(std::string_view member, T const & value) const { set(info().member(member), value); }
+
+    void set(int member, bool value) const;
+    void set(int member, int value) const;
+    void set(int member, float value) const;
+    void set(int member, glm::vec2 const & value) const;
+    void set(int member, glm::vec3 const & value) const;
+    void set(int member, glm::vec4 const & value) const;
+    void set(int member, glm::mat3 const & value) const;
+    void set(int member, glm::mat4 const & value) const;
+
+private:
+    UniformStructArrayInfo const & info() const;
+
+    Shader const * shader;
+    int array;
+    size_t index;
+};
+
+//! @brief View of an array-of-struct uniform of a Shader (index of the array, see UniformStruct)
+class UniformStructArray
+{
+public:
+    UniformStructArray(Shader const & shader, int array)
+        : shader(&shader), array(array) {}
+
+    size_t size() const { return info().count; }
+    // index of struct member, pass it to UniformStruct::set to skip name comparison
+    int member(std::string_view memberName) const { return info().member(memberName); }
+
+    UniformStruct at(size_t index) const { return UniformStruct(*shader, array, index); }
+    UniformStruct operator[](size_t index) const { return at(index); }
+
+private:
+    UniformStructArrayInfo const & info() const;
+
+    Shader const * shader;
+    int array;
+};
 
 class Shader
 {
 public:
-    // main constructor
+    // empty shader, assign a constructed one before use
+    Shader() = default;
+    // main constructor (several programs at once: ShaderLibrary)
     Shader(const char * vertexShaderPath, const char * fragmentShaderPath);
+    // ShaderLibrary, ShaderWatcher and struct array views keep the address of a shader
+    Shader(Shader const &) = delete;
+    Shader & operator=(Shader const &) = delete;
     // use/activate shader
     void use() const;
+    // delete program, call before context is destroyed
+    void destroy();
+    // resolve uniform name to handle (invalid handle if uniform is not active)
+    UniformHandle uniform(std::string_view name) const;
+    // array-of-struct uniform (empty array if uniform is not active)
+    UniformStructArray structArray(std::string_view name) const;
+    // attach uniform block to binding point of a UniformBuffer (false if block is not active)
+    bool bindUniformBlock(std::string const & blockName, GLuint bindingPoint) const;
     // utility uniform functions
-    void setBool(std::string const & name, bool value) const;
-    void setInt(std::string const & name, int value) const;
-    void setFloat(std::string const & name, float value) const;
-
-    void setVec2(std::string const & name, glm::vec2 const & value) const;
-    void setVec3(std::string const & name, glm::vec3 const & value) const;
-    void setVec4(std::string const & name, glm::vec4 const & value) const;
-
-    void setVec2(std::string const & name, float x, float y) const;
-    void setVec3(std::string const & name, float x, float y, float z) const;
-    void setVec4(std::string const & name, float x, float y, float z, float w) const;
-
-    void setMat2(std::string const & name, glm::mat2 const & value) const;
-    void setMat3(std::string const & name, glm::mat3 const & value) const;
-    void setMat4(std::string const & name, glm::mat4 const & value) const;
-    
-    void setMatrix4Float(std::string const & name, GLsizei count, GLboolean transpose, GLfloat const * value) const;
+    void setBool(std::string_view name, bool value) const;
+    void setInt(std::string_view name, int value) const;
+    void setFloat(std::string_view name, float value) const;
+
+    void setVec2(std::string_view name, glm::vec2 const & value) const;
+    void setVec3(std::string_view name, glm::vec3 const & value) const;
+    void setVec4(std::string_view name, glm::vec4 const & value) const;
+
+    void setVec2(std::string_view name, float x, float y) const;
+    void setVec3(std::string_view name, float x, float y, float z) const;
+    void setVec4(std::string_view name, float x, float y, float z, float w) const;
+
+    void setMat2(std::string_view name, glm::mat2 const & value) const;
+    void setMat3(std::string_view name, glm::mat3 const & value) const;
+    void setMat4(std::string_view name, glm::mat4 const & value) const;
+
+    void setMatrix4Float(std::string_view name, GLsizei count, GLboolean transpose, GLfloat const * value) const;
+    // same by handle
+    void setBool(UniformHandle handle, bool value) const;
+    void setInt(UniformHandle handle, int value) const;
+    void setFloat(UniformHandle handle, float value) const;
+
+    void setVec2(UniformHandle handle, glm::vec2 const & value) const;
+    void setVec3(UniformHandle handle, glm::vec3 const & value) const;
+    void setVec4(UniformHandle handle, glm::vec4 const & value) const;
+
+    void setVec2(UniformHandle handle, float x, float y) const;
+    void setVec3(UniformHandle handle, float x, float y, float z) const;
+    void setVec4(UniformHandle handle, float x, float y, float z, float w) const;
+
+    void setMat2(UniformHandle handle, glm::mat2 const & value) const;
+    void setMat3(UniformHandle handle, glm::mat3 const & value) const;
+    void setMat4(UniformHandle handle, glm::mat4 const & value) const;
+
+    void setMatrix4Float(UniformHandle handle, GLsizei count, GLboolean transpose, GLfloat const * value) const;
     // get program id
     unsigned int getID() const;
 
 private:
+    friend class ShaderLibrary;
+    friend class UniformStruct;
+    friend class UniformStructArray;
+
+    //! @brief Take linked program and reflect its uniforms
+    void assign(unsigned int programID);
+    //! @brief Swap in rebuilt program (hot reload): uniform values and block bindings are copied from the old one,
+    //! handles keep their index (uniforms the new program lacks get location -1)
+    void replace(unsigned int programID);
+    //! @brief Add active uniforms of linked program to uniform table (existing names keep index, get new location)
+    void reflectUniforms();
+    //! @brief Group "name[i].member" uniforms into struct arrays (existing arrays keep their place)
+    void reflectStructArrays();
+    //! @brief Struct array by index (empty array for npos)
+    UniformStructArrayInfo const & structArrayInfo(int array) const;
+
+    GLint location(std::string_view name) const
+    {
+        int index = uniformTable.find(name);
+        return index == UniformTable::npos ? -1 : uniformTable.location(index);
+    }
+    GLint location(UniformHandle handle) const
+    {
+        return handle.isValid() ? uniformTable.location(handle.index) : -1;
+    }
+
     //! @brief Program id
     unsigned int ID{0};
-};
\ No newline at end of file
+    //! @brief Active uniforms of the program
+    UniformTable uniformTable;
+    //! @brief Active array-of-struct uniforms
+    std::vector<UniformStructArrayInfo> structArrays;
+};
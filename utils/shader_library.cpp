@@ -0,0 +1,265 @@
+#include "shader_library.hpp"
+
+#include "asset_pack.hpp"
+#include "program_cache.hpp"
+#include "shader_watcher.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <fstream>
+#include <iostream>
+#include <thread>
+
+namespace
+{
+    // programs of all libraries (GL thread only)
+    size_t sSubmitted = 0;
+    size_t sCached = 0;
+
+    std::string readCodeFromFile(std::string const & path)
+    {
+        // straight into the result, no stream buffer copy
+        std::ifstream file(path, std::ios::binary | std::ios::ate);
+        if (!file)
+        {
+            std::cout << "ERROR::SHADER::FILE_NOT_SUCCESFULLY_READ " << path << std::endl;
+            return {};
+        }
+        std::string code(size_t(file.tellg()), '\0');
+        file.seekg(0);
+        file.read(code.data(), std::streamsize(code.size()));
+        return code;
+    }
+
+    // source of shader: view into the mounted asset pack, loose file is read into storage only without pack entry
+    std::string_view readCode(std::string const & path, std::string & storage)
+    {
+        std::string_view packed = AssetPack::mounted().find(path);
+        if (!packed.empty())
+            return packed;
+        storage = readCodeFromFile(path);
+        return storage;
+    }
+
+    // reload: edited loose file, asset pack has the one of the build
+    std::string_view readChangedCode(std::string const & path, std::string & storage)
+    {
+        std::ifstream file(path);
+        if (!file)
+            return readCode(path, storage);
+        storage = readCodeFromFile(path);
+        return storage;
+    }
+
+    // defines go right after "#version" (first statement of the source), "#line" keeps line numbers of compile errors
+    std::string_view insertDefines(std::string_view source, std::string const & defines, std::string & storage)
+    {
+        if (defines.empty())
+            return source;
+        size_t versionEnd = source.rfind("#version", 0) == 0 ? source.find('\n') : std::string_view::npos;
+        size_t bodyStart = versionEnd == std::string_view::npos ? 0 : versionEnd + 1;
+
+        std::string code;
+        code.reserve(source.size() + defines.size() + 16);
+        code.append(source.substr(0, bodyStart)).append(defines);
+        if (defines.back() != '\n')
+            code += '\n';
+        code.append("#line ").append(std::to_string(bodyStart == 0 ? 1 : 2)).append("\n");
+        code.append(source.substr(bodyStart));
+        storage = std::move(code);
+        return storage;
+    }
+
+    // compile log of a failed stage (link error alone does not tell which file)
+    void checkShaderCompilation(unsigned int shaderID, const char * stage, std::string const & path)
+    {
+        int success;
+        glGetShaderiv(shaderID, GL_COMPILE_STATUS, &success);
+        if (!success)
+        {
+            char infoLog[1024];
+            glGetShaderInfoLog(shaderID, sizeof(infoLog), NULL, infoLog);
+            std::cerr << "ERROR::SHADER::" << stage << "::COMPILATION_FAILED " << path << "\n" << infoLog << std::endl;
+        }
+    }
+}
+
+void ShaderLibrary::add(Shader & shader, std::string vertexPath, std::string fragmentPath, std::string defines)
+{
+    Program program;
+    program.shader = &shader;
+    program.vertex.type = GL_VERTEX_SHADER;
+    program.vertex.path = std::move(vertexPath);
+    program.fragment.type = GL_FRAGMENT_SHADER;
+    program.fragment.path = std::move(fragmentPath);
+    program.defines = std::move(defines);
+    programs.push_back(std::move(program));
+}
+
+void ShaderLibrary::read(Program & program, std::string const & driver) const
+{
+    // sources in asset pack are not copied: explicit length, no terminating zero
+    auto readSource = reload ? readChangedCode : readCode;
+    program.vertex.source = readSource(program.vertex.path, program.vertex.storage);
+    program.fragment.source = readSource(program.fragment.path, program.fragment.storage);
+    program.vertex.source = insertDefines(program.vertex.source, program.defines, program.vertex.storage);
+    program.fragment.source = insertDefines(program.fragment.source, program.defines, program.fragment.storage);
+    program.cacheKey = ProgramCache::keyFor({program.vertex.source, program.fragment.source}, program.defines, driver);
+}
+
+void ShaderLibrary::readAll(std::string const & driver)
+{
+    size_t threads = std::min<size_t>(programs.size(), std::max(1u, std::thread::hardware_concurrency()));
+    if (threads <= 1)
+    {
+        for (Program & program : programs)
+            read(program, driver);
+        return;
+    }
+
+    std::atomic<size_t> next{0};
+    std::vector<std::thread> workers;
+    for (size_t t = 0; t < threads; ++t)
+    {
+        workers.emplace_back([this, &next, &driver] {
+            for (size_t i = next++; i < programs.size(); i = next++)
+                read(programs[i], driver);
+        });
+    }
+    for (std::thread & worker : workers)
+        worker.join();
+}
+
+void ShaderLibrary::compile(Stage & stage)
+{
+    const char * code = stage.source.data();
+    auto length = GLint(stage.source.size());
+    stage.ID = glCreateShader(stage.type);
+    glShaderSource(stage.ID, 1, &code, &length);
+    glCompileShader(stage.ID);
+}
+
+size_t ShaderLibrary::submittedTotal()
+{
+    return sSubmitted;
+}
+
+size_t ShaderLibrary::cachedTotal()
+{
+    return sCached;
+}
+
+void ShaderLibrary::submit()
+{
+    // 1. Read files (driver strings are read here: GL calls stay on this thread)
+    readAll(ProgramCache::driverId());
+
+    // 2. Warm start: binaries of the same sources on the same driver, linked as they are
+    for (Program & program : programs)
+    {
+        program.ID = glCreateProgram();
+        program.cached = ProgramCache::load(program.ID, program.cacheKey);
+        sCached += program.cached ? 1 : 0;
+    }
+    sSubmitted += programs.size();
+
+    // 3. Submit compile of every stage, then link of every program: no status query in between
+    if (GLAD_GL_KHR_parallel_shader_compile)
+        glMaxShaderCompilerThreadsKHR(0xFFFFFFFFu);
+    for (Program & program : programs)
+    {
+        if (program.cached)
+            continue;
+        compile(program.vertex);
+        compile(program.fragment);
+    }
+    for (Program & program : programs)
+    {
+        if (program.cached)
+            continue;
+        glAttachShader(program.ID, program.vertex.ID);
+        glAttachShader(program.ID, program.fragment.ID);
+        ProgramCache::prepare(program.ID, program.cacheKey);
+        glLinkProgram(program.ID);
+    }
+}
+
+bool ShaderLibrary::isReady() const
+{
+    if (!GLAD_GL_KHR_parallel_shader_compile)
+        return true;
+    for (Program const & program : programs)
+    {
+        GLint done = GL_TRUE;
+        if (program.ID != 0 && !program.cached)
+            glGetProgramiv(program.ID, GL_COMPLETION_STATUS_KHR, &done);
+        if (!done)
+            return false;
+    }
+    return true;
+}
+
+bool ShaderLibrary::finish()
+{
+    // check programs that are done first (KHR_parallel_shader_compile), then wait for the rest in order
+    bool success = true;
+    std::vector<bool> finished(programs.size(), false);
+    if (GLAD_GL_KHR_parallel_shader_compile)
+    {
+        for (size_t i = 0; i < programs.size(); ++i)
+        {
+            GLint done = GL_TRUE;
+            if (!programs[i].cached)
+                glGetProgramiv(programs[i].ID, GL_COMPLETION_STATUS_KHR, &done);
+            if (done)
+            {
+                success = finish(programs[i]) && success;
+                finished[i] = true;
+            }
+        }
+    }
+    for (size_t i = 0; i < programs.size(); ++i)
+    {
+        if (!finished[i])
+            success = finish(programs[i]) && success;
+    }
+    return success;
+}
+
+bool ShaderLibrary::finish(Program & program) const
+{
+    bool success = true;
+    if (!program.cached)
+    {
+        int linked = 0;
+        glGetProgramiv(program.ID, GL_LINK_STATUS, &linked);
+        if (linked)
+        {
+            ProgramCache::store(program.ID, program.cacheKey);
+        }
+        else
+        {
+            checkShaderCompilation(program.vertex.ID, "VERTEX", program.vertex.path);
+            checkShaderCompilation(program.fragment.ID, "FRAGMENT", program.fragment.path);
+            char logInfo[1024];
+            glGetProgramInfoLog(program.ID, sizeof(logInfo), NULL, logInfo);
+            std::cerr << "ERROR::SHADER::PROGRAM::LINK_FAILED\n" << logInfo << std::endl;
+            success = false;
+        }
+        // delete the shaders as they're linked into out program now and no longer necessary
+        glDeleteShader(program.vertex.ID);
+        glDeleteShader(program.fragment.ID);
+        program.vertex.ID = program.fragment.ID = 0;
+    }
+    if (!reload)
+    {
+        program.shader->assign(program.ID);
+        ShaderWatcher::active().watch(*program.shader, program.vertex.path, program.fragment.path, program.defines);
+    }
+    else if (success)
+        program.shader->replace(program.ID);
+    else
+        glDeleteProgram(program.ID);
+    program.ID = 0;
+    return success;
+}
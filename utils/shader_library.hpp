@@ -0,0 +1,80 @@
+#pragma once
+
+#include "shader.hpp"
+
+#include <glad/glad.h>
+
+#include <string>
+#include <string_view>
+#include <vector>
+
+//! @brief All shader programs of a scene built at once.
+//! Sources are read (asset pack or files), get their defines and are hashed on worker threads; then every compile and link is submitted
+//! before any status is queried, so the driver overlaps them (KHR_parallel_shader_compile: on its own threads)
+//! and startup waits for the slowest program instead of the sum of all.
+//! Programs of the binary cache (ProgramCache) are loaded without compiling.
+//! Reload mode (ShaderWatcher) reads the files before the asset pack and replaces the program of a shader
+//! only if the new one links (Shader::replace keeps uniform values and handles).
+class ShaderLibrary
+{
+public:
+    explicit ShaderLibrary(bool reload = false) : reload(reload) {}
+    // queued programs point into the library: not copied or moved
+    ShaderLibrary(ShaderLibrary const &) = delete;
+    ShaderLibrary & operator=(ShaderLibrary const &) = delete;
+
+    // queue program, the shader is assigned by build() or finish().
+    // Defines ("#define" lines) are inserted after "#version" of both stages
+    void add(Shader & shader, std::string vertexPath, std::string fragmentPath, std::string defines = {});
+    // GL thread: build all queued programs, false if any of them failed (errors are printed, shader is assigned anyway)
+    bool build()
+    {
+        submit();
+        return finish();
+    }
+
+    // GL thread: read sources, load binaries and submit compile and link of the rest
+    void submit();
+    // GL thread: all submitted programs are linked, finish() will not wait (always true without KHR_parallel_shader_compile)
+    bool isReady() const;
+    // GL thread: wait for submitted programs and assign them, false if any of them failed
+    bool finish();
+
+    size_t size() const { return programs.size(); }
+    // programs submitted by all libraries so far and those of them loaded from the binary cache (startup report)
+    static size_t submittedTotal();
+    static size_t cachedTotal();
+
+private:
+    struct Stage
+    {
+        GLenum type;
+        std::string path;
+        //! @brief File content when there is no asset pack entry
+        std::string storage;
+        std::string_view source;
+        unsigned int ID{0};
+    };
+
+    struct Program
+    {
+        Shader * shader;
+        Stage vertex;
+        Stage fragment;
+        std::string defines;
+        std::string cacheKey;
+        unsigned int ID{0};
+        bool cached{false};
+    };
+
+    // worker: sources with defines and binary cache key of the program
+    void read(Program & program, std::string const & driver) const;
+    // read all programs, on worker threads if there are several
+    void readAll(std::string const & driver);
+    static void compile(Stage & stage);
+    // GL thread: wait for link, report errors, store binary, assign shader; false if link failed
+    bool finish(Program & program) const;
+
+    std::vector<Program> programs;
+    bool reload{false};
+};
@@ -0,0 +1,89 @@
+#include "shader_variants.hpp"
+
+#include <iostream>
+
+void ShaderVariants::create(std::string vertex, std::string fragment, Defines variantDefines)
+{
+    vertexPath = std::move(vertex);
+    fragmentPath = std::move(fragment);
+    defines = std::move(variantDefines);
+}
+
+ShaderVariants::Variant * ShaderVariants::find(Key key)
+{
+    for (auto & variant : variants)
+    {
+        if (variant->key == key)
+            return variant.get();
+    }
+    return nullptr;
+}
+
+ShaderVariants::Variant & ShaderVariants::insert(Key key)
+{
+    variants.push_back(std::make_unique<Variant>());
+    variants.back()->key = key;
+    return *variants.back();
+}
+
+void ShaderVariants::add(ShaderLibrary & library, Key key)
+{
+    if (find(key))
+        return;
+    Variant & variant = insert(key);
+    library.add(variant.shader, vertexPath, fragmentPath, defines(key));
+}
+
+void ShaderVariants::bindUniformBlock(std::string const & blockName, GLuint bindingPoint)
+{
+    blockBindings.emplace_back(blockName, bindingPoint);
+    for (auto & variant : variants)
+    {
+        if (variant->shader.getID() != 0)
+            variant->shader.bindUniformBlock(blockName, bindingPoint);
+    }
+}
+
+Shader const & ShaderVariants::select(Key key, Key fallback)
+{
+    Variant * variant = find(key);
+    if (!variant)
+    {
+        // first use: submit and keep drawing with the fallback
+        variant = &insert(key);
+        variant->build = std::make_unique<ShaderLibrary>();
+        variant->build->add(variant->shader, vertexPath, fragmentPath, defines(key));
+        variant->build->submit();
+    }
+    if (variant->build && variant->build->isReady())
+        finish(*variant);
+
+    bool linked = !variant->build && !variant->failed;
+    if (linked || key == fallback)
+        return variant->shader;
+    return select(fallback, fallback);
+}
+
+void ShaderVariants::finish(Variant & variant)
+{
+    variant.failed = !variant.build->finish();
+    variant.build.reset();
+    if (variant.failed)
+    {
+        std::cerr << "ERROR::SHADER_VARIANTS::VARIANT_FAILED " << fragmentPath << "\n" << defines(variant.key) << std::endl;
+        return;
+    }
+    for (auto const & binding : blockBindings)
+        variant.shader.bindUniformBlock(binding.first, binding.second);
+}
+
+void ShaderVariants::destroy()
+{
+    for (auto & variant : variants)
+    {
+        if (variant->build)
+            variant->build->finish();
+        variant->shader.destroy();
+    }
+    variants.clear();
+}
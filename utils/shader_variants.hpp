@@ -0,0 +1,66 @@
+#pragma once
+
+#include "shader.hpp"
+#include "shader_library.hpp"
+
+#include <glad/glad.h>
+
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+//! @brief Compile-time permutations of one program: every variant is the same files with its own "#define" lines
+//! (after "#version"), e.g. light counts and features that are switched off, so a variant has no code for them.
+//! Variants are built on first use without waiting: select() returns the fallback variant until the requested one
+//! is linked (the fallback must render the same image, e.g. all features on with zero inputs).
+//! Programs are cached like any other (ProgramCache), so variants of earlier runs link at once.
+class ShaderVariants
+{
+public:
+    //! @brief Scene specific bit set of the defines of a variant
+    using Key = uint32_t;
+    using Defines = std::function<std::string(Key)>;
+
+    ShaderVariants() = default;
+    ShaderVariants(ShaderVariants const &) = delete;
+    ShaderVariants & operator=(ShaderVariants const &) = delete;
+
+    // files of all variants, defines(key) gives "#define" lines of a variant
+    void create(std::string vertexPath, std::string fragmentPath, Defines defines);
+    // queue variant in library of the scene (startup: built together with the other programs)
+    void add(ShaderLibrary & library, Key key);
+    // attach uniform block of every variant, existing and future ones
+    void bindUniformBlock(std::string const & blockName, GLuint bindingPoint);
+
+    // GL thread: variant of key if it is linked; otherwise its build is submitted (once) and fallback is returned
+    Shader const & select(Key key, Key fallback);
+    // variants created so far (linked or not)
+    size_t size() const { return variants.size(); }
+    // GL thread: wait for variants in flight and delete all programs
+    void destroy();
+
+private:
+    struct Variant
+    {
+        Key key;
+        Shader shader;
+        //! @brief Build in flight (lazy variant)
+        std::unique_ptr<ShaderLibrary> build;
+        bool failed{false};
+    };
+
+    Variant * find(Key key);
+    Variant & insert(Key key);
+    // GL thread: lazy build is linked: take it and attach uniform blocks
+    void finish(Variant & variant);
+
+    std::string vertexPath;
+    std::string fragmentPath;
+    Defines defines;
+    std::vector<std::pair<std::string, GLuint>> blockBindings;
+    //! @brief Shader addresses must not change (ShaderLibrary, ShaderWatcher keep them)
+    std::vector<std::unique_ptr<Variant>> variants;
+};
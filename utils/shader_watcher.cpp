@@ -0,0 +1,167 @@
+#include "shader_watcher.hpp"
+
+#include <filesystem>
+#include <iostream>
+
+#ifdef __linux__
+#include <sys/inotify.h>
+#include <unistd.h>
+#endif
+
+namespace fs = std::filesystem;
+
+namespace
+{
+    std::string normalPath(std::string const & path)
+    {
+        return fs::path(path).lexically_normal().string();
+    }
+}
+
+ShaderWatcher::~ShaderWatcher()
+{
+#ifdef __linux__
+    if (inotify >= 0)
+        ::close(inotify);
+#endif
+}
+
+ShaderWatcher & ShaderWatcher::active()
+{
+    static ShaderWatcher watcher;
+    return watcher;
+}
+
+bool ShaderWatcher::parseArgument(int argc, char ** argv, int & i)
+{
+    if (std::string(argv[i]) != "--watch-shaders")
+        return false;
+    requested = true;
+    return true;
+}
+
+bool ShaderWatcher::start()
+{
+    if (!requested || isRunning())
+        return isRunning();
+#ifdef __linux__
+    inotify = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+    if (inotify < 0)
+    {
+        std::cerr << "ERROR::SHADER_WATCHER::INOTIFY_NOT_AVAILABLE" << std::endl;
+        return false;
+    }
+    std::cout << "Watching shader files: programs are rebuilt when they change" << std::endl;
+    return true;
+#else
+    std::cerr << "ERROR::SHADER_WATCHER::NOT_SUPPORTED (inotify is Linux only)" << std::endl;
+    return false;
+#endif
+}
+
+void ShaderWatcher::stop()
+{
+    // programs in flight are swapped in: their GL objects belong to the shader then
+    for (Program & program : programs)
+    {
+        if (program.rebuild)
+            program.rebuild->finish();
+    }
+    programs.clear();
+    directories.clear();
+#ifdef __linux__
+    if (inotify >= 0)
+        ::close(inotify);
+#endif
+    inotify = -1;
+}
+
+void ShaderWatcher::watch(Shader & shader, std::string const & vertexPath, std::string const & fragmentPath,
+                          std::string const & defines)
+{
+    if (!isRunning())
+        return;
+    addDirectory(vertexPath);
+    addDirectory(fragmentPath);
+    programs.push_back(Program{&shader, normalPath(vertexPath), normalPath(fragmentPath), defines});
+}
+
+void ShaderWatcher::addDirectory(std::string const & path)
+{
+#ifdef __linux__
+    std::string directory = fs::path(normalPath(path)).parent_path().string();
+    if (directory.empty())
+        directory = ".";
+    for (auto const & watched : directories)
+    {
+        if (watched.second == directory)
+            return;
+    }
+    // editors write in place (close after write) or write a temporary file and rename it over the old one
+    int descriptor = inotify_add_watch(inotify, directory.c_str(), IN_CLOSE_WRITE | IN_MOVED_TO);
+    if (descriptor < 0)
+    {
+        std::cerr << "ERROR::SHADER_WATCHER::CANNOT_WATCH " << directory << std::endl;
+        return;
+    }
+    directories.emplace_back(descriptor, directory);
+#endif
+}
+
+void ShaderWatcher::readEvents()
+{
+#ifdef __linux__
+    alignas(inotify_event) char buffer[4096];
+    for (;;)
+    {
+        ssize_t length = ::read(inotify, buffer, sizeof(buffer));
+        if (length <= 0)
+            break;
+        for (char * p = buffer; p < buffer + length; p += sizeof(inotify_event) + reinterpret_cast<inotify_event *>(p)->len)
+        {
+            auto event = reinterpret_cast<inotify_event const *>(p);
+            if (event->len == 0)
+                continue;
+            for (auto const & watched : directories)
+            {
+                if (watched.first != event->wd)
+                    continue;
+                std::string path = normalPath(watched.second + "/" + event->name);
+                for (Program & program : programs)
+                {
+                    if (program.vertexPath == path || program.fragmentPath == path)
+                        program.changed = true;
+                }
+            }
+        }
+    }
+#endif
+}
+
+void ShaderWatcher::update()
+{
+    if (!isRunning())
+        return;
+    readEvents();
+
+    for (Program & program : programs)
+    {
+        // 1. swap in rebuilt program once it is linked (no wait), old one stays if it fails
+        if (program.rebuild && program.rebuild->isReady())
+        {
+            if (program.rebuild->finish())
+                std::cout << "Shader reloaded: " << program.vertexPath << " + " << program.fragmentPath << std::endl;
+            else
+                std::cerr << "Shader reload failed, keeping previous program: " << program.vertexPath << " + " << program.fragmentPath << std::endl;
+            program.rebuild.reset();
+        }
+        // 2. changed files: submit rebuild (next change waits for the one in flight)
+        if (program.changed && !program.rebuild)
+        {
+            program.changed = false;
+            program.rebuild = std::make_unique<ShaderLibrary>(true);
+            program.rebuild->add(*program.shader, program.vertexPath, program.fragmentPath, program.defines);
+            program.rebuild->submit();
+        }
+    }
+}
@@ -0,0 +1,61 @@
+#pragma once
+
+#include "shader.hpp"
+#include "shader_library.hpp"
+
+#include <memory>
+#include <string>
+#include <vector>
+
+//! @brief Shader hot reload ("--watch-shaders"): Linux inotify on the folders of the shader files of every program
+//! built while the watcher runs. A written file rebuilds the programs that use it (ShaderLibrary in reload mode):
+//! compile and link are submitted in one frame and the program is swapped in the frame they are done, so with
+//! KHR_parallel_shader_compile no frame waits for the compiler. Failed rebuild keeps the old program.
+//! Files are taken from the working directory (shaders/<lesson> of the build folder), not from the asset pack.
+class ShaderWatcher
+{
+public:
+    ShaderWatcher() = default;
+    ShaderWatcher(ShaderWatcher const &) = delete;
+    ShaderWatcher & operator=(ShaderWatcher const &) = delete;
+    ~ShaderWatcher();
+
+    // watcher of the running lesson, ShaderLibrary registers programs with it
+    static ShaderWatcher & active();
+
+    // "--watch-shaders" at argv[i], start() then starts watching
+    bool parseArgument(int argc, char ** argv, int & i);
+    // start if requested on command line, false if inotify is not available
+    bool start();
+    // GL thread: finish rebuilds in flight and stop watching
+    void stop();
+    bool isRunning() const { return inotify >= 0; }
+
+    // program of shader is rebuilt (with the same defines) when one of its files changes
+    void watch(Shader & shader, std::string const & vertexPath, std::string const & fragmentPath,
+               std::string const & defines = {});
+    // GL thread, once per frame: read file events, submit rebuilds, swap programs that are linked
+    void update();
+
+private:
+    struct Program
+    {
+        Shader * shader;
+        std::string vertexPath;
+        std::string fragmentPath;
+        std::string defines;
+        //! @brief File changed since the last rebuild was submitted
+        bool changed{false};
+        std::unique_ptr<ShaderLibrary> rebuild;
+    };
+
+    // inotify watch of the folder of path (one per folder)
+    void addDirectory(std::string const & path);
+    void readEvents();
+
+    bool requested{false};
+    int inotify{-1};
+    //! @brief Folder of every inotify watch descriptor
+    std::vector<std::pair<int, std::string>> directories;
+    std::vector<Program> programs;
+};
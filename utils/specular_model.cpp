@@ -0,0 +1,43 @@
+#include "specular_model.hpp"
+
+#include <iostream>
+
+namespace SpecularModel
+{
+    char const * name(Tier tier)
+    {
+        switch (tier)
+        {
+            case BLINN_PHONG: return "blinn";
+            case FAST: return "fast";
+            default: return "phong";
+        }
+    }
+
+    std::string define(Tier tier)
+    {
+        return "#define SPECULAR_MODEL " + std::to_string(unsigned(tier)) + "\n";
+    }
+
+    Tier next(Tier tier)
+    {
+        return Tier((tier + 1) % COUNT);
+    }
+
+    bool parseArgument(int argc, char ** argv, int & i, Tier & tier)
+    {
+        if (std::string(argv[i]) != "--specular" || i + 1 >= argc)
+            return false;
+        std::string value = argv[++i];
+        for (unsigned int t = 0; t < COUNT; ++t)
+        {
+            if (value == name(Tier(t)))
+            {
+                tier = Tier(t);
+                return true;
+            }
+        }
+        std::cerr << "ERROR::SPECULAR_MODEL::UNKNOWN_TIER " << value << " (expected phong, blinn or fast)" << std::endl;
+        return true;
+    }
+}
@@ -0,0 +1,29 @@
+#pragma once
+
+#include <string>
+
+//! @brief Quality tier of specular highlights of the object shaders ("SPECULAR_MODEL" define of object.fs):
+//!   PHONG       - reflected light direction, pow(dot(view, reflect), shininess)
+//!   BLINN_PHONG - half vector between light and view direction, 4x exponent for about the same highlight size
+//!   FAST        - Blinn-Phong with Schlick's approximation of pow (a division instead of exp2/log2)
+//! Scenes build the tier as a variant of the object program; "--specular name" selects it at start, B cycles.
+namespace SpecularModel
+{
+    enum Tier : unsigned int
+    {
+        PHONG = 0,
+        BLINN_PHONG = 1,
+        FAST = 2,
+        COUNT = 3,
+    };
+
+    // "phong", "blinn" or "fast" (option value)
+    char const * name(Tier tier);
+    // "#define SPECULAR_MODEL n" line of the tier
+    std::string define(Tier tier);
+    // tier of the B key: phong -> blinn -> fast -> phong
+    Tier next(Tier tier);
+
+    // "--specular phong|blinn|fast" at argv[i], prints error for unknown value
+    bool parseArgument(int argc, char ** argv, int & i, Tier & tier);
+}
@@ -0,0 +1,3 @@
+// single translation unit with stb_image implementation for lessons and benchmarks
+#define STB_IMAGE_IMPLEMENTATION
+#include "stb/stb_image.h"
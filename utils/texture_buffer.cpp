@@ -0,0 +1,25 @@
+#include "texture_buffer.hpp"
+
+#include <algorithm>
+
+namespace TextureBuffer
+{
+    void create(unsigned int & buffer, unsigned int & texture, GLenum format)
+    {
+        glGenBuffers(1, &buffer);
+        glBindBuffer(GL_TEXTURE_BUFFER, buffer);
+        glBufferData(GL_TEXTURE_BUFFER, 16, nullptr, GL_STREAM_DRAW);
+        glGenTextures(1, &texture);
+        glBindTexture(GL_TEXTURE_BUFFER, texture);
+        glTexBuffer(GL_TEXTURE_BUFFER, format, buffer);
+        glBindTexture(GL_TEXTURE_BUFFER, 0);
+        glBindBuffer(GL_TEXTURE_BUFFER, 0);
+    }
+
+    void upload(GLenum target, unsigned int buffer, size_t size, const void * data)
+    {
+        glBindBuffer(target, buffer);
+        glBufferData(target, GLsizeiptr(std::max<size_t>(size, 16)), size > 0 ? data : nullptr, GL_STREAM_DRAW);
+        glBindBuffer(target, 0);
+    }
+}
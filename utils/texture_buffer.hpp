@@ -0,0 +1,16 @@
+#pragma once
+
+#include <glad/glad.h>
+
+#include <cstddef>
+
+//! @brief Buffers read by shaders through texture views (samplerBuffer), rewritten every frame
+//! (light lists of LightClusters and LightCulling).
+namespace TextureBuffer
+{
+    // GL thread: buffer with texture view of given format (one texel of storage until first upload)
+    void create(unsigned int & buffer, unsigned int & texture, GLenum format);
+    // GL thread: new storage every frame (draws of the previous frame keep the old one); an empty buffer is not a
+    // valid texel source, so it keeps one texel. Also for per-frame vertex buffers (target GL_ARRAY_BUFFER)
+    void upload(GLenum target, unsigned int buffer, size_t size, const void * data);
+}
@@ -0,0 +1,561 @@
+#include "texture_loader.hpp"
+
+#include "asset_pack.hpp"
+#include "image_ops.hpp"
+#include "stb/stb_image.h"
+
+#include <algorithm>
+#include <cstring>
+#include <iostream>
+
+std::string TextureHandle::Info::describe() const
+{
+    std::string size = std::to_string(width) + "x" + std::to_string(height);
+    if (layers > 1)
+        size += "x" + std::to_string(layers);
+    return path + " (" + BakedTexture::formatName(internalFormat) + " " + size + ", " + std::to_string(levels)
+         + (levels == 1 ? " level" : " levels") + (immutable ? ", immutable)" : ")");
+}
+
+void TextureHandle::destroy()
+{
+    if (!state)
+        return;
+    glDeleteTextures(1, &state->ID);
+    state->ID = 0;
+    state->ready = false;
+    state.reset();
+}
+
+void TextureLoader::create(unsigned int threads)
+{
+    if (!workers.empty())
+        return;
+    if (threads == 0)
+        threads = std::max(std::thread::hardware_concurrency(), 2u) - 1;
+
+    textureStorage = GLAD_GL_ARB_texture_storage != 0;
+    GLint count = 0;
+    glGetIntegerv(GL_NUM_COMPRESSED_TEXTURE_FORMATS, &count);
+    compressedFormats.resize(size_t(count));
+    if (count > 0)
+        glGetIntegerv(GL_COMPRESSED_TEXTURE_FORMATS, compressedFormats.data());
+
+    stopping = false;
+    for (unsigned int i = 0; i < threads; ++i)
+        workers.emplace_back(&TextureLoader::workerLoop, this);
+}
+
+TextureHandle TextureLoader::load(std::string const & path, bool flipVertically, glm::vec4 const & placeholder,
+                                  bool srgb)
+{
+    TextureHandle handle = createPlaceholder(GL_TEXTURE_2D, path, placeholder);
+    queue(Job{handle.state, {path}, flipVertically, srgb});
+    return handle;
+}
+
+TextureHandle TextureLoader::loadArray(std::vector<std::string> const & paths, bool flipVertically,
+                                       glm::vec4 const & placeholder, bool srgb)
+{
+    std::string path = paths.empty() ? std::string() : paths.front();
+    if (paths.size() > 1)
+        path += " +" + std::to_string(paths.size() - 1);
+    TextureHandle handle = createPlaceholder(GL_TEXTURE_2D_ARRAY, path, placeholder);
+    if (!paths.empty())
+        queue(Job{handle.state, paths, flipVertically, srgb});
+    return handle;
+}
+
+TextureHandle TextureLoader::createPlaceholder(GLenum target, std::string const & path, glm::vec4 const & placeholder)
+{
+    if (workers.empty())
+        create();
+
+    TextureHandle handle;
+    handle.state = std::make_shared<TextureHandle::State>();
+    handle.state->target = target;
+
+    // 1x1 placeholder: complete texture (single mip level) until the image arrives
+    unsigned char color[4];
+    for (int i = 0; i < 4; ++i)
+        color[i] = static_cast<unsigned char>(glm::clamp(placeholder[i], 0.0f, 1.0f) * 255.0f + 0.5f);
+
+    // mutable: storage of the image replaces it later under the same name
+    glGenTextures(1, &handle.state->ID);
+    glBindTexture(target, handle.state->ID);
+    if (target == GL_TEXTURE_2D_ARRAY)
+        glTexImage3D(target, 0, GL_RGBA8, 1, 1, 1, 0, GL_RGBA, GL_UNSIGNED_BYTE, color);
+    else
+        glTexImage2D(target, 0, GL_RGBA8, 1, 1, 0, GL_RGBA, GL_UNSIGNED_BYTE, color);
+    handle.state->info.path = path;
+
+    glTexParameteri(target, GL_TEXTURE_WRAP_S, GL_REPEAT);
+    glTexParameteri(target, GL_TEXTURE_WRAP_T, GL_REPEAT);
+    glTexParameteri(target, GL_TEXTURE_MIN_FILTER, GL_LINEAR_MIPMAP_LINEAR);
+    glTexParameteri(target, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+    return handle;
+}
+
+void TextureLoader::queue(Job job)
+{
+    std::shared_ptr<TextureHandle::State> texture = job.texture;
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (jobs.empty() && decoding == 0 && images.empty())
+        {
+            batchStart = clock::now();
+            batchCount = 0;
+            batchBaked = 0;
+            batchCached = 0;
+        }
+        ++batchCount;
+        jobs.push_back(std::move(job));
+    }
+    // forget destroyed textures
+    textures.erase(std::remove_if(textures.begin(), textures.end(),
+                                  [](std::shared_ptr<TextureHandle::State> const & t) { return t->ID == 0; }),
+                   textures.end());
+    textures.push_back(std::move(texture));
+    jobAdded.notify_one();
+}
+
+void TextureLoader::workerLoop()
+{
+    std::unique_lock<std::mutex> lock(mutex);
+    while (true)
+    {
+        jobAdded.wait(lock, [this] { return stopping || !jobs.empty(); });
+        if (stopping)
+            return;
+        Job job = std::move(jobs.front());
+        jobs.pop_front();
+        ++decoding;
+        lock.unlock();
+
+        Image image;
+        read(job, image);
+        image.texture = std::move(job.texture);
+        image.srgb = job.srgb;
+
+        lock.lock();
+        --decoding;
+        images.push_back(std::move(image));
+        imageDecoded.notify_all();
+    }
+}
+
+void TextureLoader::update(float budgetMs)
+{
+    auto start = clock::now();
+    bool first = true;
+    while (first || std::chrono::duration<float, std::milli>(clock::now() - start).count() < budgetMs)
+    {
+        Image image;
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            if (images.empty())
+                return;
+            image = std::move(images.front());
+            images.pop_front();
+        }
+        upload(image);
+        first = false;
+
+        if (pending() == 0)
+        {
+            float ms = std::chrono::duration<float, std::milli>(clock::now() - batchStart).count();
+            std::cout << "Textures: " << batchCount << " loaded (" << batchBaked << " baked, " << batchCached
+                      << " from cache) in " << ms << " ms ("
+                      << workers.size() << " decode threads)" << std::endl;
+        }
+    }
+}
+
+void TextureLoader::finish()
+{
+    while (pending() > 0)
+    {
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            imageDecoded.wait(lock, [this] { return !images.empty() || (jobs.empty() && decoding == 0); });
+        }
+        update(0.0f);
+    }
+}
+
+size_t TextureLoader::pending() const
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    return jobs.size() + decoding + images.size();
+}
+
+std::vector<TextureHandle::Info> TextureLoader::memory() const
+{
+    std::vector<TextureHandle::Info> result;
+    for (std::shared_ptr<TextureHandle::State> const & texture : textures)
+    {
+        if (texture->ID != 0)
+            result.push_back(texture->info);
+    }
+    return result;
+}
+
+void TextureLoader::read(Job & job, Image & image) const
+{
+    image.layers.resize(job.paths.size());
+    for (size_t i = 0; i < job.paths.size(); ++i)
+        image.layers[i].path = std::move(job.paths[i]);
+
+    // baked layers only if every one of them fits the storage of the first
+    image.baked = true;
+    for (Layer & layer : image.layers)
+    {
+        // further layers are decoded to the channel count of the first one
+        Layer const & front = image.layers.front();
+        int channels = &layer == &front || !image.baked ? 0 : BakedTexture::channelCount(front.bakedView.header->glFormat);
+        image.baked = image.baked
+                   && (mapBaked(job, layer, BakedTexture::pathFor(layer.path)) || mapCached(job, layer, channels));
+        BakedTexture::Header const * first = front.bakedView.header;
+        BakedTexture::Header const * header = layer.bakedView.header;
+        if (image.baked && (header->glInternalFormat != first->glInternalFormat || header->width != first->width
+                            || header->height != first->height || header->levelCount != first->levelCount))
+        {
+            // decoded images from the cache do not match baked ones, otherwise baked files are inconsistent
+            if (!layer.cached && !front.cached)
+                std::cout << "ERROR: Baked texture layer does not match the first one: " << layer.path << std::endl;
+            image.baked = false;
+        }
+    }
+    if (image.baked)
+        return;
+
+    // flip flag of stb_image is global unless it is set per thread
+    stbi_set_flip_vertically_on_load_thread(job.flipVertically);
+    Layer const & first = image.layers.front();
+    for (Layer & layer : image.layers)
+    {
+        layer.baked.close();
+        // further layers get the channel count of the first one
+        int components = &layer == &first ? 0 : first.components;
+        std::string_view packed = AssetPack::mounted().find(layer.path);
+        if (packed.empty())
+            layer.pixels = stbi_load(layer.path.c_str(), &layer.width, &layer.height, &layer.components, components);
+        else
+            layer.pixels = stbi_load_from_memory(reinterpret_cast<const stbi_uc *>(packed.data()), int(packed.size()),
+                                                 &layer.width, &layer.height, &layer.components, components);
+        if (!layer.pixels || !first.pixels)
+            continue;
+        storeCached(job, layer, components);
+        if (components != 0)
+            layer.components = components;
+        if (layer.width != first.width || layer.height != first.height)
+        {
+            layer.resized = ImageOps::resize(layer.pixels, layer.width, layer.height, layer.components, first.width,
+                                             first.height);
+            stbi_image_free(layer.pixels);
+            layer.pixels = nullptr;
+            layer.width = first.width;
+            layer.height = first.height;
+        }
+    }
+}
+
+bool TextureLoader::isSupported(BakedTexture::Header const & header) const
+{
+    // RGTC is core, other compressed formats depend on extensions
+    if (!(header.flags & BakedTexture::COMPRESSED) || header.glInternalFormat == GL_COMPRESSED_RED_RGTC1
+        || header.glInternalFormat == GL_COMPRESSED_RG_RGTC2)
+    {
+        return true;
+    }
+    return std::find(compressedFormats.begin(), compressedFormats.end(), GLint(header.glInternalFormat))
+        != compressedFormats.end();
+}
+
+bool TextureLoader::mapBaked(Job const & job, Layer & layer, std::string const & path) const
+{
+    // baked file in asset pack is used in place (pack is mapped and read ahead as a whole)
+    std::string_view packed = AssetPack::mounted().find(path);
+    auto data = reinterpret_cast<const unsigned char *>(packed.data());
+    size_t size = packed.size();
+    if (packed.empty())
+    {
+        if (!layer.baked.open(path))
+            return false;
+        data = layer.baked.getData();
+        size = layer.baked.getSize();
+    }
+    if (!BakedTexture::parse(data, size, layer.bakedView))
+    {
+        std::cout << "ERROR: Broken baked texture: " << path << std::endl;
+        layer.baked.close();
+        return false;
+    }
+    uint32_t flags = layer.bakedView.header->flags;
+    bool flipped = (flags & BakedTexture::FLIPPED_VERTICALLY) != 0;
+    bool srgb = (flags & BakedTexture::SRGB) != 0;
+    if (flipped != job.flipVertically || srgb != job.srgb || !isSupported(*layer.bakedView.header))
+    {
+        layer.baked.close();
+        return false;
+    }
+    // pages are read ahead while the image waits for upload
+    layer.baked.prefetch();
+    layer.width = int(layer.bakedView.header->width);
+    layer.height = int(layer.bakedView.header->height);
+    return true;
+}
+
+std::string TextureLoader::cacheEntry(Job const & job, std::string const & path, int channels) const
+{
+    if (cacheDirectory.empty())
+        return std::string();
+    // decoded levels of this loader (uncompressed, box filtered mips)
+    std::string parameters = "decoded v" + std::to_string(BakedTexture::VERSION) + " channels "
+                           + std::to_string(channels) + (job.flipVertically ? " flip" : "") + (job.srgb ? " srgb" : "");
+    std::string key = AssetCache::keyFor(path, parameters);
+    return key.empty() ? key : AssetCache::pathFor(cacheDirectory, key, BakedTexture::EXTENSION);
+}
+
+bool TextureLoader::mapCached(Job const & job, Layer & layer, int channels) const
+{
+    std::string entry = cacheEntry(job, layer.path, channels);
+    layer.cached = !entry.empty() && mapBaked(job, layer, entry);
+    return layer.cached;
+}
+
+void TextureLoader::storeCached(Job const & job, Layer const & layer, int channels) const
+{
+    // components of the layer are the ones of the file even if stb_image converted it to channels
+    int components = channels != 0 ? channels : layer.components;
+    std::string entry = cacheEntry(job, layer.path, channels);
+    BakedTexture::Format format;
+    if (entry.empty() || !BakedTexture::formatFor(components, job.srgb, format))
+        return;
+
+    std::vector<std::vector<unsigned char>> levels;
+    levels.emplace_back(layer.pixels, layer.pixels + size_t(layer.width) * size_t(layer.height) * size_t(components));
+    uint32_t levelCount = BakedTexture::levelCount(uint32_t(layer.width), uint32_t(layer.height));
+    for (uint32_t level = 1; level < levelCount; ++level)
+    {
+        int w = std::max(layer.width >> (level - 1), 1);
+        int h = std::max(layer.height >> (level - 1), 1);
+        levels.push_back(ImageOps::downsample(levels.back(), w, h, components));
+    }
+    uint32_t flags = (job.flipVertically ? BakedTexture::FLIPPED_VERTICALLY : 0u) | (job.srgb ? BakedTexture::SRGB : 0u);
+    AssetCache::store(entry, [&](std::string const & path) {
+        return BakedTexture::write(path, uint32_t(layer.width), uint32_t(layer.height), format, flags, levels);
+    });
+}
+
+const void * TextureLoader::stage(const void * data, size_t size)
+{
+    // copy into orphaned pixel buffer: glTexImage2D reads from it without waiting for earlier uploads
+    if (pixelBuffer == 0)
+        glGenBuffers(1, &pixelBuffer);
+    glBindBuffer(GL_PIXEL_UNPACK_BUFFER, pixelBuffer);
+    glBufferData(GL_PIXEL_UNPACK_BUFFER, GLsizeiptr(size), nullptr, GL_STREAM_DRAW);
+    void * staging = glMapBufferRange(GL_PIXEL_UNPACK_BUFFER, 0, GLsizeiptr(size),
+                                      GL_MAP_WRITE_BIT | GL_MAP_INVALIDATE_BUFFER_BIT);
+    if (staging)
+    {
+        std::memcpy(staging, data, size);
+        glUnmapBuffer(GL_PIXEL_UNPACK_BUFFER);
+        return nullptr; // offset in pixel buffer
+    }
+    glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+    return data;
+}
+
+void TextureLoader::upload(Image & image)
+{
+    // texture was deleted while its file was loading
+    if (image.texture->ID == 0)
+    {
+        freeLayers(image);
+        return;
+    }
+    if (image.baked)
+    {
+        uploadBaked(image);
+        return;
+    }
+    for (Layer const & layer : image.layers)
+    {
+        if (!layer.data())
+        {
+            std::cout << "ERROR: Failed to load texture: " << layer.path << std::endl;
+            freeLayers(image);
+            return;
+        }
+    }
+
+    Layer const & first = image.layers.front();
+    BakedTexture::Format format;
+    if (!BakedTexture::formatFor(first.components, image.srgb, format))
+    {
+        std::cout << "ERROR: Failed to load texture: " << first.path
+                  << ". Unhandled number of components: " << first.components << std::endl;
+        freeLayers(image);
+        return;
+    }
+
+    // rows of 1 and 3 channel images are not 4 byte aligned
+    glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+    GLenum target = image.texture->target;
+    int layers = int(image.layers.size());
+    int levels = int(BakedTexture::levelCount(uint32_t(first.width), uint32_t(first.height)));
+    allocate(*image.texture, image.texture->info.path, format, first.width, first.height, layers, levels, {});
+    size_t size = size_t(first.width) * size_t(first.height) * size_t(first.components);
+    for (int i = 0; i < layers; ++i)
+        subImage(target, 0, i, first.width, first.height, format, false, size, stage(image.layers[i].data(), size));
+    glGenerateMipmap(target);
+    glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
+    glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+
+    // texel size of sized format is the number of channels (8 bits each)
+    size_t bytes = 0;
+    for (int level = 0; level < levels; ++level)
+        bytes += size_t(std::max(first.width >> level, 1)) * size_t(std::max(first.height >> level, 1));
+    image.texture->info.bytes = bytes * size_t(first.components) * size_t(layers);
+
+    freeLayers(image);
+    image.texture->ready = true;
+}
+
+void TextureLoader::uploadBaked(Image & image)
+{
+    // all layers have the same format and level sizes
+    BakedTexture::Header const & header = *image.layers.front().bakedView.header;
+    BakedTexture::Level const * firstLevels = image.layers.front().bakedView.levels;
+    BakedTexture::Format format{header.glInternalFormat, header.glFormat, header.glType};
+    bool compressed = (header.flags & BakedTexture::COMPRESSED) != 0;
+    std::vector<size_t> levelSizes;
+    for (uint32_t i = 0; i < header.levelCount; ++i)
+        levelSizes.push_back(size_t(firstLevels[i].size));
+
+    glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+    GLenum target = image.texture->target;
+    int layers = int(image.layers.size());
+    allocate(*image.texture, image.texture->info.path, format, int(header.width), int(header.height), layers,
+             int(header.levelCount), compressed ? levelSizes : std::vector<size_t>());
+    size_t bytes = 0;
+    for (int layer = 0; layer < layers; ++layer)
+    {
+        BakedTexture::View const & view = image.layers[size_t(layer)].bakedView;
+        BakedTexture::Level const * levels = view.levels;
+
+        // levels are stored one after another: single copy of all of them
+        uint64_t begin = levels[0].offset;
+        uint64_t end = levels[header.levelCount - 1].offset + levels[header.levelCount - 1].size;
+        const unsigned char * data = view.file + begin;
+        bool staged = stage(data, size_t(end - begin)) == nullptr;
+        for (uint32_t i = 0; i < header.levelCount; ++i)
+        {
+            size_t offset = size_t(levels[i].offset - begin);
+            const void * source = staged ? reinterpret_cast<const void *>(offset) : data + offset;
+            subImage(target, int(i), layer, int(levels[i].width), int(levels[i].height), format, compressed,
+                     size_t(levels[i].size), source);
+            bytes += size_t(levels[i].size);
+        }
+    }
+    glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
+    glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+    image.texture->info.bytes = bytes;
+
+    if (std::any_of(image.layers.begin(), image.layers.end(), [](Layer const & layer) { return layer.cached; }))
+        ++batchCached;
+    else
+        ++batchBaked;
+    freeLayers(image);
+    image.texture->ready = true;
+}
+
+void TextureLoader::allocate(TextureHandle::State & texture, std::string const & path,
+                             BakedTexture::Format const & format, int width, int height, int layers, int levels,
+                             std::vector<size_t> const & levelSizes)
+{
+    GLenum target = texture.target;
+    glBindTexture(target, texture.ID);
+    if (textureStorage)
+    {
+        // all levels at once, size and format are fixed: no completeness checks and reallocation later
+        if (target == GL_TEXTURE_2D_ARRAY)
+            glTexStorage3D(target, levels, format.glInternalFormat, width, height, layers);
+        else
+            glTexStorage2D(target, levels, format.glInternalFormat, width, height);
+    }
+    else
+    {
+        // every level without data, layers are filled one by one
+        for (int level = 0; level < levels; ++level)
+        {
+            int w = std::max(width >> level, 1);
+            int h = std::max(height >> level, 1);
+            if (!levelSizes.empty() && target == GL_TEXTURE_2D_ARRAY)
+                glCompressedTexImage3D(target, level, format.glInternalFormat, w, h, layers, 0,
+                                       GLsizei(levelSizes[size_t(level)] * size_t(layers)), nullptr);
+            else if (!levelSizes.empty())
+                glCompressedTexImage2D(target, level, format.glInternalFormat, w, h, 0,
+                                       GLsizei(levelSizes[size_t(level)]), nullptr);
+            else if (target == GL_TEXTURE_2D_ARRAY)
+                glTexImage3D(target, level, GLint(format.glInternalFormat), w, h, layers, 0, format.glFormat,
+                             format.glType, nullptr);
+            else
+                glTexImage2D(target, level, GLint(format.glInternalFormat), w, h, 0, format.glFormat, format.glType,
+                             nullptr);
+        }
+        glTexParameteri(target, GL_TEXTURE_MAX_LEVEL, levels - 1);
+    }
+    texture.info = TextureHandle::Info{path, format.glInternalFormat, width, height, layers, levels, 0, textureStorage};
+}
+
+void TextureLoader::subImage(GLenum target, int level, int layer, int width, int height,
+                             BakedTexture::Format const & format, bool compressed, size_t size, const void * source)
+{
+    if (compressed && target == GL_TEXTURE_2D_ARRAY)
+        glCompressedTexSubImage3D(target, level, 0, 0, layer, width, height, 1, format.glInternalFormat,
+                                  GLsizei(size), source);
+    else if (compressed)
+        glCompressedTexSubImage2D(target, level, 0, 0, width, height, format.glInternalFormat, GLsizei(size), source);
+    else if (target == GL_TEXTURE_2D_ARRAY)
+        glTexSubImage3D(target, level, 0, 0, layer, width, height, 1, format.glFormat, format.glType, source);
+    else
+        glTexSubImage2D(target, level, 0, 0, width, height, format.glFormat, format.glType, source);
+}
+
+void TextureLoader::freeLayers(Image & image)
+{
+    for (Layer & layer : image.layers)
+    {
+        stbi_image_free(layer.pixels);
+        layer.pixels = nullptr;
+        layer.resized.clear();
+        layer.baked.close();
+    }
+}
+
+void TextureLoader::stopWorkers()
+{
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stopping = true;
+    }
+    jobAdded.notify_all();
+    for (std::thread & worker : workers)
+        worker.join();
+    workers.clear();
+}
+
+void TextureLoader::destroy()
+{
+    stopWorkers();
+    jobs.clear();
+    for (Image & image : images)
+        freeLayers(image);
+    images.clear();
+    decoding = 0;
+
+    glDeleteBuffers(1, &pixelBuffer);
+    pixelBuffer = 0;
+}
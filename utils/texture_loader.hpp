@@ -0,0 +1,203 @@
+#pragma once
+
+#include "asset_cache.hpp"
+#include "baked_texture.hpp"
+#include "mapped_file.hpp"
+
+#include <glad/glad.h>
+#include <glm/glm.hpp>
+
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+//! @brief Texture loaded in background. GL name is valid at once and never changes:
+//! it holds 1x1 placeholder until TextureLoader::update() uploads the decoded image.
+class TextureHandle
+{
+public:
+    //! @brief Storage of the texture (placeholder until image is uploaded)
+    struct Info
+    {
+        std::string path;
+        GLenum internalFormat{GL_RGBA8};
+        int width{1};
+        int height{1};
+        //! @brief Layers of texture array (1 for 2D texture)
+        int layers{1};
+        int levels{1};
+        //! @brief Texel data of all levels as uploaded (drivers may pad, e.g. RGB8 to 4 bytes per texel)
+        size_t bytes{4};
+        //! @brief Allocated with glTexStorage2D/3D
+        bool immutable{false};
+
+        // "path (BC1 500x500, 9 levels, immutable)", arrays "path +2 (BC1 500x500x3, ...)"
+        std::string describe() const;
+    };
+
+    unsigned int id() const { return state ? state->ID : 0; }
+    // GL_TEXTURE_2D or GL_TEXTURE_2D_ARRAY
+    GLenum target() const { return state ? state->target : GL_TEXTURE_2D; }
+    // image is uploaded (false while loading and if file cannot be loaded)
+    bool isReady() const { return state && state->ready; }
+    Info const & info() const { return state->info; }
+    // delete GL texture (for all copies of the handle)
+    void destroy();
+
+private:
+    friend class TextureLoader;
+
+    struct State
+    {
+        unsigned int ID{0};
+        GLenum target{GL_TEXTURE_2D};
+        bool ready{false};
+        Info info;
+    };
+    std::shared_ptr<State> state;
+};
+
+//! @brief Image files are decoded with stb_image on worker threads, GL thread uploads
+//! them through pixel buffer object within per-frame time budget and generates mipmaps.
+//! Storage has sized internal format and exact mip count, immutable (glTexStorage2D) if the context
+//! has ARB_texture_storage.
+//! Baked file next to the image (texbake, "name.btex") is mapped instead: no decoding, mip levels are uploaded as they are
+//! (block compressed ones with glCompressedTexImage2D if the format is supported).
+//! Images without baked file are looked up in AssetCache by content hash; decoded ones are stored there with
+//! their mip levels, so the next run (any lesson with the same file) maps them instead of decoding.
+//! Texture arrays (loadArray) take one file per layer, all layers are uploaded at once.
+//! Startup does not wait for any image file.
+class TextureLoader
+{
+public:
+    static constexpr float UPLOAD_BUDGET_MS_DEFAULT = 2.0f;
+
+    TextureLoader() = default;
+    TextureLoader(TextureLoader const &) = delete;
+    TextureLoader & operator=(TextureLoader const &) = delete;
+    ~TextureLoader() { stopWorkers(); }
+
+    // GL thread: start decode threads (0 - one less than hardware threads, at least one)
+    void create(unsigned int threads = 0);
+    // folder of decoded images (AssetCache entries), empty disables the cache; call before load()
+    void setCacheDirectory(std::string const & directory) { cacheDirectory = directory; }
+    // GL thread: create texture with placeholder color and queue file (1-4 channels) for decoding.
+    // sRGB images get sRGB internal format (3 and 4 channels)
+    TextureHandle load(std::string const & path, bool flipVertically = true,
+                       glm::vec4 const & placeholder = glm::vec4(0.5f, 0.5f, 0.5f, 1.0f), bool srgb = false);
+    // GL thread: 2D array texture, one file per layer (placeholder is a single layer).
+    // Baked files are used if all layers have them with the same size and format; otherwise images are decoded
+    // and resized to the size of the first one
+    TextureHandle loadArray(std::vector<std::string> const & paths, bool flipVertically = true,
+                            glm::vec4 const & placeholder = glm::vec4(0.5f, 0.5f, 0.5f, 1.0f), bool srgb = false);
+
+    // GL thread, once per frame: upload decoded images until budget is spent (at least one image)
+    void update(float budgetMs = UPLOAD_BUDGET_MS_DEFAULT);
+    // GL thread: wait for all queued files and upload them
+    void finish();
+    // files queued, decoding or waiting for upload
+    size_t pending() const;
+    // storage of all live textures of this loader (destroyed ones are skipped)
+    std::vector<TextureHandle::Info> memory() const;
+
+    // stop threads, drop pending images and free pixel buffer; textures belong to the caller
+    void destroy();
+
+private:
+    using clock = std::chrono::steady_clock;
+
+    struct Job
+    {
+        std::shared_ptr<TextureHandle::State> texture;
+        //! @brief Single file, or one per layer of array texture
+        std::vector<std::string> paths;
+        bool flipVertically{true};
+        bool srgb{false};
+    };
+
+    //! @brief Image file of a texture (layer of array)
+    struct Layer
+    {
+        std::string path;
+        int width{0};
+        int height{0};
+        int components{0};
+        //! @brief stb_image allocation, nullptr if decoding failed
+        unsigned char * pixels{nullptr};
+        //! @brief Decoded image scaled to the size of the first layer (pixels are freed then)
+        std::vector<unsigned char> resized;
+        //! @brief Baked file with all mip levels (pixels are not used then)
+        MappedFile baked;
+        BakedTexture::View bakedView;
+        //! @brief Baked file is AssetCache entry of the image
+        bool cached{false};
+
+        const unsigned char * data() const { return resized.empty() ? pixels : resized.data(); }
+    };
+
+    struct Image
+    {
+        std::shared_ptr<TextureHandle::State> texture;
+        bool srgb{false};
+        //! @brief All layers baked (mapped files) or all decoded
+        bool baked{false};
+        std::vector<Layer> layers;
+    };
+
+    TextureHandle createPlaceholder(GLenum target, std::string const & path, glm::vec4 const & placeholder);
+    void queue(Job job);
+    void workerLoop();
+    void stopWorkers();
+    // worker: map baked files or decode all layers of the job
+    void read(Job & job, Image & image) const;
+    // worker: map baked file of the layer if it exists, matches flip flag and its format is supported
+    bool mapBaked(Job const & job, Layer & layer, std::string const & path) const;
+    // worker: map cache entry of the layer decoded to given channel count (0 - as in the file);
+    // storeCached() writes decoded layer with all mip levels
+    bool mapCached(Job const & job, Layer & layer, int channels) const;
+    void storeCached(Job const & job, Layer const & layer, int channels) const;
+    std::string cacheEntry(Job const & job, std::string const & path, int channels) const;
+    bool isSupported(BakedTexture::Header const & header) const;
+    void upload(Image & image);
+    void uploadBaked(Image & image);
+    // bind texture, set its info and allocate immutable storage if supported; mutable levels are allocated here
+    // too (levelSizes: compressed size of each level of one layer)
+    void allocate(TextureHandle::State & texture, std::string const & path, BakedTexture::Format const & format,
+                  int width, int height, int layers, int levels, std::vector<size_t> const & levelSizes);
+    // fill level of allocated storage (layer of array texture)
+    void subImage(GLenum target, int level, int layer, int width, int height, BakedTexture::Format const & format,
+                  bool compressed, size_t size, const void * source);
+    // copy data into orphaned pixel buffer, returns pointer argument for glTexImage2D (offset or data itself)
+    const void * stage(const void * data, size_t size);
+    static void freeLayers(Image & image);
+
+    std::vector<std::thread> workers;
+    //! @brief ARB_texture_storage: levels are allocated once with glTexStorage2D/3D and filled with glTex*SubImage
+    bool textureStorage{false};
+    //! @brief GL_COMPRESSED_TEXTURE_FORMATS of the context, read by workers
+    std::vector<GLint> compressedFormats;
+    std::string cacheDirectory{AssetCache::DIRECTORY_DEFAULT};
+    //! @brief Every loaded texture, for memory()
+    std::vector<std::shared_ptr<TextureHandle::State>> textures;
+    mutable std::mutex mutex;
+    std::condition_variable jobAdded;
+    std::condition_variable imageDecoded;
+    std::deque<Job> jobs;
+    std::deque<Image> images;
+    //! @brief Jobs taken by workers and not decoded yet
+    size_t decoding{0};
+    bool stopping{false};
+
+    //! @brief Staging buffer for glTexImage2D, orphaned on every upload
+    unsigned int pixelBuffer{0};
+    //! @brief Start of first load() since all textures were ready, for startup report
+    clock::time_point batchStart;
+    size_t batchCount{0};
+    size_t batchBaked{0};
+    size_t batchCached{0};
+};
@@ -0,0 +1,121 @@
+#pragma once
+
+#include <glm/glm.hpp>
+
+#include <cstddef>
+
+// C++ mirrors of std140 uniform blocks shared by shaders.
+// Member order follows GLSL declaration, every vec3 is followed by a float filling its 16 byte slot.
+
+namespace UniformBlockBinding
+{
+    const unsigned int PER_FRAME = 0;
+    const unsigned int LIGHTS = 1;
+    const unsigned int MATERIALS = 2;
+}
+
+// layout (std140) uniform PerFrame
+struct PerFrameBlock
+{
+    glm::mat4 projection;
+    glm::mat4 view;
+    glm::vec3 viewPos;
+    float _pad0;
+};
+static_assert(offsetof(PerFrameBlock, projection) == 0, "std140 layout mismatch");
+static_assert(offsetof(PerFrameBlock, view) == 64, "std140 layout mismatch");
+static_assert(offsetof(PerFrameBlock, viewPos) == 128, "std140 layout mismatch");
+static_assert(sizeof(PerFrameBlock) == 144, "std140 layout mismatch");
+
+struct DirLightData
+{
+    glm::vec3 direction;
+    float _pad0;
+    glm::vec3 ambient;
+    float _pad1;
+    glm::vec3 diffuse;
+    float _pad2;
+    glm::vec3 specular;
+    float _pad3;
+};
+static_assert(offsetof(DirLightData, ambient) == 16, "std140 layout mismatch");
+static_assert(offsetof(DirLightData, diffuse) == 32, "std140 layout mismatch");
+static_assert(offsetof(DirLightData, specular) == 48, "std140 layout mismatch");
+static_assert(sizeof(DirLightData) == 64, "std140 layout mismatch");
+
+struct PointLightData
+{
+    glm::vec3 position;
+    float constant;
+    glm::vec3 ambient;
+    float linear;
+    glm::vec3 diffuse;
+    float quadratic;
+    glm::vec3 specular;
+    float _pad0;
+};
+static_assert(offsetof(PointLightData, constant) == 12, "std140 layout mismatch");
+static_assert(offsetof(PointLightData, ambient) == 16, "std140 layout mismatch");
+static_assert(offsetof(PointLightData, linear) == 28, "std140 layout mismatch");
+static_assert(offsetof(PointLightData, diffuse) == 32, "std140 layout mismatch");
+static_assert(offsetof(PointLightData, quadratic) == 44, "std140 layout mismatch");
+static_assert(offsetof(PointLightData, specular) == 48, "std140 layout mismatch");
+static_assert(sizeof(PointLightData) == 64, "std140 layout mismatch");
+
+struct SpotLightData
+{
+    glm::vec3 position;
+    float cutOff;
+    glm::vec3 direction;
+    float outerCutOff;
+    glm::vec3 ambient;
+    float constant;
+    glm::vec3 diffuse;
+    float linear;
+    glm::vec3 specular;
+    float quadratic;
+};
+static_assert(offsetof(SpotLightData, cutOff) == 12, "std140 layout mismatch");
+static_assert(offsetof(SpotLightData, direction) == 16, "std140 layout mismatch");
+static_assert(offsetof(SpotLightData, outerCutOff) == 28, "std140 layout mismatch");
+static_assert(offsetof(SpotLightData, ambient) == 32, "std140 layout mismatch");
+static_assert(offsetof(SpotLightData, constant) == 44, "std140 layout mismatch");
+static_assert(offsetof(SpotLightData, diffuse) == 48, "std140 layout mismatch");
+static_assert(offsetof(SpotLightData, linear) == 60, "std140 layout mismatch");
+static_assert(offsetof(SpotLightData, specular) == 64, "std140 layout mismatch");
+static_assert(offsetof(SpotLightData, quadratic) == 76, "std140 layout mismatch");
+static_assert(sizeof(SpotLightData) == 80, "std140 layout mismatch");
+
+// layout (std140) uniform Lights, N is NR_POINT_LIGHTS of the shader
+template <size_t N>
+struct LightsBlock
+{
+    DirLightData dirLight;
+    PointLightData pointLights[N];
+    SpotLightData spotLight;
+};
+static_assert(offsetof(LightsBlock<4>, pointLights) == 64, "std140 layout mismatch");
+static_assert(offsetof(LightsBlock<4>, spotLight) == 64 + 4 * 64, "std140 layout mismatch");
+static_assert(sizeof(LightsBlock<4>) == 400, "std140 layout mismatch");
+
+// entry of "layout (std140) uniform Materials": layers of the material maps in texture arrays
+struct MaterialData
+{
+    //! @brief Layer of diffuse and specular map array, specularLayer -1 - no map, constant specular
+    int diffuseLayer;
+    int specularLayer;
+    float specular;
+    float shininess;
+};
+static_assert(offsetof(MaterialData, specularLayer) == 4, "std140 layout mismatch");
+static_assert(offsetof(MaterialData, specular) == 8, "std140 layout mismatch");
+static_assert(offsetof(MaterialData, shininess) == 12, "std140 layout mismatch");
+static_assert(sizeof(MaterialData) == 16, "std140 layout mismatch");
+
+// layout (std140) uniform Materials, N is NR_MATERIALS of the shader; indexed by material ID of the instance
+template <size_t N>
+struct MaterialsBlock
+{
+    MaterialData materials[N];
+};
+static_assert(sizeof(MaterialsBlock<3>) == 3 * 16, "std140 layout mismatch");
@@ -0,0 +1,45 @@
+#pragma once
+
+#include <glad/glad.h>
+
+//! @brief Uniform buffer object holding one std140 block mirrored by Block.
+//! Buffer is bound to its binding point once, shaders attach to the point with Shader::bindUniformBlock.
+template <typename Block>
+class UniformBuffer
+{
+public:
+    // empty buffer, assign a constructed one before use
+    UniformBuffer() = default;
+    explicit UniformBuffer(GLuint bindingPoint)
+        : bindingPoint(bindingPoint)
+    {
+        glGenBuffers(1, &ID);
+        glBindBuffer(GL_UNIFORM_BUFFER, ID);
+        glBufferData(GL_UNIFORM_BUFFER, sizeof(Block), nullptr, GL_DYNAMIC_DRAW);
+        glBindBuffer(GL_UNIFORM_BUFFER, 0);
+        glBindBufferBase(GL_UNIFORM_BUFFER, bindingPoint, ID);
+    }
+
+    // upload whole block, call once per frame
+    void upload(Block const & data) const
+    {
+        glBindBuffer(GL_UNIFORM_BUFFER, ID);
+        glBufferSubData(GL_UNIFORM_BUFFER, 0, sizeof(Block), &data);
+        glBindBuffer(GL_UNIFORM_BUFFER, 0);
+    }
+
+    // free GL buffer, call before context is destroyed
+    void destroy()
+    {
+        glDeleteBuffers(1, &ID);
+        ID = 0;
+    }
+
+    GLuint getBindingPoint() const { return bindingPoint; }
+    unsigned int getID() const { return ID; }
+
+private:
+    //! @brief Buffer id
+    unsigned int ID{0};
+    GLuint bindingPoint{0};
+};
@@ -0,0 +1,66 @@
+#include "uniform_table.hpp"
+
+void UniformTable::clear()
+{
+    slots.clear();
+    names.clear();
+    locations.clear();
+}
+
+int UniformTable::insert(std::string_view name, GLint location)
+{
+    int index = find(name);
+    if (index != npos)
+    {
+        locations[index] = location;
+        return index;
+    }
+    // keep load factor below 1/2, so probe sequences stay short
+    if ((names.size() + 1) * 2 > slots.size())
+        rehash(slots.empty() ? 16 : slots.size() * 2);
+
+    index = int(names.size());
+    names.emplace_back(name);
+    locations.push_back(location);
+
+    uint32_t h = hash(name);
+    size_t mask = slots.size() - 1;
+    for (size_t i = h & mask; ; i = (i + 1) & mask)
+    {
+        if (slots[i].index == npos)
+        {
+            slots[i] = Slot{h, index};
+            break;
+        }
+    }
+    return index;
+}
+
+int UniformTable::find(std::string_view name) const
+{
+    if (slots.empty())
+        return npos;
+
+    uint32_t h = hash(name);
+    size_t mask = slots.size() - 1;
+    for (size_t i = h & mask; slots[i].index != npos; i = (i + 1) & mask)
+    {
+        if (slots[i].hash == h && names[slots[i].index] == name)
+            return slots[i].index;
+    }
+    return npos;
+}
+
+void UniformTable::rehash(size_t capacity)
+{
+    slots.assign(capacity, Slot{});
+    size_t mask = capacity - 1;
+    for (int index = 0; index < int(names.size()); ++index)
+    {
+        uint32_t h = hash(names[index]);
+        size_t i = h & mask;
+        while (slots[i].index != npos)
+            i = (i + 1) & mask;
+        slots[i] = Slot{h, index};
+    }
+}
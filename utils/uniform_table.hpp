@@ -0,0 +1,52 @@
+#pragma once
+
+#include <glad/glad.h>
+
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+//! @brief Flat open-addressing hash table: uniform name -> dense index -> location.
+//! Filled once after program link, so lookups never reach the driver.
+class UniformTable
+{
+public:
+    static constexpr int npos = -1;
+
+    //! @brief FNV-1a hash of the uniform name
+    static constexpr uint32_t hash(std::string_view name)
+    {
+        uint32_t h = 2166136261u;
+        for (char c : name)
+        {
+            h ^= uint8_t(c);
+            h *= 16777619u;
+        }
+        return h;
+    }
+
+    void clear();
+    //! @brief Insert name or update location of existing one. Returns dense index.
+    int insert(std::string_view name, GLint location);
+    //! @brief Returns dense index of the name or npos
+    int find(std::string_view name) const;
+
+    GLint location(int index) const { return locations[index]; }
+    void setLocation(int index, GLint location) { locations[index] = location; }
+    std::string const & name(int index) const { return names[index]; }
+    int size() const { return int(names.size()); }
+
+private:
+    struct Slot
+    {
+        uint32_t hash{0};
+        int index{npos};
+    };
+
+    void rehash(size_t capacity);
+
+    std::vector<Slot> slots;
+    std::vector<std::string> names;
+    std::vector<GLint> locations;
+};